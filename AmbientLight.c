@@ -0,0 +1,63 @@
+/**
+ * \file        AmbientLight.c
+ * \brief       Automatic brightness of the display from an ambient light sensor
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "AmbientLight.h"
+#include "hardware/adc.h"
+
+al_sensor_t alSensor;
+
+const al_step_t alSteps[AL_STEPS] = {
+    {0, 16},            ///< Dark room, the display must not light it
+    {96, 32},
+    {256, 64},
+    {640, 112},
+    {1280, 176},
+    {2304, 256},        ///< Daylight, full brightness
+};
+
+void al_init(al_sensor_t *A){
+    adc_init();
+    adc_gpio_init(AL_GPIO);
+    tb_init(&A->sampleTB, AL_PERIOD_US, true);
+    A->sampleTB.next = tb_now();            ///< First sample at the first pass
+    A->autoDuty = true;
+    A->samples = 0;
+    A->changes = 0;
+    A->step = AL_STEPS - 1;
+}
+
+bool al_update(al_sensor_t *A, uint16_t sample){
+    A->sample = sample;
+    int32_t level = (int32_t)sample << 8;
+    if(!A->samples++)
+        A->filt = level;                    ///< The first sample loads the filter, no fade in at boot
+    else
+        A->filt += (level - (int32_t)A->filt) >> AL_SHIFT;   ///< Arithmetic shift, the level falls too
+    uint32_t adc = A->filt >> 8;
+    uint32_t hyst = A->samples > 1 ? AL_HYST : 0;      ///< No hysteresis for the first step
+    uint8_t step = A->samples > 1 ? A->step : 0;
+    while(step < AL_STEPS - 1 && adc >= alSteps[step + 1].minAdc + hyst)
+        step++;
+    while(step > 0 && adc + hyst < alSteps[step].minAdc)
+        step--;
+    if(step == A->step)
+        return false;
+    A->step = step;
+    A->changes++;
+    return true;
+}
+
+bool al_process(al_sensor_t *A){
+    if(!tb_check(&A->sampleTB))
+        return false;
+    tb_next(&A->sampleTB);
+    adc_select_input(AL_ADC_INPUT);
+    bool changed = al_update(A, adc_read());
+    return changed && A->autoDuty;
+}
@@ -0,0 +1,84 @@
+/**
+ * \file        AmbientLight.h
+ * \brief       Automatic brightness of the display from an ambient light sensor
+ * \details     A light sensor (LDR or phototransistor to 3.3 V, resistor to ground, brighter is a
+ * higher voltage) is read on ADC input 1 (GPIO 27) once per second, the light changes slowly and a
+ * single conversion takes 2 us. The samples go through a first order IIR filter in fixed point,
+ * filt += (sample - filt) / 2^AL_SHIFT with the level in ADC counts Q8, so a lamp switched on
+ * settles in a few seconds and a shadow or a flicker does not move the brightness.
+ *
+ * The filtered level selects a step of alSteps, from dark to daylight, and every step is a duty of
+ * the display multiplexing (ss_set_duty). A step changes only when the level is AL_HYST counts past
+ * the threshold, so a level that sits on a threshold does not toggle the brightness.
+ *
+ * al_update is the filter alone, without the ADC: the LIGHT SIM command feeds it the samples of a
+ * light curve (tools/wuhost.py light) and reports the duty and the current of every sample.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __AMBIENT_LIGHT_H_
+#define __AMBIENT_LIGHT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TimeBase.h"
+
+#define AL_GPIO 27                  ///< Light sensor input
+#define AL_ADC_INPUT 1              ///< ADC input of AL_GPIO
+#define AL_PERIOD_US 1000000        ///< Sampling period
+#define AL_SHIFT 2                  ///< Filter coefficient 1/4, time constant of about 4 samples
+#define AL_HYST 48                  ///< Hysteresis of the steps in ADC counts
+#define AL_STEPS 6                  ///< Brightness steps
+
+typedef struct{
+    uint16_t minAdc;            ///< Lowest filtered level of the step in ADC counts
+    uint16_t duty;              ///< Duty of the display, 1 to SS_DUTY_MAX
+} al_step_t;
+
+typedef struct{
+    time_base_t sampleTB;       ///< Sampling period
+    bool autoDuty;              ///< The duty follows the light, false keeps the duty set by hand
+    uint16_t sample;            ///< Last sample in ADC counts
+    uint32_t filt;              ///< Filtered level in ADC counts Q8
+    uint8_t step;               ///< Step of alSteps
+    uint32_t samples;           ///< Samples since al_init, the first one loads the filter
+    uint32_t changes;           ///< Step changes
+} al_sensor_t;
+
+extern al_sensor_t alSensor;    ///< Filtered ambient light and brightness step
+extern const al_step_t alSteps[AL_STEPS];   ///< Steps from dark to daylight
+
+/**
+ * \fn void al_init(al_sensor_t *A)
+ * \brief Set up the ADC input of the sensor and start the sampling with the duty following the light
+ */
+void al_init(al_sensor_t *A);
+
+/**
+ * \fn bool al_update(al_sensor_t *A, uint16_t sample)
+ * \brief Filter one sample and move to the step due, with the hysteresis
+ * \param A         Pointer to the sensor
+ * \param sample    Light level in ADC counts, 0 to 4095
+ * \returns true if the step changed
+ */
+bool al_update(al_sensor_t *A, uint16_t sample);
+
+/**
+ * \fn bool al_process(al_sensor_t *A)
+ * \brief Call this method in the main loop: sample the sensor when the period ends
+ * \returns true if the duty of the display must change
+ */
+bool al_process(al_sensor_t *A);
+
+/**
+ * \fn static inline uint16_t al_duty(const al_sensor_t *A)
+ * \brief Duty of the display for the current step
+ */
+static inline uint16_t al_duty(const al_sensor_t *A){
+    return alSteps[A->step].duty;
+}
+
+#endif
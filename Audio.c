@@ -0,0 +1,230 @@
+/**
+ * \file        Audio.c
+ * \brief       Playback of compressed sound clips from flash through a PWM channel
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "Audio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "hardware/gpio.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "Profile.h"
+#include "ClockGov.h"
+
+aud_player_t aud = {.dma = {-1, -1}, .timer = -1};
+
+static const int16_t audStep[89] = {   ///< IMA ADPCM step sizes
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t audIndex[8] = {-1, -1, -1, -1, 2, 4, 6, 8};    ///< IMA ADPCM step index changes
+
+/**
+ * \fn static inline int16_t aud_ulaw(uint8_t u)
+ * \brief G.711 µ-law to 16 bit PCM
+ */
+static inline int16_t aud_ulaw(uint8_t u){
+    u = ~u;
+    int16_t t = (((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4);
+    return (u & 0x80) ? 0x84 - t : t - 0x84;
+}
+
+/**
+ * \fn static inline int16_t aud_adpcm(aud_decoder_t *D, uint8_t nibble)
+ * \brief Decode one IMA ADPCM nibble
+ */
+static inline int16_t aud_adpcm(aud_decoder_t *D, uint8_t nibble){
+    int32_t step = audStep[D->index];
+    int32_t diff = step >> 3;
+    if(nibble & 4) diff += step;
+    if(nibble & 2) diff += step >> 1;
+    if(nibble & 1) diff += step >> 2;
+    int32_t pred = D->pred + ((nibble & 8) ? -diff : diff);
+    if(pred > 32767) pred = 32767;
+    if(pred < -32768) pred = -32768;
+    int8_t index = D->index + audIndex[nibble & 7];
+    D->index = index < 0 ? 0 : index > 88 ? 88 : index;
+    return D->pred = pred;
+}
+
+void aud_decode(aud_decoder_t *D, int16_t *pcm, uint32_t n){
+    const aud_clip_t *C = D->clip;
+    uint32_t i = 0;
+    if(C->format == AUD_ULAW){
+        for(; i < n && D->pos < C->samples; i++)
+            pcm[i] = aud_ulaw(C->data[D->pos++]);
+    }
+    else{
+        for(; i < n && D->pos < C->samples; i++, D->pos++){
+            uint8_t b = C->data[D->pos >> 1];
+            pcm[i] = aud_adpcm(D, (D->pos & 1) ? b >> 4 : b & 0x0F);
+        }
+    }
+    for(; i < n; i++)
+        pcm[i] = 0;
+}
+
+/**
+ * \fn static uint8_t aud_volume(aud_player_t *A, uint32_t ms)
+ * \brief Volume of a block starting ms after aud_play
+ */
+static uint8_t aud_volume(aud_player_t *A, uint32_t ms){
+    if(!A->escalate || ms >= A->volRampMs)
+        return AUD_VOLUME_MAX;
+    return A->volStart + (AUD_VOLUME_MAX - A->volStart) * ms / A->volRampMs;
+}
+
+/**
+ * \fn static void aud_fill(aud_player_t *A, uint32_t *buf)
+ * \brief Decode the next block into a DMA buffer, compare register words with the other channel level
+ */
+static void aud_fill(aud_player_t *A, uint32_t *buf){
+    uint32_t t0 = prof_cycles();
+    const aud_clip_t *C = A->dec.clip;
+    uint32_t ms = (uint64_t)A->played * 1000 / C->rate;
+    int16_t *pcm = (int16_t *)buf;      ///< Decoded in place, then expanded to words from the end
+    uint32_t n = 0;
+    if(!A->ending && ms < A->maxOnMs){
+        while(n < AUD_BLOCK){
+            uint32_t left = C->samples - A->dec.pos;
+            uint32_t k = AUD_BLOCK - n < left ? AUD_BLOCK - n : left;
+            aud_decode(&A->dec, pcm + n, k);
+            n += k;
+            if(A->dec.pos < C->samples)
+                continue;
+            if(!A->loop)
+                break;
+            aud_decode_start(&A->dec, C);
+        }
+        A->played += n;
+    }
+    if(n < AUD_BLOCK && !A->ending)     ///< Last samples, this block and the one playing end the clip
+        A->ending = 2;
+    int32_t volume = aud_volume(A, ms);
+    uint32_t other = (uint32_t)A->other << (A->chan ? 0 : 16);
+    uint8_t shift = A->chan ? 16 : 0;
+    for(int32_t i = AUD_BLOCK - 1; i >= 0; i--){
+        uint32_t level = i < (int32_t)n ? ((((int32_t)pcm[i] * volume) >> 8) + 32768) >> 6 : 0;
+        buf[i] = other | level << shift;
+    }
+    A->decodeCycles += (t0 - prof_cycles()) & PROF_SYSTICK_MASK;     ///< SysTick counts down
+    A->decoded += AUD_BLOCK;
+}
+
+/**
+ * \fn static void aud_halt(aud_player_t *A)
+ * \brief Stop the DMA channels and restore the slice
+ */
+static void aud_halt(aud_player_t *A){
+    for(uint8_t i = 0; i < 2; i++){
+        dma_channel_set_irq0_enabled(A->dma[i], false);
+        hw_clear_bits(&dma_hw->ch[A->dma[i]].al1_ctrl, DMA_CH0_CTRL_TRIG_EN_BITS);  ///< No chain triggers while aborting
+    }
+    dma_channel_abort(A->dma[0]);
+    dma_channel_abort(A->dma[1]);
+    dma_hw->ints0 = 1u << A->dma[0] | 1u << A->dma[1];
+    pwm_slice_hw_t *S = &pwm_hw->slice[A->slice];
+    uint32_t other = ((uint32_t)A->other * (A->savedTop + 1) + AUD_PWM_TOP / 2) / (AUD_PWM_TOP + 1);
+    S->div = A->savedDiv;
+    S->top = A->savedTop;
+    S->cc = A->chan ? other : other << 16;      ///< The sound channel is silent
+    A->playing = false;
+}
+
+/**
+ * \fn static void aud_dma_irq(void)
+ * \brief DMA interrupt: refill the block that just ended while the other block plays
+ */
+static void aud_dma_irq(void){
+    aud_player_t *A = &aud;
+    if(!A->playing)
+        return;
+    for(uint8_t i = 0; i < 2; i++){
+        if(!(dma_hw->ints0 & (1u << A->dma[i])))
+            continue;
+        dma_hw->ints0 = 1u << A->dma[i];
+        if(A->ending && !--A->ending){
+            aud_halt(A);
+            return;
+        }
+        dma_channel_set_read_addr(A->dma[i], A->buf[i], false);
+        aud_fill(A, A->buf[i]);
+    }
+}
+
+/**
+ * \fn static void aud_dma_config(aud_player_t *A)
+ * \brief Configure the ping-pong channels to the compare register, not started
+ */
+static void aud_dma_config(aud_player_t *A){
+    for(uint8_t i = 0; i < 2; i++){
+        dma_channel_config c = dma_channel_get_default_config(A->dma[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, dma_get_timer_dreq(A->timer));
+        channel_config_set_chain_to(&c, A->dma[i ^ 1]);     ///< Ping-pong
+        dma_channel_configure(A->dma[i], &c, &pwm_hw->slice[A->slice].cc, A->buf[i], AUD_BLOCK, false);
+    }
+}
+
+void aud_init(aud_player_t *A, uint8_t numGPIO){
+    if(A->playing)
+        aud_stop(A);
+    A->numGPIO = numGPIO;
+    A->slice = pwm_gpio_to_slice_num(numGPIO);
+    A->chan = pwm_gpio_to_channel(numGPIO);
+    A->volStart = AUD_VOLUME_MAX / 8;
+    A->volRampMs = 30000;
+    A->maxOnMs = 60000;                 ///< README limit of the alarm sound
+    if(A->dma[0] < 0){                  ///< DMA channels and timer are kept across aud_init calls
+        A->dma[0] = dma_claim_unused_channel(true);
+        A->dma[1] = dma_claim_unused_channel(true);
+        A->timer = dma_claim_unused_timer(true);
+        irq_add_shared_handler(DMA_IRQ_0, aud_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+}
+
+void aud_play(aud_player_t *A, const aud_clip_t *clip, bool loop, bool escalate){
+    aud_stop(A);
+    cg_boost(&cgGov, CG_AUDIO);         ///< The pacing timer and the carrier are set from clk_sys at ACTIVE
+    pwm_slice_hw_t *S = &pwm_hw->slice[A->slice];
+    A->savedDiv = S->div;
+    A->savedTop = S->top;
+    uint32_t other = A->chan ? S->cc & 0xFFFF : S->cc >> 16;
+    A->other = (other * (AUD_PWM_TOP + 1) + A->savedTop / 2) / (A->savedTop + 1);   ///< Same duty at the clip wrap
+    aud_decode_start(&A->dec, clip);
+    A->loop = loop;
+    A->escalate = escalate;
+    A->ending = 0;
+    A->played = 0;
+    aud_fill(A, A->buf[0]);
+    aud_fill(A, A->buf[1]);
+
+    aud_dma_config(A);
+    dma_timer_set_fraction(A->timer, 1, (clock_get_hz(clk_sys) + clip->rate / 2) / clip->rate);
+    dma_channel_set_irq0_enabled(A->dma[0], true);
+    dma_channel_set_irq0_enabled(A->dma[1], true);
+    S->div = 1 << PWM_CH0_DIV_INT_LSB;  ///< Carrier of clk_sys / (AUD_PWM_TOP + 1)
+    S->top = AUD_PWM_TOP;
+    A->playing = true;
+    dma_channel_start(A->dma[0]);
+}
+
+void aud_stop(aud_player_t *A){
+    uint32_t save = save_and_disable_interrupts();
+    if(A->playing)
+        aud_halt(A);
+    restore_interrupts(save);
+}
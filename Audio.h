@@ -0,0 +1,134 @@
+/**
+ * \file        Audio.h
+ * \brief       Playback of compressed sound clips from flash through a PWM channel
+ * \details     A clip is µ-law (8 bits per sample) or IMA ADPCM (4 bits per sample, low nibble
+ * first, decoder state starting at 0) encoded mono audio at 8 to 16 kHz, stored in flash; they
+ * are made with tools/wuaudio.py. Two DMA channels chained in ping-pong feed the compare register
+ * of the PWM slice from two RAM blocks, paced by a DMA timer at the sample rate. When a block ends
+ * the DMA interrupt decodes the next AUD_BLOCK samples into it while the other block plays: the CPU
+ * works once per block, the superloop and the display multiplex are not involved.
+ *
+ * During a clip the slice runs with a wrap of AUD_PWM_TOP (122 kHz carrier at 125 MHz). The other
+ * channel of the slice (the alarm LED on GPIO 21) is written by the DMA too: it holds the duty it
+ * had when the clip started, the slice period and the level are restored by aud_stop. Like the
+ * buzzer, the player ends a clip after maxOnMs and raises the volume from volStart over volRampMs,
+ * both evaluated at block boundaries from the samples played.
+ *
+ * aud_play raises clk_sys to the ACTIVE level of the clock governor before the pacing timer and the
+ * carrier are set, the application keeps it there while the clip plays (see ClockGov.h).
+ *
+ * aud.decodeCycles / aud.decoded is the decode cost per sample, shown by the SOUND command.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __AUDIO_H_
+#define __AUDIO_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define AUD_BLOCK 256               ///< Samples per DMA block, 32 ms at 8 kHz
+#define AUD_PWM_TOP 1023            ///< Wrap of the slice during a clip, 10 bit samples
+#define AUD_VOLUME_MAX 255          ///< Full volume
+
+typedef enum{
+    AUD_ULAW = 0,               ///< G.711 µ-law, one byte per sample
+    AUD_ADPCM                   ///< IMA ADPCM, two samples per byte
+} aud_format_t;
+
+typedef struct{
+    const uint8_t *data;        ///< Encoded samples in flash
+    uint32_t samples;           ///< Number of samples
+    uint16_t rate;              ///< Sample rate in Hz, 8000 to 16000
+    uint8_t format;             ///< aud_format_t
+} aud_clip_t;
+
+typedef struct{
+    const aud_clip_t *clip;     ///< Clip being decoded
+    uint32_t pos;               ///< Next sample to decode
+    int16_t pred;               ///< ADPCM predictor
+    uint8_t index;              ///< ADPCM step index
+} aud_decoder_t;
+
+typedef struct{
+    uint8_t numGPIO;            ///< PWM GPIO of the sound
+    uint8_t slice;              ///< PWM slice of numGPIO
+    uint8_t chan;               ///< PWM channel of numGPIO, 0 for A
+    int8_t dma[2];              ///< Ping-pong DMA channels, -1 before aud_init
+    int8_t timer;               ///< DMA pacing timer
+    uint32_t buf[2][AUD_BLOCK]; ///< Compare register words played by the DMA
+    aud_decoder_t dec;          ///< Decoder state
+    bool loop;                  ///< Start the clip again at its end
+    bool escalate;              ///< Volume ramp of an alarm
+    volatile bool playing;      ///< A clip is playing, cleared by the interrupt at the end
+    uint8_t ending;             ///< Blocks left to play after the last sample, 0 while decoding
+    uint16_t other;             ///< Level of the other channel during the clip
+    uint32_t savedDiv;          ///< Slice divider before the clip
+    uint32_t savedTop;          ///< Slice wrap before the clip
+    uint32_t played;            ///< Samples decoded since aud_play
+    uint8_t volStart;           ///< Volume at the start of a ring, 1 to AUD_VOLUME_MAX
+    uint32_t volRampMs;         ///< Time of a ring to reach full volume
+    uint32_t maxOnMs;           ///< Longest sound of a clip in ms
+    uint64_t decodeCycles;      ///< clk_sys cycles spent decoding
+    uint32_t decoded;           ///< Samples decoded in decodeCycles
+} aud_player_t;
+
+extern aud_player_t aud;        ///< PWM/DMA player of the alarm clips
+extern const aud_clip_t audChime;   ///< Built-in alarm chime, see AudioClips.c
+
+/**
+ * \fn void aud_init(aud_player_t *A, uint8_t numGPIO)
+ * \brief Claim the DMA channels and the pacing timer, the GPIO must already be a PWM output
+ * \param A         Pointer to the player
+ * \param numGPIO   GPIO of the sound, the tone buzzer GPIO
+ */
+void aud_init(aud_player_t *A, uint8_t numGPIO);
+
+/**
+ * \fn void aud_play(aud_player_t *A, const aud_clip_t *clip, bool loop, bool escalate)
+ * \brief Start a clip, a clip already playing is stopped first
+ * \param A         Pointer to the player
+ * \param clip      Clip in flash
+ * \param loop      Play the clip again at its end, until aud_stop or maxOnMs
+ * \param escalate  Raise the volume from volStart over volRampMs, for alarms
+ */
+void aud_play(aud_player_t *A, const aud_clip_t *clip, bool loop, bool escalate);
+
+/**
+ * \fn void aud_stop(aud_player_t *A)
+ * \brief Stop the clip and give the slice back with its period and levels
+ */
+void aud_stop(aud_player_t *A);
+
+/**
+ * \fn static inline bool aud_is_playing(aud_player_t *A)
+ * \brief Return true while a clip plays
+ */
+static inline bool aud_is_playing(aud_player_t *A){
+    return A->playing;
+}
+
+/**
+ * \fn void aud_decode(aud_decoder_t *D, int16_t *pcm, uint32_t n)
+ * \brief Decode up to n samples to 16 bit PCM, the samples past the end of the clip are 0
+ * \param D     Decoder, reset with aud_decode_start
+ * \param pcm   Output samples
+ * \param n     Number of samples
+ */
+void aud_decode(aud_decoder_t *D, int16_t *pcm, uint32_t n);
+
+/**
+ * \fn static inline void aud_decode_start(aud_decoder_t *D, const aud_clip_t *clip)
+ * \brief Reset a decoder to the start of a clip
+ */
+static inline void aud_decode_start(aud_decoder_t *D, const aud_clip_t *clip){
+    D->clip = clip;
+    D->pos = 0;
+    D->pred = 0;
+    D->index = 0;
+}
+
+#endif
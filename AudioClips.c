@@ -0,0 +1,221 @@
+/**
+ * \file        AudioClips.c
+ * \brief       Built-in sound clips for the sample player, see Audio.h
+ * \details     Made with tools/wuaudio.py encode, for example:
+ *
+ *      tools/wuaudio.py encode --synth chime -o chime.c --name audChime
+ *
+ * tools/wuaudio.py decode AudioClips.c --name audChime -o chime.wav plays a clip back on the host.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "Audio.h"
+
+/// audChime: synthesized chime, 6400 samples at 8000 Hz, generated by tools/wuaudio.py
+static const uint8_t audChimeData[] = {
+    0x70, 0x77, 0xff, 0x7f, 0x87, 0xff, 0x73, 0xb8, 0xb8, 0x44, 0xa8, 0xaa, 0x72, 0x98, 0x9a, 0x61,
+    0x98, 0xa9, 0x51, 0xb1, 0xb8, 0x51, 0xa1, 0xaa, 0x70, 0x90, 0x9a, 0x50, 0xa1, 0xb9, 0x41, 0xb3,
+    0xc9, 0x68, 0x91, 0x9a, 0x69, 0x91, 0xa9, 0x48, 0xb3, 0xc8, 0x38, 0x95, 0x9a, 0x5a, 0x82, 0x9b,
+    0x5a, 0x93, 0xaa, 0x3a, 0x87, 0xa9, 0x29, 0x85, 0x9a, 0x3a, 0x14, 0x9c, 0x2a, 0x86, 0xa9, 0x09,
+    0x87, 0x99, 0x09, 0x05, 0x8a, 0x1b, 0x15, 0x9a, 0x0b, 0x07, 0x99, 0x99, 0x06, 0x99, 0x89, 0x24,
+    0x9a, 0x8b, 0x35, 0xaa, 0xaa, 0x17, 0xa8, 0x99, 0x34, 0xa9, 0x9b, 0x64, 0x99, 0x9a, 0x43, 0xa8,
+    0xaa, 0x44, 0xa8, 0xaa, 0x73, 0x98, 0x9a, 0x61, 0x98, 0xa9, 0x42, 0xb0, 0xb8, 0x52, 0xb1, 0xb9,
+    0x71, 0x90, 0x9a, 0x50, 0xa1, 0xa9, 0x50, 0xa1, 0xb9, 0x60, 0x91, 0x9a, 0x69, 0x91, 0xa9, 0x48,
+    0x92, 0xba, 0x40, 0xa4, 0xb9, 0x69, 0x82, 0x9b, 0x5a, 0x82, 0xaa, 0x4a, 0x95, 0xa9, 0x29, 0x86,
+    0x9a, 0x29, 0x04, 0x9b, 0x3b, 0x87, 0x99, 0x1a, 0x86, 0x99, 0x09, 0x05, 0x8a, 0x2b, 0x14, 0x9b,
+    0x1b, 0x07, 0x99, 0x8a, 0x06, 0xa8, 0x89, 0x24, 0x9a, 0x0b, 0x25, 0x9a, 0x9b, 0x17, 0xa8, 0x99,
+    0x24, 0x99, 0x9b, 0x35, 0xa9, 0x9b, 0x54, 0xa8, 0xaa, 0x44, 0xb8, 0xa9, 0x44, 0xa8, 0x9a, 0x71,
+    0x98, 0xa9, 0x42, 0xa0, 0xb9, 0x62, 0xa0, 0xa9, 0x61, 0x90, 0x9a, 0x68, 0x90, 0xa9, 0x50, 0xa1,
+    0xa9, 0x50, 0xa1, 0xa9, 0x68, 0x91, 0x9a, 0x69, 0x91, 0xa9, 0x48, 0x92, 0xaa, 0x59, 0x93, 0x9b,
+    0x6b, 0x82, 0xaa, 0x5a, 0x93, 0xb9, 0x39, 0x97, 0x99, 0x3a, 0x04, 0x9b, 0x3c, 0x85, 0xa9, 0x2a,
+    0x86, 0xa9, 0x19, 0x06, 0x9a, 0x1a, 0x05, 0x8a, 0x1b, 0x15, 0xaa, 0x89, 0x07, 0x99, 0x89, 0x24,
+    0x9a, 0x0b, 0x25, 0xaa, 0x8a, 0x16, 0xb8, 0x99, 0x25, 0xa9, 0x9a, 0x35, 0xa9, 0x9b, 0x45, 0xa9,
+    0x9a, 0x34, 0xb8, 0xba, 0x36, 0xa8, 0xab, 0x73, 0x98, 0x9a, 0x52, 0xa0, 0xaa, 0x52, 0xb1, 0xb9,
+    0x62, 0x90, 0x9b, 0x70, 0x90, 0xa9, 0x41, 0xb1, 0xb8, 0x50, 0xa2, 0xaa, 0x78, 0x91, 0x9a, 0x48,
+    0xa2, 0xb9, 0x58, 0xa3, 0xba, 0x68, 0x92, 0xaa, 0x59, 0x93, 0xab, 0x6a, 0x93, 0xaa, 0x39, 0x97,
+    0x99, 0x29, 0x04, 0xab, 0x4a, 0x04, 0xab, 0x3a, 0x87, 0xa9, 0x19, 0x05, 0x9a, 0x1a, 0x15, 0x9b,
+    0x2b, 0x06, 0xa9, 0x0a, 0x07, 0x99, 0x89, 0x05, 0x99, 0x0a, 0x24, 0x9a, 0x0b, 0x25, 0xaa, 0x9a,
+    0x17, 0xa8, 0x8a, 0x34, 0x9a, 0x8c, 0x53, 0x99, 0xaa, 0x25, 0xa8, 0xaa, 0x44, 0xa8, 0xaa, 0x73,
+    0x98, 0x9a, 0x42, 0x98, 0xba, 0x63, 0xa0, 0xb9, 0x62, 0xa0, 0xa9, 0x61, 0x88, 0x9a, 0x50, 0x90,
+    0xaa, 0x51, 0xa1, 0xb9, 0x60, 0x91, 0xaa, 0x50, 0x91, 0xaa, 0x58, 0xa2, 0xb9, 0x40, 0xa4, 0xb9,
+    0x69, 0x92, 0x9a, 0x5a, 0x82, 0xaa, 0x39, 0x96, 0xa9, 0x39, 0x85, 0xaa, 0x4a, 0x84, 0xaa, 0x3a,
+    0x86, 0xa9, 0x2a, 0x86, 0xa9, 0x19, 0x15, 0x9b, 0x1a, 0x06, 0xa9, 0x1a, 0x15, 0xaa, 0x89, 0x07,
+    0x99, 0x1a, 0x23, 0xaa, 0x0c, 0x25, 0xaa, 0x8a, 0x16, 0xa8, 0x9a, 0x25, 0x99, 0x8b, 0x44, 0xa9,
+    0x8b, 0x44, 0xa9, 0xaa, 0x35, 0xb8, 0xaa, 0x45, 0x99, 0x9a, 0x62, 0xa8, 0xa9, 0x43, 0xb0, 0xb9,
+    0x63, 0xa0, 0xaa, 0x71, 0x90, 0x9a, 0x60, 0x90, 0x9a, 0x31, 0xb2, 0xca, 0x61, 0xa1, 0x9a, 0x68,
+    0x91, 0x9a, 0x48, 0xa2, 0xb9, 0x68, 0xa2, 0xa9, 0x59, 0x82, 0xab, 0x69, 0x92, 0xaa, 0x49, 0x94,
+    0xb9, 0x38, 0x96, 0xa9, 0x39, 0x04, 0xab, 0x4b, 0x85, 0xb9, 0x29, 0x86, 0xa9, 0x19, 0x06, 0x9a,
+    0x2a, 0x14, 0xab, 0x1a, 0x07, 0xa9, 0x09, 0x05, 0x99, 0x1b, 0x15, 0x9a, 0x1b, 0x25, 0xaa, 0x8b,
+    0x17, 0xa9, 0x89, 0x15, 0x99, 0x0b, 0x34, 0xaa, 0x9b, 0x36, 0xb9, 0x9a, 0x35, 0xb8, 0x9b, 0x54,
+    0xa8, 0x9a, 0x72, 0x98, 0x9a, 0x42, 0xb0, 0xb9, 0x63, 0xa0, 0xaa, 0x62, 0xa0, 0x9a, 0x61, 0xa0,
+    0xa9, 0x42, 0xb1, 0xb9, 0x61, 0xa1, 0x9a, 0x68, 0x91, 0xaa, 0x50, 0x91, 0xaa, 0x40, 0xa3, 0xca,
+    0x58, 0x92, 0xaa, 0x69, 0x92, 0xaa, 0x48, 0x93, 0xca, 0x38, 0x85, 0xba, 0x49, 0x84, 0x9b, 0x4a,
+    0x84, 0xba, 0x39, 0x86, 0xb9, 0x29, 0x06, 0xaa, 0x29, 0x14, 0xab, 0x2b, 0x07, 0xa9, 0x1a, 0x06,
+    0xa9, 0x09, 0x15, 0x9a, 0x1b, 0x24, 0xaa, 0x0b, 0x26, 0xaa, 0x8a, 0x16, 0xa8, 0x0b, 0x34, 0xaa,
+    0x0c, 0x34, 0xb9, 0x9b, 0x36, 0xb9, 0x9a, 0x35, 0xb8, 0x9b, 0x64, 0xa8, 0x9a, 0x43, 0xb0, 0xba,
+    0x54, 0xb0, 0xa9, 0x62, 0xa0, 0x9a, 0x61, 0xa0, 0xa9, 0x51, 0x90, 0xaa, 0x51, 0xa1, 0xaa, 0x60,
+    0x91, 0xaa, 0x50, 0x91, 0xba, 0x41, 0xa3, 0xbb, 0x78, 0x92, 0xaa, 0x69, 0x81, 0xaa, 0x48, 0x93,
+    0xbb, 0x48, 0x95, 0xb9, 0x49, 0x84, 0x9b, 0x4a, 0x84, 0xaa, 0x3a, 0x86, 0xb9, 0x29, 0x86, 0xa9,
+    0x29, 0x04, 0xaa, 0x3b, 0x06, 0xb9, 0x19, 0x06, 0xa9, 0x1a, 0x15, 0xaa, 0x0a, 0x16, 0xa9, 0x0a,
+    0x15, 0xa9, 0x8a, 0x16, 0xa9, 0x0a, 0x34, 0xaa, 0x0c, 0x34, 0xaa, 0x9b, 0x36, 0xb9, 0x9a, 0x35,
+    0xb8, 0x9b, 0x54, 0xa8, 0x9b, 0x44, 0xa8, 0xaa, 0x34, 0xb0, 0xbb, 0x45, 0xa0, 0xab, 0x73, 0xa0,
+    0x9a, 0x51, 0x90, 0xaa, 0x51, 0xa1, 0xaa, 0x70, 0x90, 0xa9, 0x50, 0x91, 0xaa, 0x40, 0xa2, 0xba,
+    0x60, 0x92, 0xab, 0x68, 0x81, 0xaa, 0x59, 0x92, 0xaa, 0x48, 0x94, 0xba, 0x48, 0x84, 0xab, 0x49,
+    0x84, 0xab, 0x39, 0x86, 0xb9, 0x39, 0x85, 0xb9, 0x3a, 0x06, 0xaa, 0x2a, 0x06, 0xaa, 0x19, 0x05,
+    0xa9, 0x1a, 0x06, 0xa9, 0x1a, 0x15, 0xaa, 0x1a, 0x15, 0xb9, 0x0a, 0x16, 0xa9, 0x8a, 0x16, 0x99,
+    0x0b, 0x34, 0xaa, 0x8b, 0x26, 0xa9, 0x9a, 0x35, 0xb9, 0x9a, 0x54, 0x99, 0x8b, 0x53, 0xa8, 0x9b,
+    0x44, 0xa8, 0xaa, 0x63, 0xa0, 0x9b, 0x62, 0xa0, 0x9a, 0x51, 0x90, 0xab, 0x62, 0x90, 0xaa, 0x51,
+    0xa1, 0xaa, 0x70, 0x90, 0xa9, 0x31, 0xa2, 0xca, 0x50, 0x92, 0xab, 0x68, 0x92, 0xab, 0x68, 0x81,
+    0xaa, 0x48, 0x93, 0xbb, 0x58, 0x83, 0xac, 0x59, 0x82, 0xba, 0x49, 0x84, 0xba, 0x49, 0x84, 0xaa,
+    0x3a, 0x06, 0xaa, 0x3a, 0x05, 0xba, 0x2a, 0x07, 0xa9, 0x1a, 0x05, 0xa9, 0x1a, 0x15, 0xaa, 0x1a,
+    0x16, 0xaa, 0x1a, 0x15, 0xb9, 0x0a, 0x16, 0xa9, 0x0a, 0x34, 0xaa, 0x0c, 0x34, 0xb9, 0x9b, 0x36,
+    0xb9, 0x9a, 0x35, 0xa9, 0x9b, 0x45, 0xa9, 0x9a, 0x34, 0xc0, 0x9a, 0x63, 0xa8, 0x9a, 0x62, 0x98,
+    0x9a, 0x52, 0xa0, 0xaa, 0x52, 0xa0, 0xaa, 0x62, 0x90, 0x9b, 0x51, 0xa1, 0xaa, 0x60, 0x91, 0xba,
+    0x51, 0xa2, 0xba, 0x60, 0x91, 0xaa, 0x68, 0x81, 0xaa, 0x48, 0x92, 0xba, 0x58, 0x93, 0xbb, 0x69,
+    0x83, 0xbb, 0x59, 0x83, 0xbb, 0x49, 0x86, 0xaa, 0x39, 0x04, 0xab, 0x3a, 0x06, 0xaa, 0x2a, 0x06,
+    0xaa, 0x19, 0x06, 0xb9, 0x19, 0x15, 0xaa, 0x1a, 0x15, 0xaa, 0x0a, 0x16, 0xa9, 0x0a, 0x15, 0xa9,
+    0x0b, 0x26, 0xaa, 0x0a, 0x34, 0xc9, 0x8a, 0x25, 0xb8, 0x8b, 0x35, 0xa9, 0x8c, 0x34, 0xa9, 0x9b,
+    0x35, 0xb8, 0xab, 0x45, 0xb0, 0xaa, 0x63, 0xa0, 0x9b, 0x62, 0xa0, 0x9a, 0x42, 0xb1, 0xba, 0x63,
+    0xa1, 0xab, 0x71, 0x90, 0x9a, 0x50, 0xa1, 0xaa, 0x51, 0x91, 0xba, 0x51, 0x91, 0xba, 0x60, 0x81,
+    0xab, 0x58, 0x92, 0xba, 0x58, 0x93, 0xca, 0x48, 0x83, 0xbb, 0x59, 0x83, 0xcb, 0x38, 0x86, 0xaa,
+    0x39, 0x85, 0xaa, 0x3a, 0x06, 0xba, 0x39, 0x05, 0xba, 0x3a, 0x06, 0xaa, 0x2a, 0x15, 0xba, 0x2a,
+    0x15, 0xaa, 0x1b, 0x17, 0xaa, 0x09, 0x15, 0xa9, 0x1b, 0x24, 0xb9, 0x0b, 0x26, 0xb9, 0x8a, 0x26,
+    0xa9, 0x8b, 0x25, 0xb8, 0x8b, 0x35, 0xb8, 0x8c, 0x34, 0xb8, 0xab, 0x45, 0xa8, 0x9b, 0x44, 0xa8,
+    0x9b, 0x63, 0xa0, 0x9b, 0x53, 0xa0, 0xab, 0x63, 0xa0, 0xaa, 0x52, 0xa1, 0xab, 0x62, 0x90, 0xaa,
+    0x51, 0xa1, 0xaa, 0x60, 0x91, 0xaa, 0x50, 0x91, 0xba, 0x60, 0x81, 0xab, 0x40, 0x93, 0xcb, 0x58,
+    0x82, 0xab, 0x59, 0x93, 0xba, 0x59, 0x83, 0xbb, 0x49, 0x85, 0xba, 0x49, 0x84, 0xaa, 0x3a, 0x06,
+    0xba, 0x29, 0x06, 0xaa, 0x19, 0x15, 0xba, 0x2a, 0x06, 0xa9, 0x1a, 0x15, 0xaa, 0x1a, 0x15, 0xb9,
+    0x0a, 0x16, 0xa9, 0x0a, 0x25, 0xaa, 0x0b, 0x16, 0xb8, 0x8a, 0x25, 0xb8, 0x8b, 0x35, 0xa9, 0x8c,
+    0x34, 0xb8, 0x9b, 0x35, 0xb8, 0xab, 0x45, 0xb0, 0x9b, 0x44, 0xa8, 0x9b, 0x63, 0xa0, 0xaa, 0x62,
+    0xa0, 0x9a, 0x51, 0xa1, 0x9b, 0x61, 0x90, 0xaa, 0x51, 0xa1, 0xaa, 0x51, 0x91, 0xab, 0x60, 0x91,
+    0xaa, 0x68, 0x81, 0xab, 0x40, 0x93, 0xcb, 0x40, 0x93, 0xbb, 0x69, 0x93, 0xab, 0x59, 0x83, 0xbb,
+    0x49, 0x85, 0xba, 0x49, 0x84, 0xaa, 0x4a, 0x03, 0xbb, 0x3a, 0x07, 0xb9, 0x3a, 0x05, 0xba, 0x3a,
+    0x16, 0xba, 0x2a, 0x15, 0xba, 0x1a, 0x17, 0xb9, 0x09, 0x15, 0xb9, 0x1a, 0x15, 0xa9, 0x0b, 0x16,
+    0xb8, 0x8a, 0x25, 0xa9, 0x0b, 0x44, 0xa9, 0x8b, 0x44, 0xa9, 0x8b, 0x44, 0xb8, 0x9a, 0x44, 0xa8,
+    0x9b, 0x44, 0xa8, 0x9b, 0x63, 0xa0, 0x9b, 0x43, 0xb1, 0xbb, 0x73, 0x90, 0x9b, 0x61, 0x90, 0xaa,
+    0x51, 0xa1, 0xaa, 0x51, 0x91, 0xab, 0x60, 0x91, 0xaa, 0x50, 0xa2, 0xba, 0x60, 0x92, 0xab, 0x40,
+    0x93, 0xac, 0x58, 0x82, 0xbb, 0x58, 0x93, 0xca, 0x38, 0x85, 0xba, 0x38, 0x85, 0xba, 0x49, 0x84,
+    0xba, 0x39, 0x06, 0xba, 0x29, 0x06, 0xaa, 0x19, 0x15, 0xba, 0x2a, 0x06, 0xa9, 0x1a, 0x15, 0xaa,
+    0x1a, 0x15, 0xb9, 0x1b, 0x16, 0xa9, 0x1b, 0x25, 0xb9, 0x0b, 0x16, 0xb8, 0x8a, 0x25, 0xb8, 0x8b,
+    0x35, 0xa9, 0x8c, 0x34, 0xb8, 0x8c, 0x34, 0xb8, 0x9b, 0x54, 0xa8, 0x9b, 0x44, 0xa8, 0x9b, 0x63,
+    0xa0, 0x9b, 0x43, 0xb1, 0xab, 0x72, 0x90, 0x9b, 0x61, 0x90, 0xaa, 0x51, 0xa1, 0xaa, 0x51, 0x91,
+    0xab, 0x60, 0x91, 0xaa, 0x50, 0x91, 0xba, 0x41, 0x93, 0xac, 0x58, 0x82, 0xbb, 0x58, 0x93, 0xbb,
+    0x58, 0x94, 0xba, 0x48, 0x84, 0xba, 0x49, 0x03, 0x7c, 0xa7, 0xea, 0x19, 0x36, 0xaa, 0xc8, 0x38,
+    0x24, 0xab, 0xc9, 0x60, 0x82, 0xb9, 0xb8, 0x71, 0x81, 0xa9, 0x99, 0x63, 0xa0, 0xa8, 0x1a, 0x44,
+    0xb8, 0xa8, 0x4b, 0x14, 0xb8, 0xa9, 0x7b, 0x83, 0x99, 0x9b, 0x60, 0x93, 0x8a, 0x9c, 0x43, 0xb3,
+    0x9a, 0x8c, 0x35, 0xa0, 0x8b, 0x0c, 0x17, 0x98, 0xa9, 0x18, 0x07, 0x89, 0x9a, 0x20, 0x05, 0x8b,
+    0xba, 0x53, 0x82, 0x9b, 0xba, 0x55, 0x90, 0xa9, 0x99, 0x45, 0xa8, 0xb8, 0x19, 0x26, 0xa9, 0xc8,
+    0x38, 0x14, 0xaa, 0xb9, 0x78, 0x82, 0xa9, 0x99, 0x70, 0x91, 0xa8, 0x0a, 0x62, 0xa0, 0xa8, 0x1a,
+    0x34, 0xc0, 0x99, 0x3b, 0x17, 0xa9, 0x99, 0x49, 0x85, 0x99, 0x9a, 0x50, 0x93, 0x9a, 0x9b, 0x44,
+    0xa2, 0x8b, 0x8c, 0x26, 0xa0, 0x9a, 0x0a, 0x27, 0x99, 0x9a, 0x29, 0x07, 0x89, 0xaa, 0x40, 0x03,
+    0x9b, 0xca, 0x62, 0x81, 0x9a, 0xaa, 0x45, 0x90, 0xaa, 0x89, 0x45, 0xa8, 0xb8, 0x29, 0x25, 0xb9,
+    0xc8, 0x48, 0x13, 0xba, 0xc9, 0x70, 0x81, 0xa8, 0x9a, 0x71, 0x91, 0x99, 0x0a, 0x52, 0xa0, 0x99,
+    0x1b, 0x26, 0xa8, 0x9a, 0x4b, 0x15, 0xa9, 0x9a, 0x59, 0x84, 0x99, 0xaa, 0x51, 0x93, 0x9a, 0x9c,
+    0x44, 0x91, 0x9b, 0x9a, 0x27, 0x88, 0xaa, 0x09, 0x17, 0x89, 0xaa, 0x20, 0x15, 0x9a, 0xba, 0x51,
+    0x03, 0xab, 0xca, 0x72, 0x81, 0x9a, 0x9a, 0x54, 0x98, 0xb8, 0x09, 0x35, 0xa9, 0xb8, 0x3a, 0x26,
+    0xb9, 0xb9, 0x79, 0x02, 0xa9, 0xa9, 0x60, 0x82, 0xa9, 0x8b, 0x71, 0x91, 0x99, 0x0b, 0x44, 0xa0,
+    0x9a, 0x1b, 0x17, 0xa0, 0x9a, 0x3a, 0x07, 0xa8, 0x99, 0x38, 0x86, 0x99, 0xaa, 0x42, 0x83, 0x8c,
+    0x9b, 0x44, 0x91, 0x9b, 0x8b, 0x37, 0xa8, 0x9a, 0x1a, 0x27, 0x8a, 0xaa, 0x38, 0x15, 0xaa, 0xc9,
+    0x51, 0x02, 0xab, 0xb9, 0x73, 0x81, 0xaa, 0x99, 0x54, 0xa0, 0xa9, 0x09, 0x35, 0xb8, 0xb9, 0x4a,
+    0x25, 0xb9, 0xb9, 0x79, 0x02, 0xa9, 0x9a, 0x60, 0x82, 0x9a, 0x8b, 0x72, 0xa1, 0x99, 0x0a, 0x34,
+    0xb1, 0xab, 0x2c, 0x17, 0x98, 0x9a, 0x3a, 0x07, 0x99, 0xa9, 0x30, 0x86, 0x99, 0xaa, 0x52, 0x92,
+    0x9a, 0x9b, 0x45, 0x90, 0xaa, 0x89, 0x36, 0x99, 0xaa, 0x19, 0x27, 0xa9, 0xb9, 0x48, 0x14, 0xaa,
+    0xc9, 0x51, 0x82, 0xaa, 0xa9, 0x72, 0x91, 0xa9, 0x89, 0x73, 0xa0, 0xa8, 0x1a, 0x34, 0xb8, 0xb9,
+    0x5b, 0x15, 0xa9, 0xaa, 0x58, 0x84, 0xa9, 0xa9, 0x61, 0x92, 0xa9, 0x8b, 0x73, 0xa1, 0x99, 0x1b,
+    0x34, 0xa0, 0xab, 0x2b, 0x37, 0x99, 0xab, 0x4a, 0x07, 0x99, 0xa9, 0x40, 0x03, 0x9b, 0x9c, 0x52,
+    0x82, 0xab, 0xaa, 0x36, 0xa1, 0xba, 0x0a, 0x37, 0xa8, 0xba, 0x28, 0x17, 0x99, 0xb9, 0x48, 0x14,
+    0xaa, 0xba, 0x71, 0x82, 0xaa, 0x99, 0x72, 0x80, 0xa9, 0x0a, 0x53, 0xa0, 0xb9, 0x2a, 0x26, 0xa8,
+    0xaa, 0x4a, 0x15, 0xa9, 0xaa, 0x68, 0x83, 0xa9, 0x9b, 0x71, 0x92, 0xa9, 0x8b, 0x44, 0x91, 0x9b,
+    0x0c, 0x35, 0x98, 0xab, 0x2a, 0x27, 0x99, 0xaa, 0x39, 0x07, 0x99, 0x9a, 0x40, 0x84, 0x9a, 0xaa,
+    0x63, 0x81, 0x9b, 0x9a, 0x45, 0x90, 0xba, 0x09, 0x36, 0x99, 0xba, 0x39, 0x26, 0xb9, 0xb9, 0x68,
+    0x03, 0xaa, 0xba, 0x71, 0x82, 0xb9, 0xa9, 0x73, 0x91, 0xa9, 0x0a, 0x63, 0xa0, 0xa9, 0x2a, 0x25,
+    0xb8, 0xaa, 0x5a, 0x05, 0xa8, 0xaa, 0x68, 0x83, 0x9a, 0x9b, 0x61, 0xa3, 0xa9, 0x8b, 0x44, 0xa2,
+    0xab, 0x0b, 0x37, 0x98, 0xab, 0x2a, 0x27, 0x99, 0xba, 0x30, 0x16, 0xaa, 0xaa, 0x51, 0x03, 0xab,
+    0xbb, 0x55, 0x91, 0xaa, 0x99, 0x45, 0xa0, 0xb9, 0x19, 0x35, 0xb8, 0xc9, 0x39, 0x16, 0xa9, 0xb9,
+    0x68, 0x12, 0xaa, 0xaa, 0x71, 0x81, 0xa9, 0x8a, 0x72, 0x90, 0x99, 0x0a, 0x34, 0xb0, 0xb9, 0x3b,
+    0x27, 0xa8, 0xab, 0x59, 0x04, 0xb8, 0xaa, 0x60, 0x83, 0x9a, 0x8c, 0x51, 0x92, 0x9a, 0x8c, 0x34,
+    0xa1, 0xba, 0x0a, 0x37, 0xa8, 0xaa, 0x2a, 0x27, 0xa9, 0xaa, 0x30, 0x16, 0xaa, 0xaa, 0x61, 0x82,
+    0xaa, 0x9a, 0x73, 0x91, 0xa9, 0x8a, 0x54, 0x98, 0xa9, 0x1a, 0x35, 0xa9, 0xc9, 0x38, 0x24, 0xb9,
+    0xca, 0x68, 0x02, 0xa9, 0xaa, 0x71, 0x92, 0xa9, 0x8a, 0x62, 0x91, 0xaa, 0x0a, 0x35, 0xa0, 0xab,
+    0x3b, 0x27, 0xa8, 0xab, 0x48, 0x05, 0x99, 0xab, 0x60, 0x83, 0xaa, 0x9b, 0x63, 0x92, 0xaa, 0x8b,
+    0x45, 0xa1, 0xaa, 0x0a, 0x27, 0x98, 0xab, 0x28, 0x26, 0x9a, 0xba, 0x40, 0x05, 0x9a, 0xba, 0x62,
+    0x82, 0xaa, 0xaa, 0x54, 0x91, 0xaa, 0x8a, 0x45, 0xa0, 0xb9, 0x19, 0x26, 0xa8, 0xba, 0x48, 0x14,
+    0xb9, 0xaa, 0x78, 0x02, 0xb9, 0x9a, 0x71, 0x92, 0xa9, 0x8a, 0x53, 0xa1, 0xaa, 0x1b, 0x36, 0xb0,
+    0xaa, 0x3b, 0x27, 0xa8, 0xab, 0x48, 0x05, 0xa9, 0xaa, 0x51, 0x84, 0xaa, 0x9a, 0x53, 0x92, 0xab,
+    0x8b, 0x46, 0x90, 0xba, 0x09, 0x27, 0x99, 0xb9, 0x28, 0x16, 0x99, 0xba, 0x50, 0x03, 0xaa, 0xab,
+    0x72, 0x82, 0xaa, 0x9a, 0x73, 0x91, 0xaa, 0x0a, 0x54, 0x98, 0xb9, 0x29, 0x25, 0xb8, 0xaa, 0x59,
+    0x04, 0xb8, 0xaa, 0x60, 0x83, 0xaa, 0x9b, 0x72, 0x92, 0xb9, 0x8a, 0x44, 0xa1, 0xaa, 0x1b, 0x27,
+    0xa0, 0xaa, 0x3a, 0x16, 0xa8, 0xab, 0x40, 0x05, 0xa9, 0x9b, 0x51, 0x83, 0xba, 0xab, 0x55, 0x91,
+    0xaa, 0x8a, 0x45, 0x90, 0xab, 0x19, 0x26, 0xa8, 0xba, 0x38, 0x26, 0xaa, 0xba, 0x60, 0x03, 0xba,
+    0xaa, 0x72, 0x82, 0xaa, 0x9a, 0x73, 0x91, 0xaa, 0x1a, 0x44, 0x98, 0xba, 0x3a, 0x26, 0xb8, 0xaa,
+    0x59, 0x04, 0xa9, 0xaa, 0x60, 0x83, 0xaa, 0x9b, 0x72, 0x92, 0x9a, 0x8b, 0x44, 0x91, 0xab, 0x1b,
+    0x27, 0xa0, 0x9b, 0x3a, 0x17, 0x99, 0xaa, 0x48, 0x04, 0xa9, 0x9b, 0x51, 0x83, 0xba, 0xab, 0x55,
+    0x91, 0xaa, 0x8a, 0x36, 0x98, 0xba, 0x19, 0x36, 0xa9, 0xba, 0x38, 0x17, 0xa9, 0xaa, 0x50, 0x03,
+    0xba, 0xba, 0x73, 0x82, 0xba, 0x8a, 0x54, 0xa1, 0xb9, 0x0a, 0x36, 0xa8, 0xba, 0x39, 0x26, 0xb8,
+    0xba, 0x69, 0x13, 0xb9, 0xab, 0x70, 0x83, 0xaa, 0x9b, 0x73, 0x81, 0xaa, 0x0b, 0x44, 0xa1, 0xba,
+    0x1a, 0x27, 0x98, 0xab, 0x28, 0x17, 0x99, 0xaa, 0x30, 0x05, 0xa9, 0xab, 0x62, 0x02, 0xab, 0x9b,
+    0x54, 0x81, 0xbb, 0x0a, 0x36, 0xa0, 0xca, 0x29, 0x25, 0xa8, 0xbb, 0x48, 0x15, 0xa9, 0xba, 0x60,
+    0x03, 0xba, 0xaa, 0x72, 0x92, 0xb9, 0x8a, 0x54, 0x90, 0xaa, 0x1a, 0x35, 0xb0, 0xba, 0x4a, 0x25,
+    0xa9, 0xab, 0x69, 0x13, 0xaa, 0x9c, 0x51, 0x83, 0xba, 0x9b, 0x73, 0x92, 0xaa, 0x0b, 0x35, 0xa1,
+    0xbb, 0x2b, 0x37, 0xa8, 0xbb, 0x38, 0x17, 0xa8, 0xab, 0x50, 0x13, 0xab, 0x9c, 0x52, 0x02, 0xbb,
+    0x9b, 0x55, 0x91, 0xba, 0x89, 0x26, 0x90, 0xab, 0x3a, 0x26, 0xb8, 0xba, 0x58, 0x14, 0xaa, 0xba,
+    0x61, 0x02, 0xb9, 0x9b, 0x72, 0x92, 0xb9, 0x8a, 0x54, 0x90, 0xaa, 0x1a, 0x35, 0xa8, 0xab, 0x4a,
+    0x25, 0xa9, 0xab, 0x58, 0x04, 0xa9, 0xab, 0x71, 0x82, 0xaa, 0x9a, 0x44, 0x81, 0xab, 0x0b, 0x45,
+    0x90, 0xab, 0x1a, 0x27, 0xa8, 0xaa, 0x28, 0x17, 0xa9, 0x9a, 0x40, 0x03, 0xba, 0xab, 0x73, 0x82,
+    0xba, 0x9a, 0x45, 0x91, 0xab, 0x0a, 0x36, 0xa8, 0xba, 0x39, 0x26, 0xb8, 0xca, 0x30, 0x06, 0xa9,
+    0xaa, 0x61, 0x82, 0xb9, 0x9a, 0x63, 0x92, 0xba, 0x8a, 0x45, 0x90, 0xba, 0x2a, 0x26, 0xb0, 0xba,
+    0x49, 0x15, 0xb8, 0xaa, 0x58, 0x04, 0xb9, 0xaa, 0x62, 0x82, 0xaa, 0x8b, 0x73, 0x91, 0xaa, 0x0a,
+    0x35, 0xa0, 0xbb, 0x29, 0x27, 0xa8, 0xab, 0x48, 0x24, 0xaa, 0xbb, 0x61, 0x03, 0xba, 0xab, 0x73,
+    0x82, 0xba, 0x9a, 0x45, 0x91, 0xbb, 0x09, 0x36, 0xa8, 0xba, 0x39, 0x26, 0xb8, 0xab, 0x58, 0x14,
+    0xb9, 0xab, 0x71, 0x82, 0xb9, 0x9a, 0x63, 0x92, 0xba, 0x0a, 0x54, 0x90, 0xab, 0x2a, 0x26, 0xa8,
+    0xba, 0x38, 0x17, 0xa9, 0xaa, 0x50, 0x03, 0xaa, 0x9c, 0x52, 0x82, 0xba, 0x8b, 0x54, 0x81, 0xbb,
+    0x0a, 0x36, 0xa0, 0xbb, 0x29, 0x27, 0xa8, 0xab, 0x48, 0x24, 0xba, 0xba, 0x61, 0x03, 0xba, 0xab,
+    0x73, 0x82, 0xba, 0x0b, 0x54, 0xa1, 0xba, 0x19, 0x45, 0xa8, 0xba, 0x38, 0x16, 0xb8, 0xaa, 0x58,
+    0x04, 0xa9, 0xab, 0x62, 0x82, 0xaa, 0x8b, 0x63, 0x92, 0xab, 0x0b, 0x36, 0xa0, 0xba, 0x3b, 0x27,
+    0xa8, 0xab, 0x38, 0x17, 0xa9, 0xaa, 0x50, 0x03, 0xaa, 0x9c, 0x52, 0x82, 0xba, 0x8b, 0x45, 0x91,
+    0xbb, 0x09, 0x36, 0x98, 0xbb, 0x29, 0x27, 0x99, 0xab, 0x48, 0x14, 0xb9, 0xab, 0x71, 0x02, 0xba,
+    0x9a, 0x63, 0x92, 0xba, 0x8a, 0x45, 0x90, 0xba, 0x2a, 0x26, 0xa0, 0xbb, 0x49, 0x15, 0xb8, 0xba,
+    0x50, 0x04, 0xb9, 0xaa, 0x62, 0x82, 0xaa, 0x8b, 0x73, 0x91, 0xaa, 0x0a, 0x35, 0xa0, 0xbb, 0x29,
+    0x27, 0xa8, 0xab, 0x48, 0x15, 0xa9, 0xab, 0x50, 0x04, 0xaa, 0x9b, 0x53, 0x82, 0xbb, 0x8b, 0x36,
+    0x91, 0xcb, 0x09, 0x26, 0xa0, 0xba, 0x39, 0x26, 0xa9, 0xab, 0x58, 0x14, 0xaa, 0xab, 0x62, 0x02,
+    0xba, 0x9b, 0x73, 0x81, 0xaa, 0x0b, 0x35, 0xa1, 0xbb, 0x2a, 0x27, 0xb0, 0xba, 0x49, 0x15, 0xb8,
+    0xab, 0x60, 0x03, 0xaa, 0x8c, 0x51, 0x82, 0xba, 0x8b, 0x54, 0x91, 0xba, 0x1a, 0x35, 0xa0, 0xbb,
+    0x3a, 0x27, 0xa8, 0xbb, 0x58, 0x14, 0xa9, 0x9c, 0x41, 0x03, 0xbb, 0xab, 0x64, 0x81, 0xaa, 0x0b,
+    0x44, 0x91, 0xbb, 0x1a, 0x36, 0xa0, 0xac, 0x39, 0x25, 0xb8, 0xbb, 0x50, 0x14, 0xaa, 0xab, 0x71,
+    0x82, 0xb9, 0x9a, 0x63, 0x92, 0xba, 0x1b, 0x54, 0x90, 0xab, 0x2a, 0x26, 0xa8, 0xba, 0x38, 0x17,
+    0xa9, 0xaa, 0x50, 0x03, 0xba, 0x9b, 0x72, 0x82, 0xaa, 0x8b, 0x44, 0x92, 0xac, 0x1a, 0x35, 0xa0,
+    0xac, 0x29, 0x16, 0x98, 0xab, 0x48, 0x14, 0xb9, 0xab, 0x52, 0x84, 0xb9, 0x9b, 0x73, 0x81, 0xaa,
+    0x8a, 0x44, 0xa1, 0xba, 0x19, 0x26, 0xa0, 0xbb, 0x49, 0x15, 0xb8, 0xba, 0x50, 0x04, 0xb9, 0xaa,
+    0x62, 0x82, 0xc9, 0x8a, 0x53, 0x81, 0xbb, 0x1a, 0x35, 0xa1, 0xbc, 0x29, 0x26, 0xa8, 0xab, 0x48,
+    0x15, 0xb9, 0xaa, 0x50, 0x04, 0xaa, 0x9b, 0x62, 0x82, 0xba, 0x0b, 0x44, 0xa2, 0xbb, 0x1a, 0x27,
+    0xa0, 0xab, 0x39, 0x26, 0xa9, 0xab, 0x58, 0x14, 0xaa, 0xab, 0x52, 0x03, 0xbb, 0x9c, 0x44, 0x92,
+    0xca, 0x89, 0x44, 0x90, 0xba, 0x2a, 0x26, 0xb0, 0xba, 0x49, 0x15, 0xb8, 0xba, 0x60, 0x03, 0xba,
+    0xaa, 0x72, 0x82, 0xba, 0x8a, 0x44, 0x91, 0xba, 0x1b, 0x36, 0xa0, 0xbb, 0x3a, 0x27, 0xa8, 0xab,
+    0x48, 0x05, 0xb8, 0x9b, 0x51, 0x03, 0xca, 0x9a, 0x62, 0x82, 0xab, 0x0b, 0x44, 0x91, 0xbb, 0x1a,
+    0x27, 0xa0, 0xab, 0x39, 0x26, 0xa9, 0xbb, 0x50, 0x14, 0xaa, 0xab, 0x62, 0x02, 0xba, 0x9b, 0x54,
+    0x81, 0xbb, 0x0a, 0x45, 0x90, 0xbb, 0x29, 0x26, 0xb0, 0xba, 0x49, 0x15, 0xb8, 0xab, 0x51, 0x13,
+    0xca, 0x9b, 0x62, 0x82, 0xba, 0x8a, 0x54, 0x91, 0xab, 0x0a, 0x26, 0xa1, 0xbb, 0x29, 0x27, 0xa8,
+    0xab, 0x48, 0x14, 0xb9, 0xab, 0x61, 0x03, 0xba, 0x8c, 0x52, 0x82, 0xbb, 0x0b, 0x45, 0x91, 0xbb,
+    0x1a, 0x27, 0x98, 0xab, 0x39, 0x16, 0xa8, 0xab, 0x40, 0x14, 0xaa, 0x9c, 0x42, 0x03, 0xcb, 0x9a,
+    0x44, 0x92, 0xbb, 0x1b, 0x45, 0xa1, 0xbb, 0x3a, 0x36, 0xb8, 0xbb, 0x48, 0x16, 0xa9, 0xab, 0x51,
+    0x03, 0xba, 0x8c, 0x52, 0x82, 0xca, 0x0a, 0x53, 0x91, 0xbb, 0x1a, 0x36, 0xa0, 0xcb, 0x28, 0x25,
+    0xb8, 0xbb, 0x50, 0x14, 0xb9, 0xab, 0x61, 0x83, 0xba, 0x8b, 0x73, 0x81, 0xba, 0x0a, 0x35, 0xa1,
+    0xcb, 0x19, 0x26, 0x98, 0xbb, 0x38, 0x26, 0xa9, 0x9c, 0x40, 0x03, 0xc9, 0xaa, 0x62, 0x82, 0xba,
+    0x8a, 0x44, 0x81, 0xcb, 0x09, 0x44, 0xa0, 0xba, 0x29, 0x26, 0xa8, 0xbb, 0x40, 0x15, 0xb9, 0x9b,
+    0x60, 0x83, 0xb9, 0x9b, 0x63, 0x82, 0xbb, 0x0b, 0x45, 0x91, 0xbb, 0x1a, 0x36, 0xa0, 0xac, 0x39,
+    0x25, 0xa9, 0xbb, 0x50, 0x14, 0xaa, 0xab, 0x52, 0x03, 0xbb, 0x9c, 0x44, 0x82, 0xcb, 0x0a, 0x44,
+    0x90, 0xab, 0x2a, 0x26, 0xa0, 0xac, 0x38, 0x15, 0xb8, 0xab, 0x51, 0x13, 0xca, 0x9b, 0x62, 0x82,
+    0xba, 0x8a, 0x54, 0x91, 0xca, 0x19, 0x53, 0xa0, 0xab, 0x29, 0x26, 0xa8, 0xbb, 0x40, 0x15, 0xb9,
+    0xab, 0x52, 0x03, 0xca, 0x8b, 0x53, 0x82, 0xcb, 0x0a, 0x44, 0x91, 0xbb, 0x1a, 0x27, 0x98, 0xab,
+    0x39, 0x16, 0xa8, 0xab, 0x40, 0x05, 0xa9, 0xab, 0x62, 0x82, 0xaa, 0x8b, 0x73, 0x91, 0xaa, 0x0a,
+    0x35, 0x90, 0xac, 0x29, 0x25, 0xa8, 0xbb, 0x48, 0x15, 0xb8, 0xab, 0x60, 0x03, 0xba, 0x9b, 0x72,
+    0x82, 0xba, 0x8a, 0x44, 0x91, 0xbb, 0x1a, 0x36, 0xa0, 0xcb, 0x28, 0x25, 0xb8, 0xbb, 0x50, 0x14,
+    0xb9, 0xab, 0x61, 0x03, 0xca, 0x8a, 0x52, 0x82, 0xbb, 0x0b, 0x45, 0xa1, 0xbb, 0x29, 0x26, 0xa0,
+    0xac, 0x38, 0x25, 0xb9, 0xab, 0x50, 0x04, 0xb9, 0x9b, 0x62, 0x02, 0xbb, 0x8b, 0x45, 0x91, 0xba,
+    0x1b, 0x36, 0xa0, 0xbb, 0x29, 0x27, 0xa8, 0xbb, 0x40, 0x14, 0xb9, 0xab, 0x61, 0x03, 0xba, 0x8c,
+};
+
+const aud_clip_t audChime = {audChimeData, 6400, 8000, AUD_ADPCM};
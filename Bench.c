@@ -0,0 +1,55 @@
+/**
+ * \file        Bench.c
+ * \brief       Micro-benchmark harness for the driver hot paths
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stdio.h>
+#include "Bench.h"
+#include "Profile.h"
+#include "OutputStage.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "hardware/structs/sio.h"
+
+void bench_run(const bench_case_t *B, uint32_t calls, bench_result_t *R){
+    R->calls = calls;
+    R->min = UINT32_MAX;
+    R->max = 0;
+    R->sum = 0;
+    R->pins = 0;
+    for(uint32_t i = 0; i < calls; i++){
+        if(B->setup)
+            B->setup();
+        uint32_t irq = save_and_disable_interrupts();
+        uint32_t out = sio_hw->gpio_out;
+        uint32_t t0 = prof_cycles();
+        B->run();
+        uint32_t c = (t0 - prof_cycles()) & PROF_SYSTICK_MASK;     ///< SysTick counts down
+        out_commit();                                               ///< Apply the outputs posted by the call
+        out ^= sio_hw->gpio_out;
+        restore_interrupts(irq);
+        c = c > profiler.overhead ? c - profiler.overhead : 0;
+        if(c < R->min) R->min = c;
+        if(c > R->max) R->max = c;
+        R->sum += c;
+        R->pins += __builtin_popcount(out);
+    }
+}
+
+void bench_suite(const bench_case_t *cases, uint8_t numCases, uint32_t calls){
+    uint32_t hz = clock_get_hz(clk_sys);
+    printf("{\"bench\":\"wuClock\",\"clk_hz\":%lu,\"calls\":%lu,\"results\":[", (unsigned long)hz, (unsigned long)calls);
+    for(uint8_t i = 0; i < numCases; i++){
+        bench_result_t R;
+        bench_run(&cases[i], calls, &R);
+        uint32_t mean = (uint32_t)(R.sum / calls);
+        printf("%s{\"name\":\"%s\",\"min\":%lu,\"mean\":%lu,\"max\":%lu,\"ns\":%lu,\"pins\":%lu}", i ? "," : "", cases[i].name,
+            (unsigned long)R.min, (unsigned long)mean, (unsigned long)R.max,
+            (unsigned long)(R.sum * 1000000000ull / ((uint64_t)calls * hz)), (unsigned long)R.pins);
+    }
+    printf("]}\n");
+}
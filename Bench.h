@@ -0,0 +1,57 @@
+/**
+ * \file        Bench.h
+ * \brief       Micro-benchmark harness for the driver hot paths
+ * \details     Every call of a benchmark case is timed alone with the SysTick counter (see Profile.h)
+ * with the interrupts disabled, after an optional setup that is not timed (for example to make a
+ * time base due). The outputs posted by the call are committed after the timed region and the
+ * number of pins that changed is counted from the SIO output register. bench_suite prints the results of a table of cases as one JSON line:
+ *
+ *      {"bench":"wuClock","clk_hz":<hz>,"calls":<n>,"results":[{"name":<case>,"min":<cycles>,
+ *       "mean":<cycles>,"max":<cycles>,"ns":<mean ns>,"pins":<pin changes>}, ...]}
+ *
+ * tools/wubench.py runs the suite over USB and compares the results with a baseline file.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __BENCH_H_
+#define __BENCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * \brief Benchmark case, the functions work on application globals
+ */
+typedef struct{
+    const char *name;           ///< Case name, a JSON identifier
+    void (*setup)(void);        ///< Called before every timed call, NULL if not needed
+    void (*run)(void);          ///< Code under test
+} bench_case_t;
+
+typedef struct{
+    uint32_t calls;             ///< Timed calls
+    uint32_t min;               ///< Minimum cycles per call
+    uint32_t max;               ///< Maximum cycles per call
+    uint64_t sum;               ///< Total cycles
+    uint32_t pins;              ///< Output pin changes in all the calls
+} bench_result_t;
+
+/**
+ * \fn void bench_run(const bench_case_t *B, uint32_t calls, bench_result_t *R)
+ * \brief Time calls of one benchmark case
+ * \param B     Benchmark case
+ * \param calls Number of timed calls
+ * \param R     Pointer to the results
+ */
+void bench_run(const bench_case_t *B, uint32_t calls, bench_result_t *R);
+
+/**
+ * \fn void bench_suite(const bench_case_t *cases, uint8_t numCases, uint32_t calls)
+ * \brief Run a table of benchmark cases and print the results as one JSON line
+ */
+void bench_suite(const bench_case_t *cases, uint8_t numCases, uint32_t calls);
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * \file        Calendar.c
+ * \brief       Calendar arithmetic on datetime_t values
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "Calendar.h"
+
+static const uint8_t CAL_MONTH_DAYS[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
+
+static inline uint8_t cal_dotw_from_days(int64_t days){
+    return (uint8_t)((((days + 4) % 7) + 7) % 7);                       // 01/01/1970 was Thursday
+}
+
+uint8_t cal_days_in_month(int16_t year, int8_t month){
+    if(month == 2 && cal_is_leap(year))
+        return 29;
+    return CAL_MONTH_DAYS[month - 1];
+}
+
+bool cal_is_valid(const datetime_t *dt){
+    if(dt->year < 0 || dt->year > CAL_YEAR_MAX) return false;
+    if(dt->month < 1 || dt->month > 12) return false;
+    if(dt->day < 1 || dt->day > cal_days_in_month(dt->year, dt->month)) return false;
+    if(dt->hour < 0 || dt->hour > 23) return false;
+    if(dt->min < 0 || dt->min > 59) return false;
+    if(dt->sec < 0 || dt->sec > 59) return false;
+    return true;
+}
+
+// Days from civil algorithm: years are shifted to start in March so the leap day is the last day of the year
+int64_t cal_days_from_civil(int16_t year, int8_t month, int8_t day){
+    int32_t y = year - (month <= 2);
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);                              // [0, 399]
+    uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // [0, 365]
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                  // [0, 146096]
+    return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+uint8_t cal_dotw(int16_t year, int8_t month, int8_t day){
+    return cal_dotw_from_days(cal_days_from_civil(year, month, day));
+}
+
+int8_t cal_nth_dotw(int16_t year, int8_t month, int8_t n, uint8_t dotw){
+    uint8_t last = cal_days_in_month(year, month);
+    if(n < 0)
+        return last - (cal_dotw(year, month, last) - dotw + 7) % 7;
+    int8_t day = 1 + (dotw - cal_dotw(year, month, 1) + 7) % 7 + (n - 1) * 7;
+    return day <= last ? day : -1;
+}
+
+int64_t cal_to_epoch(const datetime_t *dt){
+    return cal_days_from_civil(dt->year, dt->month, dt->day) * CAL_SECS_PER_DAY
+         + dt->hour * 3600 + dt->min * 60 + dt->sec;
+}
+
+void cal_from_epoch(int64_t epoch, datetime_t *dt){
+    int64_t days = epoch / CAL_SECS_PER_DAY;
+    int32_t secs = (int32_t)(epoch % CAL_SECS_PER_DAY);
+    if(secs < 0){
+        secs += CAL_SECS_PER_DAY;
+        days -= 1;
+    }
+    dt->hour = secs / 3600;
+    dt->min = (secs / 60) % 60;
+    dt->sec = secs % 60;
+    dt->dotw = cal_dotw_from_days(days);
+
+    // Civil from days, inverse of cal_days_from_civil
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    uint32_t doe = (uint32_t)(z - era * 146097);                           // [0, 146096]
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+    uint32_t mp = (5 * doy + 2) / 153;                                     // [0, 11]
+    dt->day = doy - (153 * mp + 2) / 5 + 1;
+    dt->month = mp < 10 ? mp + 3 : mp - 9;
+    dt->year = (int16_t)(yoe + era * 400 + (dt->month <= 2));
+}
@@ -0,0 +1,93 @@
+/**
+ * \file        Calendar.h
+ * \brief       Calendar arithmetic on datetime_t values (leap years, month lengths, epoch conversion)
+ * \details     Pure functions without hardware access. Time4H.h can only be included by one translation
+ * unit, so modules that need date arithmetic include this header instead.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __CALENDAR_H_
+#define __CALENDAR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/types.h"
+
+#define CAL_SECS_PER_DAY 86400          ///< Seconds in one civil day
+#define CAL_YEAR_MAX 4095               ///< Last year supported by the RTC datetime_t
+
+/**
+ * \fn static inline bool cal_is_leap(int16_t year)
+ * \brief Return true when year is a leap year in the gregorian calendar
+ * \param year Year (0-4095)
+ */
+static inline bool cal_is_leap(int16_t year){
+    return (!(year % 4) && (year % 100)) || !(year % 400);
+}
+
+/**
+ * \fn uint8_t cal_days_in_month(int16_t year, int8_t month)
+ * \brief Return the number of days of a month
+ * \param year Year (0-4095)
+ * \param month Month of the year (1-12)
+ * \returns Number of days (28-31)
+ */
+uint8_t cal_days_in_month(int16_t year, int8_t month);
+
+/**
+ * \fn bool cal_is_valid(const datetime_t *dt)
+ * \brief Check that every field of a datetime is in range, including the day against month and year
+ * \param dt Pointer to the datetime to validate
+ * \returns true if the datetime exists in the calendar
+ */
+bool cal_is_valid(const datetime_t *dt);
+
+/**
+ * \fn int64_t cal_days_from_civil(int16_t year, int8_t month, int8_t day)
+ * \brief Number of days between 01/01/1970 and the given date (negative before 1970)
+ */
+int64_t cal_days_from_civil(int16_t year, int8_t month, int8_t day);
+
+/**
+ * \fn uint8_t cal_dotw(int16_t year, int8_t month, int8_t day)
+ * \brief Compute the day of the week of a date
+ * \returns Day of the week (0-6, where 0 is Sunday)
+ */
+uint8_t cal_dotw(int16_t year, int8_t month, int8_t day);
+
+/**
+ * \fn int8_t cal_nth_dotw(int16_t year, int8_t month, int8_t n, uint8_t dotw)
+ * \brief Day of the month of the nth day of the week of a month, e.g. the second Sunday of March
+ * \param n Occurrence 1-5, -1 for the last one
+ * \param dotw Day of the week (0-6, where 0 is Sunday)
+ * \returns Day of the month, -1 if the month has no such occurrence
+ */
+int8_t cal_nth_dotw(int16_t year, int8_t month, int8_t n, uint8_t dotw);
+
+/**
+ * \fn int64_t cal_to_epoch(const datetime_t *dt)
+ * \brief Convert a datetime to seconds since 01/01/1970 00:00:00
+ * \param dt Pointer to the datetime, dotw is ignored
+ */
+int64_t cal_to_epoch(const datetime_t *dt);
+
+/**
+ * \fn void cal_from_epoch(int64_t epoch, datetime_t *dt)
+ * \brief Convert seconds since 01/01/1970 00:00:00 to a datetime, dotw included
+ * \param epoch Seconds since epoch
+ * \param dt Pointer to the datetime where the result is stored
+ */
+void cal_from_epoch(int64_t epoch, datetime_t *dt);
+
+/**
+ * \fn static inline void cal_add_seconds(datetime_t *dt, int32_t secs)
+ * \brief Add (or subtract) seconds to a datetime with full carry through minutes, days, months and years
+ */
+static inline void cal_add_seconds(datetime_t *dt, int32_t secs){
+    cal_from_epoch(cal_to_epoch(dt) + secs, dt);
+}
+
+#endif
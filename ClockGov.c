@@ -0,0 +1,141 @@
+/**
+ * \file        ClockGov.c
+ * \brief       System clock governor: clk_sys follows the workload
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "ClockGov.h"
+#include "Pattern.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+cg_gov_t cgGov = {.level = CG_ACTIVE, .forced = CG_AUTO};
+
+const cg_setting_t cgSettings[CG_NUM_LEVELS] = {
+    {24000, 840000000, 7, 5, "IDLE"},
+    {48000, 768000000, 4, 4, "USB"},
+    {125000, 1500000000, 6, 2, "ACTIVE"},      ///< Boot clock of the SDK
+};
+
+/**
+ * \fn static uint32_t cg_scale_level(uint32_t level, uint32_t from, uint32_t to)
+ * \brief Compare level for the same duty cycle with another wrap, from and to are wrap + 1
+ */
+static uint32_t cg_scale_level(uint32_t level, uint32_t from, uint32_t to){
+    uint32_t l = ((uint64_t)level * to + from / 2) / from;
+    return l > 0xFFFF ? 0xFFFF : l;
+}
+
+/**
+ * \fn static void cg_pwm_rescale(uint32_t fromHz, uint32_t toHz)
+ * \brief Keep the period and the duty cycles of the enabled PWM slices across a clk_sys change
+ * \details The divider is the smallest one that fits the period in a 16 bit wrap, as buzzer_tone
+ * does, so the wrap keeps the most resolution.
+ */
+static void cg_pwm_rescale(uint32_t fromHz, uint32_t toHz){
+    for(uint8_t s = 0; s < NUM_PWM_SLICES; s++){
+        if(!(pwm_hw->en & (1u << s)))
+            continue;
+        pwm_slice_hw_t *S = &pwm_hw->slice[s];
+        uint32_t div16 = S->div ? S->div : 0x1000;              ///< INT.FRAC with 4 fraction bits, INT 0 is 256
+        uint32_t top = S->top + 1;
+        uint64_t period16 = ((uint64_t)div16 * top * toHz + fromHz / 2) / fromHz;  ///< Period in 1/16 clk_sys cycles
+        uint32_t newDiv16 = (period16 + 0xFFFF) >> 16;
+        if(newDiv16 < 16)
+            newDiv16 = 16;
+        if(newDiv16 > 0xFFF)
+            newDiv16 = 0xFFF;
+        uint32_t newTop = (period16 + newDiv16 / 2) / newDiv16;
+        if(newTop > 0x10000)
+            newTop = 0x10000;
+        if(newTop < 1)
+            newTop = 1;
+        uint32_t cc = S->cc;
+        S->div = newDiv16;
+        S->top = newTop - 1;
+        S->cc = cg_scale_level(cc & 0xFFFF, top, newTop) | cg_scale_level(cc >> 16, top, newTop) << 16;
+    }
+}
+
+/**
+ * \fn static void cg_set(cg_gov_t *G, uint8_t level)
+ * \brief Switch clk_sys to a level and rescale the PWM slices
+ * \details Interrupts are off and core1 is kept out of the pattern player, so no tone or LED
+ * effect step is programmed between the switch and the rescale.
+ */
+static void cg_set(cg_gov_t *G, uint8_t level){
+    if(level == G->level)
+        return;
+    const cg_setting_t *L = &cgSettings[level];
+    uint64_t now = time_us_64();
+    uint32_t lock = pat_lock();
+    uint32_t save = save_and_disable_interrupts();
+    uint32_t fromHz = clock_get_hz(clk_sys);
+    set_sys_clock_pll(L->vcoHz, L->postDiv1, L->postDiv2);     ///< clk_ref stays on the crystal, the timer does not move
+    cg_pwm_rescale(fromHz, clock_get_hz(clk_sys));
+    restore_interrupts(save);
+    pat_unlock(lock);
+
+    uint32_t us = time_us_64() - now;
+    if(us > G->switchMaxUs)
+        G->switchMaxUs = us;
+    G->residency[G->level] += now - G->since;
+    G->since = now;
+    if(level > G->level)
+        G->ups++;
+    else
+        G->downs++;
+    G->level = level;
+}
+
+void cg_init(cg_gov_t *G){
+    gpio_init(CG_VBUS_GPIO);
+    gpio_set_dir(CG_VBUS_GPIO, GPIO_IN);
+    G->level = CG_ACTIVE;
+    G->forced = CG_AUTO;
+    G->holdEnd = time_us_64() + CG_HOLD_US;     ///< The console is opened right after the boot
+    cg_clear(G);
+}
+
+void cg_boost(cg_gov_t *G, uint8_t source){
+    G->holdEnd = time_us_64() + CG_HOLD_US;
+    if(G->forced != CG_AUTO || G->level == CG_ACTIVE)
+        return;
+    G->boosts[__builtin_ctz(source)]++;
+    cg_set(G, CG_ACTIVE);
+}
+
+void cg_process(cg_gov_t *G, uint8_t sources){
+    if(G->forced != CG_AUTO)
+        return;
+    uint64_t now = time_us_64();
+    if(sources){
+        if(G->level != CG_ACTIVE)
+            G->boosts[__builtin_ctz(sources)]++;
+        G->holdEnd = now + CG_HOLD_US;
+    }
+    uint8_t level = now < G->holdEnd ? CG_ACTIVE : gpio_get(CG_VBUS_GPIO) ? CG_USB : CG_IDLE;
+    cg_set(G, level);
+}
+
+void cg_force(cg_gov_t *G, uint8_t level){
+    G->forced = level;
+    if(level != CG_AUTO)
+        cg_set(G, level);
+}
+
+void cg_clear(cg_gov_t *G){
+    memset(G->residency, 0, sizeof(G->residency));
+    memset(G->boosts, 0, sizeof(G->boosts));
+    G->ups = 0;
+    G->downs = 0;
+    G->switchMaxUs = 0;
+    G->since = time_us_64();
+}
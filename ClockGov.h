@@ -0,0 +1,134 @@
+/**
+ * \file        ClockGov.h
+ * \brief       System clock governor: clk_sys follows the workload
+ * \details     Showing the time needs a small fraction of 125 MHz. The governor runs clk_sys at one
+ * of three levels: IDLE (24 MHz) in normal operation, USB (48 MHz) while VBUS is present, so the
+ * USB device and the console keep running at the speed of the USB clock, and ACTIVE (125 MHz, the boot
+ * clock) during audio playback, flash writes and console activity. The levels use the lowest VCO
+ * that gives them, the PLL draws less at a lower VCO.
+ *
+ * cg_boost raises the clock at once, before a driver programs anything from clock_get_hz, and the
+ * clock stays up CG_HOLD_US after the last boost. cg_process, called every pass with the sources
+ * active in it, renews the hold and lowers the clock when it ends. A source that depends on
+ * clk_sys while it runs (a clip: DMA pacing timer and PWM carrier) is passed every pass, so the
+ * clock never changes under it.
+ *
+ * The time bases do not move: the timer counts the 1 MHz tick of clk_ref, which stays on the
+ * crystal, and the RTC, the ADC and the USB have their own clocks from PLL_USB. The PWM slices
+ * count clk_sys, a switch rescales the divider, wrap and levels of every enabled slice so the
+ * periods and duty cycles are kept (within one count of the slower clock). SysTick cycles
+ * (PROF, BENCH, DISP) are still cycles, their time scales with the level.
+ *
+ * The current of every level is estimated from a linear model of the board at 5 V plus the load
+ * of the display and the LEDs given by the caller; the CLK command shows it against the 1 W of
+ * RNF04 (buzzer excluded).
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __CLOCK_GOV_H_
+#define __CLOCK_GOV_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CG_HOLD_US 2000000          ///< Time at ACTIVE after the last boost
+#define CG_VBUS_GPIO 24             ///< VBUS sense of the Pico board
+#define CG_AUTO 0xFF                ///< forced value when the governor chooses the level
+
+#define CG_BOARD_UA 5000            ///< Board current at 5 V without clk_sys: regulator, flash, crystal, PLL_USB
+#define CG_UA_PER_MHZ 160           ///< Board current at 5 V per MHz of clk_sys, cores and bus
+#define CG_SUPPLY_MV 5000           ///< Supply voltage of the estimate
+#define CG_RNF04_MW 1000            ///< Power limit in normal operation, buzzer excluded
+
+/// Clock levels, slowest first
+typedef enum{
+    CG_IDLE = 0,                ///< Normal operation without USB
+    CG_USB,                     ///< VBUS present
+    CG_ACTIVE,                  ///< Boot clock, audio, flash writes and console activity
+    CG_NUM_LEVELS
+} cg_level_t;
+
+/// Sources of cg_boost and cg_process
+#define CG_AUDIO   (1u << 0)    ///< A clip is playing
+#define CG_FLASH   (1u << 1)    ///< A flash write
+#define CG_CONSOLE (1u << 2)    ///< Console input or output pending
+
+typedef struct{
+    uint32_t khz;               ///< clk_sys
+    uint32_t vcoHz;             ///< PLL_SYS VCO
+    uint8_t postDiv1;           ///< PLL_SYS first post divider
+    uint8_t postDiv2;           ///< PLL_SYS second post divider
+    const char *name;           ///< Name shown by CLK
+} cg_setting_t;
+
+typedef struct{
+    uint8_t level;              ///< Level running, cg_level_t
+    uint8_t forced;             ///< Level set with cg_force, CG_AUTO
+    uint64_t holdEnd;           ///< End of the ACTIVE hold, time_us_64
+    uint64_t since;             ///< Start of the current level, time_us_64
+    uint64_t residency[CG_NUM_LEVELS];  ///< Time spent at every level in us, the current period excluded
+    uint32_t ups;               ///< Switches to a faster level
+    uint32_t downs;             ///< Switches to a slower level
+    uint32_t boosts[3];         ///< Raises of the clock by audio, flash and console
+    uint32_t switchMaxUs;       ///< Longest switch, PLL lock and PWM rescale
+} cg_gov_t;
+
+extern cg_gov_t cgGov;          ///< clk_sys level and its residency
+extern const cg_setting_t cgSettings[CG_NUM_LEVELS];    ///< PLL settings of the levels
+
+/**
+ * \fn void cg_init(cg_gov_t *G)
+ * \brief Start at ACTIVE, the boot clock, with the VBUS sense as input
+ */
+void cg_init(cg_gov_t *G);
+
+/**
+ * \fn void cg_boost(cg_gov_t *G, uint8_t source)
+ * \brief Raise the clock to ACTIVE now and hold it CG_HOLD_US, call before programming from clk_sys
+ * \param G         Pointer to the governor
+ * \param source    One CG_AUDIO, CG_FLASH or CG_CONSOLE bit
+ */
+void cg_boost(cg_gov_t *G, uint8_t source);
+
+/**
+ * \fn void cg_process(cg_gov_t *G, uint8_t sources)
+ * \brief Call this method in the main loop: renew the hold for the active sources and move to the level due
+ * \param G         Pointer to the governor
+ * \param sources   CG_* bits of the sources active in this pass
+ */
+void cg_process(cg_gov_t *G, uint8_t sources);
+
+/**
+ * \fn void cg_force(cg_gov_t *G, uint8_t level)
+ * \brief Run at a fixed level to measure its current, CG_AUTO gives the level back to the governor
+ */
+void cg_force(cg_gov_t *G, uint8_t level);
+
+/**
+ * \fn void cg_clear(cg_gov_t *G)
+ * \brief Clear the residency and the switch counters
+ */
+void cg_clear(cg_gov_t *G);
+
+/**
+ * \fn static inline uint32_t cg_estimate_ua(uint8_t level, uint32_t loadUa)
+ * \brief Estimated supply current at a level in uA
+ * \param level     cg_level_t
+ * \param loadUa    Current of the display and the LEDs
+ */
+static inline uint32_t cg_estimate_ua(uint8_t level, uint32_t loadUa){
+    return CG_BOARD_UA + cgSettings[level].khz / 1000 * CG_UA_PER_MHZ + loadUa;
+}
+
+/**
+ * \fn static inline uint32_t cg_estimate_mw(uint8_t level, uint32_t loadUa)
+ * \brief Estimated power at a level in mW
+ */
+static inline uint32_t cg_estimate_mw(uint8_t level, uint32_t loadUa){
+    return (uint64_t)cg_estimate_ua(level, loadUa) * CG_SUPPLY_MV / 1000000;
+}
+
+#endif
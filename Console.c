@@ -0,0 +1,178 @@
+/**
+ * \file        Console.c
+ * \brief       Non-blocking line oriented command console over the USB CDC stdio
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.2
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "Console.h"
+
+static console_t *conOut = NULL;   ///< Console used by con_printf
+
+void con_init(console_t *C, const con_cmd_t *cmds, uint8_t numCmds){
+    C->rxHead = C->rxTail = 0;
+    C->eolHead = C->eolTail = 0;
+    C->txHead = C->txTail = 0;
+    C->txDropped = 0;
+    C->len = 0;
+    C->overflow = false;
+    C->line[0] = '\0';
+    C->lineTime = 0;
+    C->cmds = cmds;
+    C->numCmds = numCmds;
+    C->helpNext = numCmds;
+    conOut = C;
+}
+
+bool con_write(console_t *C, const char *s, uint16_t len){
+    uint16_t space = CON_TX_SIZE - 1 - con_tx_pending(C);
+    if(len > space){
+        C->txDropped++;
+        return false;
+    }
+    for(uint16_t i = 0; i < len; i++){
+        C->tx[C->txHead] = s[i];
+        C->txHead = (C->txHead + 1) & (CON_TX_SIZE - 1);
+    }
+    return true;
+}
+
+void con_flush(console_t *C){
+    while(C->txTail != C->txHead && stdio_usb_connected()){
+        putchar_raw(C->tx[C->txTail]);
+        C->txTail = (C->txTail + 1) & (CON_TX_SIZE - 1);
+    }
+    stdio_flush();
+}
+
+bool con_printf(const char *fmt, ...){
+    if(!conOut)
+        return false;
+    char msg[CON_MSG_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(msg, sizeof(msg), fmt, args);
+    va_end(args);
+    if(n < 0)
+        return false;
+    if(n >= (int)sizeof(msg))
+        n = sizeof(msg) - 1;                                ///< Truncated message
+    return con_write(conOut, msg, (uint16_t)n);
+}
+
+/**
+ * \brief Split the line in place on spaces, upper case the command name
+ * \returns Number of tokens
+ */
+static int con_tokenize(char *line, char *argv[]){
+    int argc = 0;
+    char *p = line;
+    while(*p && argc < CON_MAX_ARGS){
+        while(*p == ' ' || *p == '\t') *p++ = '\0';
+        if(!*p) break;
+        argv[argc++] = p;
+        while(*p && *p != ' ' && *p != '\t') p++;
+    }
+    *p = '\0';                                              ///< Tokens beyond CON_MAX_ARGS are ignored
+    if(argc){
+        for(char *q = argv[0]; *q; q++)
+            if(*q >= 'a' && *q <= 'z') *q -= 'a' - 'A';
+    }
+    return argc;
+}
+
+static void con_dispatch(console_t *C){
+    char *argv[CON_MAX_ARGS];
+    int argc = con_tokenize(C->line, argv);
+    if(!argc)
+        return;
+    if(!strcmp(argv[0], "HELP")){
+        C->helpNext = 0;                                    ///< Paged by con_help
+        return;
+    }
+    for(uint8_t i = 0; i < C->numCmds; i++){
+        if(!strcmp(argv[0], C->cmds[i].name)){
+            C->cmds[i].handler(C, argc, argv);
+            return;
+        }
+    }
+    con_printf("ERR unknown command, try HELP\n");
+}
+
+/**
+ * \brief Queue the next usage line of HELP when it fits in the TX queue
+ */
+static void con_help(console_t *C){
+    if(C->helpNext >= C->numCmds)
+        return;
+    const char *help = C->cmds[C->helpNext].help;
+    uint16_t len = strlen(help);
+    if(len + 1 > CON_TX_SIZE - 1 - con_tx_pending(C))
+        return;                                             ///< Wait until the USB takes the previous lines
+    con_write(C, help, len);
+    con_write(C, "\n", 1);
+    C->helpNext++;
+}
+
+void con_process(console_t *C){
+    // Receive: move pending characters from the USB to the RX ring
+    for(int i = 0; i < CON_RX_BUDGET; i++){
+        uint16_t next = (C->rxHead + 1) & (CON_RX_SIZE - 1);
+        if(next == C->rxTail)                               ///< RX ring full, leave the rest in the USB buffer
+            break;
+        uint8_t eolNext = (C->eolHead + 1) & (CON_EOL_SIZE - 1);
+        if(eolNext == C->eolTail)                           ///< No room to stamp a terminator
+            break;
+        int c = getchar_timeout_us(0);
+        if(c == PICO_ERROR_TIMEOUT)
+            break;
+        if(c == '\r' || c == '\n'){
+            C->eol[C->eolHead] = time_us_64();              ///< Arrival of the line, t4 of SYNC
+            C->eolHead = eolNext;
+        }
+        C->rx[C->rxHead] = (uint8_t)c;
+        C->rxHead = next;
+    }
+
+    // Parse: assemble characters until one line is complete, dispatch at most one line per call
+    while(C->rxTail != C->rxHead){
+        char c = (char)C->rx[C->rxTail];
+        C->rxTail = (C->rxTail + 1) & (CON_RX_SIZE - 1);
+        if(c == '\r' || c == '\n'){
+            uint64_t eol = C->eol[C->eolTail];
+            C->eolTail = (C->eolTail + 1) & (CON_EOL_SIZE - 1);
+            if(C->len == 0 && !C->overflow)                 ///< Ignore empty lines and the LF of a CR LF pair
+                continue;
+            bool ok = !C->overflow;
+            C->line[C->len] = '\0';
+            C->len = 0;
+            C->overflow = false;
+            if(ok){
+                C->lineTime = eol;
+                con_dispatch(C);
+                break;
+            }
+        }
+        else if(C->len < CON_LINE_MAX - 1){
+            C->line[C->len++] = c;
+        }
+        else{
+            C->overflow = true;
+        }
+    }
+
+    con_help(C);
+
+    // Transmit: drain a bounded number of characters, nothing is sent while the host is not attached
+    if(C->txTail != C->txHead && stdio_usb_connected()){
+        for(int i = 0; i < CON_TX_BUDGET && C->txTail != C->txHead; i++){
+            putchar_raw(C->tx[C->txTail]);
+            C->txTail = (C->txTail + 1) & (CON_TX_SIZE - 1);
+        }
+    }
+}
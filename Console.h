@@ -0,0 +1,116 @@
+/**
+ * \file        Console.h
+ * \brief       Non-blocking line oriented command console over the USB CDC stdio
+ * \details     Every call to con_process does a bounded amount of work so the console can live in the
+ * superloop next to the display multiplexing:
+ * - at most CON_RX_BUDGET characters are read with getchar_timeout_us(0) into the RX ring buffer,
+ *   each terminator is stamped as it is read, so lineTime does not include the parsing lag,
+ * - at most one complete line is tokenized in place and dispatched to the command table,
+ * - at most CON_TX_BUDGET characters are moved from the TX queue to the USB.
+ *
+ * Output is queued with con_printf, which never waits: a message that does not fit in the TX queue
+ * is dropped whole and counted in txDropped. No heap memory is used. HELP is longer than the TX
+ * queue, so it is paged: one usage line per call once the line fits in the free space.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.2
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __CONSOLE_H_
+#define __CONSOLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+#define CON_RX_SIZE 128         ///< RX ring buffer size, power of two
+#define CON_TX_SIZE 512         ///< TX queue size, power of two
+#define CON_LINE_MAX 64         ///< Maximum line length including the terminator
+#define CON_MAX_ARGS 6          ///< Maximum number of tokens in a command line
+#define CON_RX_BUDGET 16        ///< Maximum characters read from the USB in one call to con_process
+#define CON_TX_BUDGET 16        ///< Maximum characters written to the USB in one call to con_process
+#define CON_MSG_MAX 96          ///< Maximum length of one con_printf message
+#define CON_EOL_SIZE 8          ///< Arrival times of terminators waiting in rx, power of two
+
+typedef struct console_s console_t;
+
+/**
+ * \brief Command table entry
+ */
+typedef struct{
+    const char *name;                                       ///< Command name in upper case
+    void (*handler)(console_t *C, int argc, char *argv[]);  ///< argv[0] is the command name
+    const char *help;                                       ///< One line usage shown by HELP
+} con_cmd_t;
+
+struct console_s{
+    uint8_t rx[CON_RX_SIZE];    ///< RX ring buffer
+    uint16_t rxHead;            ///< Next position to write in rx
+    uint16_t rxTail;            ///< Next position to read from rx
+    uint64_t eol[CON_EOL_SIZE]; ///< time_us_64 when each terminator in rx was read from the USB
+    uint8_t eolHead;            ///< Next position to write in eol
+    uint8_t eolTail;            ///< Next position to read from eol
+    char tx[CON_TX_SIZE];       ///< TX queue
+    uint16_t txHead;            ///< Next position to write in tx
+    uint16_t txTail;            ///< Next position to send from tx
+    uint32_t txDropped;         ///< Messages dropped because the TX queue was full
+    char line[CON_LINE_MAX];    ///< Line being assembled
+    uint8_t len;                ///< Number of characters in line
+    bool overflow;              ///< true when the current line exceeded CON_LINE_MAX and will be dropped
+    uint64_t lineTime;          ///< time_us_64 when the terminator of the dispatched line was read from the USB
+    const con_cmd_t *cmds;      ///< Command table
+    uint8_t numCmds;            ///< Number of entries in the command table
+    uint8_t helpNext;           ///< Next command of HELP to print, numCmds when HELP is done
+};
+
+/**
+ * \fn void con_init(console_t *C, const con_cmd_t *cmds, uint8_t numCmds)
+ * \brief Initialize the console and make it the destination of con_printf
+ * \param C         Pointer to console data structure
+ * \param cmds      Command table, HELP is built in
+ * \param numCmds   Number of entries in the command table
+ */
+void con_init(console_t *C, const con_cmd_t *cmds, uint8_t numCmds);
+
+/**
+ * \fn void con_process(console_t *C)
+ * \brief Call this method in the main loop to receive, dispatch and transmit with bounded cost
+ * \param C Pointer to console data structure
+ */
+void con_process(console_t *C);
+
+/**
+ * \fn bool con_write(console_t *C, const char *s, uint16_t len)
+ * \brief Queue raw characters for transmission
+ * \param C     Pointer to console data structure
+ * \param s     Characters to send
+ * \param len   Number of characters
+ * \returns false if the message did not fit and was dropped
+ */
+bool con_write(console_t *C, const char *s, uint16_t len);
+
+/**
+ * \fn void con_flush(console_t *C)
+ * \brief Send the whole TX queue, waiting for the USB. Only for commands that print directly with printf.
+ * \param C Pointer to console data structure
+ */
+void con_flush(console_t *C);
+
+/**
+ * \fn bool con_printf(const char *fmt, ...)
+ * \brief Format a message (at most CON_MSG_MAX characters) into the TX queue of the console given to con_init
+ * \returns false if the message was dropped
+ */
+bool con_printf(const char *fmt, ...);
+
+/**
+ * \fn static inline uint16_t con_tx_pending(console_t *C)
+ * \brief Number of characters waiting in the TX queue
+ * \param C Pointer to console data structure
+ */
+static inline uint16_t con_tx_pending(console_t *C){
+    return (uint16_t)(C->txHead - C->txTail) & (CON_TX_SIZE - 1);
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * \file        Coroutine.h
+ * \brief       Stackless coroutines (protothreads) for the driver state machines
+ * \details     A driver thread is a plain C function written top to bottom with waits in it. The
+ * waits store the line to resume in the co_t and return, a switch on that line at the start of
+ * the function (Duff's device) jumps back to it at the next call. Locals do not survive a wait,
+ * the state lives in the driver structure. A co_t is 16 bytes, one thread replaces a state
+ * function pointer and the time bases of its states.
+ *
+ * Every wait leaves its wake condition in the co_t: a deadline of the time base clock (tb_now, the
+ * virtual clock in WUCLOCK_REPLAY builds, where the deadline is reported to the replay engine like
+ * a time base) and optionally an input whose rising edge ends the wait earlier. The caller resumes
+ * the thread only when co_ready is true, so a waiting thread costs a compare and, for an edge, a
+ * read of the raw interrupt latch of the pin. Edges are latched by IO_BANK0 without enabling the
+ * GPIO interrupt. CO_AWAIT polls a condition at every resume and is left for levels.
+ *
+ *      void thread(drv_t *D){
+ *          CO_BEGIN(&D->co);
+ *          while(true){
+ *              CO_AWAIT_EDGE(&D->co, D->gpio, CO_FOREVER);
+ *              CO_AWAIT_UNTIL(&D->co, tb_now() + 20000);
+ *          }
+ *          CO_END(&D->co);
+ *      }
+ *
+ * Two waits must not share a source line, a switch statement cannot hold a wait.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __COROUTINE_H_
+#define __COROUTINE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TimeBase.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/iobank0.h"
+
+#define CO_FOREVER UINT64_MAX       ///< Deadline of a wait without timeout
+#define CO_NO_GPIO 0xFF             ///< No edge ends the wait
+
+typedef struct{
+    uint16_t lc;                ///< Line to resume, 0 at the start of the thread
+    uint8_t gpio;               ///< Input whose rising edge ends the wait, CO_NO_GPIO
+    bool edge;                  ///< The last CO_AWAIT_EDGE ended with an edge, not at its deadline
+    uint64_t wake;              ///< Deadline of the wait, 0 to resume at every call
+} co_t;
+
+/**
+ * \fn static inline uint32_t co_gpio_peek(uint8_t gpio)
+ * \brief Raw rising edge latch of an input, set with the GPIO interrupt disabled
+ */
+static inline uint32_t co_gpio_peek(uint8_t gpio){
+    return (io_bank0_hw->intr[gpio >> 3] >> (4 * (gpio & 7))) & GPIO_IRQ_EDGE_RISE;
+}
+
+/**
+ * \fn static inline uint32_t co_gpio_rise(uint8_t gpio)
+ * \brief Read and acknowledge the rising edge latch of an input
+ * \returns GPIO_IRQ_EDGE_RISE if there was a rising edge since the last acknowledge
+ */
+static inline uint32_t co_gpio_rise(uint8_t gpio){
+    uint32_t e = co_gpio_peek(gpio);
+    if(e)
+        gpio_acknowledge_irq(gpio, GPIO_IRQ_EDGE_RISE);
+    return e;
+}
+
+#ifdef WUCLOCK_REPLAY
+/**
+ * \fn static inline uint32_t replay_gpio_rise(uint8_t gpio)
+ * \brief Read and acknowledge the virtual rising edge while a replay is running, co_gpio_rise otherwise
+ */
+static inline uint32_t replay_gpio_rise(uint8_t gpio){
+    if(!replay.active)
+        return co_gpio_rise(gpio);
+    uint32_t e = (replay.rises >> gpio) & 1;
+    replay.rises &= ~(1u << gpio);
+    return e ? GPIO_IRQ_EDGE_RISE : 0;
+}
+
+#define co_peek(gpio) (replay.active ? (replay.rises >> (gpio)) & 1 : co_gpio_peek(gpio))  ///< Virtual edges while a replay runs
+#define co_rise(gpio) replay_gpio_rise(gpio)
+#else
+#define co_peek(gpio) co_gpio_peek(gpio)
+#define co_rise(gpio) co_gpio_rise(gpio)
+#endif
+
+/**
+ * \fn static inline void co_init(co_t *C)
+ * \brief Start a thread from its beginning at the next co_ready
+ */
+static inline void co_init(co_t *C){
+    C->lc = 0;
+    C->gpio = CO_NO_GPIO;
+    C->edge = false;
+    C->wake = 0;
+}
+
+/**
+ * \fn static inline bool co_ready(co_t *C)
+ * \brief Return true when the wait of a thread is over and it must be resumed
+ */
+static inline bool co_ready(co_t *C){
+    if(C->gpio != CO_NO_GPIO && co_peek(C->gpio))
+        return true;
+#ifdef WUCLOCK_REPLAY
+    if(C->wake != CO_FOREVER)
+        replay_hint(C->wake, true);
+#endif
+    return tb_now() >= C->wake;
+}
+
+/// Start of the thread body, jumps to the wait being resumed
+#define CO_BEGIN(C) switch((C)->lc){ case 0:
+
+/// End of the thread body, the next resume starts it again
+#define CO_END(C) } (C)->lc = 0; (C)->wake = 0; return
+
+/// Wait until the time base clock reaches deadline
+#define CO_AWAIT_UNTIL(C, deadline) do{                                         \
+        (C)->wake = (deadline);                                                 \
+        (C)->gpio = CO_NO_GPIO;                                                 \
+        (C)->lc = __LINE__; case __LINE__:                                      \
+        if(tb_now() < (C)->wake)                                                \
+            return;                                                             \
+    }while(0)
+
+/// Wait for a rising edge of pin, acknowledged, or until deadline, co_edge tells which one
+#define CO_AWAIT_EDGE(C, pin, deadline) do{                                     \
+        (C)->wake = (deadline);                                                 \
+        (C)->gpio = (pin);                                                      \
+        (C)->lc = __LINE__; case __LINE__:                                      \
+        if(tb_now() >= (C)->wake)                                               \
+            (C)->edge = false;                                                  \
+        else if(co_rise((C)->gpio))                                             \
+            (C)->edge = true;                                                   \
+        else                                                                    \
+            return;                                                             \
+        (C)->gpio = CO_NO_GPIO;                                                 \
+    }while(0)
+
+/// Wait until cond is true, checked at every resume
+#define CO_AWAIT(C, cond) do{                                                   \
+        (C)->wake = 0;                                                          \
+        (C)->gpio = CO_NO_GPIO;                                                 \
+        (C)->lc = __LINE__; case __LINE__:                                      \
+        if(!(cond))                                                             \
+            return;                                                             \
+    }while(0)
+
+/**
+ * \fn static inline bool co_edge(const co_t *C)
+ * \brief Return true if the last CO_AWAIT_EDGE ended with an edge
+ */
+static inline bool co_edge(const co_t *C){
+    return C->edge;
+}
+
+#endif
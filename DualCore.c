@@ -0,0 +1,160 @@
+/**
+ * \file        DualCore.c
+ * \brief       Display, LEDs and buzzer on core1, application on core0
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "DualCore.h"
+
+#ifdef WUCLOCK_DUAL_CORE   // pico_multicore is linked only in dual core builds
+#include "OutputStage.h"
+#include "Pattern.h"
+#include "Energy.h"
+#include "Trace.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+
+dc_link_t dcLink = {.ready = DC_NONE, .taken = DC_NONE};
+
+/**
+ * \fn static void dc_take(dc_link_t *L)
+ * \brief Adopt the newest frame in the display of core1
+ */
+static void dc_take(dc_link_t *L){
+    if(L->ready == DC_NONE)                 ///< Nothing new, no lock
+        return;
+    uint32_t save = spin_lock_blocking(L->lock);
+    uint8_t b = L->ready;
+    L->ready = DC_NONE;
+    L->taken = b;
+    spin_unlock(L->lock, save);
+    if(b == DC_NONE)
+        return;
+
+    const dc_frame_t *F = &L->frame[b];
+    uint32_t seq = F->seq;
+    ss_config_t *D = &L->display;
+    if(F->on != D->ssRefreshTB.en){
+        if(F->on)
+            ss_turn_on(D);
+        else
+            ss_turn_off(D);
+    }
+    for(uint8_t i = 0; i < D->numD; i++)
+        D->array[i] = F->array[i];
+    D->enMask = F->enMask;
+    D->blinkMask = F->blinkMask;
+    D->duty = F->duty;
+    if(F->blinkNext != L->blinkNext){       ///< ss_set_blink_mask on core0
+        L->blinkNext = F->blinkNext;
+        D->blinkState = true;
+        D->ssBlinkTB.next = F->blinkNext;
+        D->ssBlinkTB.en = F->blinkMask != 0;
+    }
+    uint32_t latency = time_us_32() - F->stamp;
+    bool tear = F->seq != seq || F->seqEnd != seq;
+
+    save = spin_lock_blocking(L->lock);
+    L->taken = DC_NONE;
+    spin_unlock(L->lock, save);
+
+    L->swaps++;
+    L->tears += tear;
+    L->latSum += latency;
+    if(latency > L->latMax)
+        L->latMax = latency;
+}
+
+/**
+ * \fn static void dc_core1_main(void)
+ * \brief Superloop of core1
+ */
+static void dc_core1_main(void){
+    flash_safe_execute_core_init();         ///< Core1 parks in RAM when core0 writes the flash
+    while(true)
+        dc_core1_pass(&dcLink);
+}
+
+void dc_init(dc_link_t *L){
+    L->lock = spin_lock_init(spin_lock_claim_unused(true));
+    patLock = spin_lock_init(spin_lock_claim_unused(true));
+    traceLock = spin_lock_init(spin_lock_claim_unused(true));
+    L->ready = DC_NONE;
+    L->taken = DC_NONE;
+}
+
+void dc_start(dc_link_t *L, ss_config_t *ss){
+    L->display = *ss;
+    memset(&L->sent, 0xFF, sizeof(L->sent));    ///< The first pass publishes
+    L->blinkNext = UINT64_MAX;
+    L->started = true;
+#ifndef WUCLOCK_REPLAY
+    multicore_launch_core1(dc_core1_main);
+#endif
+}
+
+void dc_publish(dc_link_t *L, ss_config_t *ss){
+    if(!L->started)
+        return;
+    dc_frame_t *S = &L->sent;
+    bool changed = S->enMask != ss->enMask || S->blinkMask != ss->blinkMask ||
+        S->blinkNext != ss->ssBlinkTB.next || S->on != ss->ssRefreshTB.en || S->duty != ss->duty;
+    for(uint8_t i = 0; i < ss->numD && !changed; i++)
+        changed = S->array[i] != ss->array[i];
+    if(!changed)
+        return;
+
+    uint32_t save = spin_lock_blocking(L->lock);
+    uint8_t b = L->taken != DC_NONE ? L->taken ^ 1 : L->ready == 0;     ///< Never the frame core1 copies
+    if(L->ready == b){                      ///< Withdrawn before it is overwritten
+        L->ready = DC_NONE;
+        L->dropped++;
+    }
+    spin_unlock(L->lock, save);
+
+    dc_frame_t *F = &L->frame[b];
+    F->seq = L->published + 1;
+    __dmb();
+    for(uint8_t i = 0; i < ss->numD; i++)
+        F->array[i] = ss->array[i];
+    F->enMask = ss->enMask;
+    F->blinkMask = ss->blinkMask;
+    F->blinkNext = ss->ssBlinkTB.next;
+    F->on = ss->ssRefreshTB.en;
+    F->duty = ss->duty;
+    F->stamp = time_us_32();
+    __dmb();
+    F->seqEnd = F->seq;
+
+    save = spin_lock_blocking(L->lock);
+    if(L->ready != DC_NONE)                 ///< The other frame was not taken
+        L->dropped++;
+    L->ready = b;
+    spin_unlock(L->lock, save);
+
+    *S = *F;
+    L->published++;
+}
+
+void dc_core1_pass(dc_link_t *L){
+    dc_take(L);
+    ss_refresh(&L->display);
+    pat_process(&patPlayer);
+    out_commit();
+    en_outputs(&enMeter);                   ///< Levels of the LEDs and the buzzer just committed
+}
+
+void dc_clear(dc_link_t *L){
+    L->published = 0;
+    L->swaps = 0;
+    L->dropped = 0;
+    L->tears = 0;
+    L->latMax = 0;
+    L->latSum = 0;
+}
+
+#endif
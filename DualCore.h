@@ -0,0 +1,100 @@
+/**
+ * \file        DualCore.h
+ * \brief       Display, LEDs and buzzer on core1, application on core0
+ * \details     With WUCLOCK_DUAL_CORE the superloop of core0 keeps the application (states,
+ * setting modes, console, flash, synchronization) and core1 runs the display multiplex and the
+ * pattern player of the LEDs and the buzzer, so application work no longer delays a multiplexing
+ * slot.
+ *
+ * Core0 draws in watchUI.ssDisplay as before. At the end of its pass dc_publish compares the
+ * digits, masks and blink restart with the last frame sent and, when they changed, writes them to
+ * one of two frame buffers and posts it in a mailbox guarded by a hardware spin lock. Core1 takes
+ * the newest frame at the start of its pass and copies it to its own display copy. Neither core
+ * waits for the other: the lock is held for a few instructions, a frame not taken yet is replaced
+ * by the newer one (dropped), and core0 never writes the buffer core1 is copying. The inter-core
+ * FIFO is left to flash_safe_execute, which parks core1 during flash writes.
+ *
+ * A frame carries its number at both ends; core1 counts a tear when they differ after the copy,
+ * and the swap latency from the publication to the adoption of a frame. The CORE command shows
+ * them. In WUCLOCK_REPLAY builds core1 is not launched, dc_core1_pass runs after every pass of
+ * core0 on the virtual clock.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __DUAL_CORE_H_
+#define __DUAL_CORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SevenSegments.h"
+#include "hardware/sync.h"
+
+#define DC_NONE 0xFF                ///< No frame in a mailbox slot
+
+typedef struct{
+    uint32_t seq;               ///< Frame number, written first
+    uint32_t array[SS_MAXD];    ///< Segment codes of the digits
+    uint32_t enMask;            ///< Digits enabled
+    uint32_t blinkMask;         ///< Digits blinking
+    uint64_t blinkNext;         ///< Blink time base of core0, a change restarts the blink visible
+    bool on;                    ///< Multiplexing running
+    uint16_t duty;              ///< Brightness of the display
+    uint32_t stamp;             ///< time_us_32 of the publication
+    uint32_t seqEnd;            ///< Frame number, written last
+} dc_frame_t;
+
+typedef struct{
+    dc_frame_t frame[2];        ///< Frame buffers
+    spin_lock_t *lock;          ///< Mailbox lock
+    volatile uint8_t ready;     ///< Frame published and not taken, DC_NONE
+    volatile uint8_t taken;     ///< Frame being copied by core1, DC_NONE
+    dc_frame_t sent;            ///< Content of the last frame published
+    ss_config_t display;        ///< Display of core1, driven by the frames
+    uint64_t blinkNext;         ///< Blink restart of the last frame adopted by core1
+    bool started;               ///< dc_start was called
+    uint32_t published;         ///< Frames published by core0
+    uint32_t swaps;             ///< Frames adopted by core1
+    uint32_t dropped;           ///< Frames replaced before core1 took them
+    uint32_t tears;             ///< Frames that changed while core1 copied them
+    uint32_t latMax;            ///< Longest swap latency in us
+    uint64_t latSum;            ///< Sum of the swap latencies in us
+} dc_link_t;
+
+extern dc_link_t dcLink;        ///< Frame mailbox from core0 to the display core
+
+/**
+ * \fn void dc_init(dc_link_t *L)
+ * \brief Claim the spin locks of the mailbox, the pattern player and the trace ring, before the drivers start
+ */
+void dc_init(dc_link_t *L);
+
+/**
+ * \fn void dc_start(dc_link_t *L, ss_config_t *ss)
+ * \brief Copy the initialized display to core1 and launch core1, once after the first app_boot
+ * \param L     Pointer to the link
+ * \param ss    Display drawn by core0
+ */
+void dc_start(dc_link_t *L, ss_config_t *ss);
+
+/**
+ * \fn void dc_publish(dc_link_t *L, ss_config_t *ss)
+ * \brief Send the display to core1 if it changed, called by core0 at the end of its pass
+ */
+void dc_publish(dc_link_t *L, ss_config_t *ss);
+
+/**
+ * \fn void dc_core1_pass(dc_link_t *L)
+ * \brief One pass of core1: take the newest frame, refresh the display, play the patterns, commit
+ */
+void dc_core1_pass(dc_link_t *L);
+
+/**
+ * \fn void dc_clear(dc_link_t *L)
+ * \brief Clear the frame counters and the latency statistics
+ */
+void dc_clear(dc_link_t *L);
+
+#endif
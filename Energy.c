@@ -0,0 +1,144 @@
+/**
+ * \file        Energy.c
+ * \brief       Energy accounting from the actual outputs, per application state, for RNF04
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "Energy.h"
+#include "TimeBase.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#ifdef WUCLOCK_REPLAY
+#include "Replay.h"
+#endif
+
+en_meter_t enMeter;
+
+const char *enPartNames[EN_NUM_PARTS] = {"SEG", "LED", "BUZZER", "MHZ", "BOARD"};
+
+/**
+ * \fn static inline uint64_t en_elapsed(uint64_t *since, uint64_t now)
+ * \brief Time since the last booking and move it to now, 0 when the clock went back (end of a replay)
+ */
+static inline uint64_t en_elapsed(uint64_t *since, uint64_t now){
+    uint64_t dt = now > *since ? now - *since : 0;
+    *since = now;
+    return dt;
+}
+
+/**
+ * \fn static inline void en_pins_on(en_meter_t *E, uint32_t pins, uint64_t us)
+ * \brief Add us to the on time of the pins
+ */
+static inline void en_pins_on(en_meter_t *E, uint32_t pins, uint64_t us){
+    while(pins){
+        E->pinUs[__builtin_ctz(pins)] += us;
+        pins &= pins - 1;
+    }
+}
+
+void en_init(en_meter_t *E, const uint32_t model[EN_NUM_PARTS]){
+    memcpy(E->model, model, sizeof(E->model));
+    E->numOut = 0;
+    E->state = 0;
+    en_clear(E);
+}
+
+void en_add_output(en_meter_t *E, uint8_t gpio, uint8_t part){
+    if(E->numOut >= EN_OUTPUTS)
+        return;
+    E->outPin[E->numOut] = gpio;
+    E->outPart[E->numOut] = part;
+    E->outDuty[E->numOut] = 0;
+    E->numOut++;
+}
+
+void en_clear(en_meter_t *E){
+    uint64_t now = tb_now();
+    memset(E->charge, 0, sizeof(E->charge));
+    memset(E->timeUs, 0, sizeof(E->timeUs));
+    memset(E->pinUs, 0, sizeof(E->pinUs));
+    E->slotSince = now;
+    E->outSince = now;
+    E->cpuSince = now;
+}
+
+void en_skip(en_meter_t *E){
+    uint64_t now = tb_now();
+    E->slotSince = now;
+    E->outSince = now;
+    E->cpuSince = now;
+}
+
+/**
+ * \fn static void en_display(en_meter_t *E, uint32_t pins, uint32_t ua)
+ * \brief Book the display slot that ends now and start the next one
+ */
+static void __not_in_flash_func(en_display)(en_meter_t *E, uint32_t pins, uint32_t ua){
+    uint64_t dt = en_elapsed(&E->slotSince, tb_now());
+    E->charge[E->state][EN_SEGMENT] += (uint64_t)E->slotUa * dt;
+    en_pins_on(E, E->slotPins, dt);
+    E->slotPins = pins;
+    E->slotUa = ua;
+}
+
+void __not_in_flash_func(en_slot)(en_meter_t *E, uint32_t pins, uint32_t segments){
+#ifdef WUCLOCK_REPLAY
+    if(replay.active)                       ///< The refresh ISR runs on the real clock, the replay books frames
+        return;
+#endif
+    en_display(E, pins, segments * E->model[EN_SEGMENT]);
+}
+
+void en_frame(en_meter_t *E, uint32_t ua){
+    en_display(E, 0, ua);
+}
+
+void en_outputs(en_meter_t *E){
+    uint64_t dt = en_elapsed(&E->outSince, tb_now());
+    uint8_t state = E->state;
+    for(uint8_t i = 0; i < E->numOut; i++){
+        uint8_t gpio = E->outPin[i];
+        uint32_t duty = E->outDuty[i];
+        E->charge[state][E->outPart[i]] += (uint64_t)E->model[E->outPart[i]] * duty * dt >> 16;
+        E->pinUs[gpio] += (uint64_t)duty * dt >> 16;
+
+        if(gpio_get_function(gpio) == GPIO_FUNC_PWM){
+            uint8_t s = pwm_gpio_to_slice_num(gpio);
+            pwm_slice_hw_t *S = &pwm_hw->slice[s];
+            uint32_t level = pwm_gpio_to_channel(gpio) ? S->cc >> 16 : S->cc & 0xFFFF;
+            duty = pwm_hw->en & (1u << s) ? ((uint64_t)level << 16) / (S->top + 1) : 0;
+            if(duty > 65536)
+                duty = 65536;               ///< A level above the wrap keeps the output high
+        }
+        else
+            duty = gpio_get_out_level(gpio) ? 65536 : 0;
+        E->outDuty[i] = duty;
+    }
+}
+
+void en_process(en_meter_t *E, uint8_t state, uint32_t khz){
+    uint64_t dt = en_elapsed(&E->cpuSince, tb_now());
+    uint8_t s = E->state;
+    E->timeUs[s] += dt;
+    E->charge[s][EN_CPU] += (uint64_t)E->model[EN_CPU] * khz / 1000 * dt;
+    E->charge[s][EN_BOARD] += (uint64_t)E->model[EN_BOARD] * dt;
+    E->state = state < EN_STATES ? state : EN_STATES - 1;
+}
+
+uint32_t en_mean_uw(const en_meter_t *E, uint8_t state, int8_t part){
+    uint64_t q = 0, t = 0;
+    for(uint8_t s = 0; s < EN_STATES; s++){
+        if(state != EN_STATES && s != state)
+            continue;
+        t += E->timeUs[s];
+        for(uint8_t p = 0; p < EN_NUM_PARTS; p++)
+            if(part < 0 || part == p)
+                q += E->charge[s][p];
+    }
+    return t ? q / t * EN_SUPPLY_MV / 1000 : 0;     ///< uA at the supply voltage
+}
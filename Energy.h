@@ -0,0 +1,139 @@
+/**
+ * \file        Energy.h
+ * \brief       Energy accounting from the actual outputs, per application state, for RNF04
+ * \details     The meter integrates the charge of every part of the board over time, in uA us, and
+ * books it to the application state running, so the ENERGY command shows the mean power of every
+ * state against the 1 W of RNF04 without a power analyzer:
+ *
+ *  - Display: the writer of the display pins reports every slot with en_slot (refresh ISR, or
+ *    ss_refresh from the superloop): the digit selected and its lit segments. A segment draws
+ *    its current only while its digit is selected, the dark part of a dimmed slot draws none.
+ *  - LEDs and buzzer: en_outputs reads the real level of the pins after every commit of the core
+ *    that drives them, the duty of the PWM channel (CC / (TOP + 1)) for a pin in the PWM function
+ *    and the SIO output level for the others. The levels only change at a commit, so the reading
+ *    after the commit holds until the next one.
+ *  - CPU and board: en_process, every pass of core0, books clk_sys times the current per MHz and
+ *    the fixed current of the board, and moves the meter to the state of the application.
+ *
+ * The superloop never halts the cores, they are active all the time at the clk_sys chosen by the
+ * governor (ClockGov.h), so the CPU part follows the clock level and not a duty.
+ *
+ * The on time of every output pin is kept too, weighted by the duty for a PWM pin, for the
+ * segment, digit and LED figures of ENERGY. Every part has one writer (the refresh ISR, the core
+ * that drives the LEDs or core0), a report may read a count in the middle of an update.
+ *
+ * In WUCLOCK_REPLAY builds the meter runs on the virtual clock. The replay does not multiplex the
+ * display, en_slot is ignored while a replay runs and the replay pass books the mean current of
+ * the frame with en_frame instead, so every script reports its energy per state.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __ENERGY_H_
+#define __ENERGY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define EN_STATES 8                 ///< Application states the charge is booked to
+#define EN_OUTPUTS 4                ///< LED and buzzer pins read by en_outputs
+#define EN_BUZZER_UA 20000          ///< Current of the buzzer at full duty
+#define EN_SUPPLY_MV 5000           ///< Supply voltage of the power figures
+
+/// Parts of the current model
+typedef enum{
+    EN_SEGMENT = 0,             ///< A lit segment with its digit selected
+    EN_LED,                     ///< A LED at full duty
+    EN_BUZZER,                  ///< The buzzer at full duty
+    EN_CPU,                     ///< Cores and bus, per MHz of clk_sys
+    EN_BOARD,                   ///< Regulator, flash, crystal and PLL_USB
+    EN_NUM_PARTS
+} en_part_t;
+
+typedef struct{
+    volatile uint8_t state;     ///< State the charge is booked to, set by en_process
+    uint32_t model[EN_NUM_PARTS];           ///< Current of every part in uA
+    uint64_t charge[EN_STATES][EN_NUM_PARTS];   ///< Charge in uA us per state and part
+    uint64_t timeUs[EN_STATES]; ///< Time in every state
+    uint64_t pinUs[32];         ///< On time of every output pin, duty weighted for a PWM pin
+
+    uint32_t slotPins;          ///< Display pins on in the current slot
+    uint32_t slotUa;            ///< Display current of the current slot
+    uint64_t slotSince;         ///< Start of the current slot
+
+    uint8_t numOut;             ///< Outputs read by en_outputs
+    uint8_t outPin[EN_OUTPUTS]; ///< GPIO of the outputs
+    uint8_t outPart[EN_OUTPUTS];    ///< EN_LED or EN_BUZZER
+    uint32_t outDuty[EN_OUTPUTS];   ///< Duty at the last reading, 65536 is full
+    uint64_t outSince;          ///< Time of the last reading
+
+    uint64_t cpuSince;          ///< Time of the last en_process
+} en_meter_t;
+
+extern en_meter_t enMeter;      ///< Charge per state and part of the board
+extern const char *enPartNames[EN_NUM_PARTS];   ///< Names of the parts in ENERGY MODEL
+
+/**
+ * \fn void en_init(en_meter_t *E, const uint32_t model[EN_NUM_PARTS])
+ * \brief Set the current model and start the accounting, add the outputs with en_add_output
+ */
+void en_init(en_meter_t *E, const uint32_t model[EN_NUM_PARTS]);
+
+/**
+ * \fn void en_add_output(en_meter_t *E, uint8_t gpio, uint8_t part)
+ * \brief Read an LED or buzzer pin in en_outputs
+ * \param part      EN_LED or EN_BUZZER
+ */
+void en_add_output(en_meter_t *E, uint8_t gpio, uint8_t part);
+
+/**
+ * \fn void en_clear(en_meter_t *E)
+ * \brief Clear the charges and the on times, the accounting starts again now
+ */
+void en_clear(en_meter_t *E);
+
+/**
+ * \fn void en_skip(en_meter_t *E)
+ * \brief Do not book the time since the last booking, the board was off
+ */
+void en_skip(en_meter_t *E);
+
+/**
+ * \fn void en_slot(en_meter_t *E, uint32_t pins, uint32_t segments)
+ * \brief A new display slot is on the pins, call right after writing them
+ * \param E         Pointer to the meter
+ * \param pins      Digit selected and lit segments, 0 for a blank slot
+ * \param segments  Lit segments times selected digits
+ */
+void en_slot(en_meter_t *E, uint32_t pins, uint32_t segments);
+
+/**
+ * \fn void en_frame(en_meter_t *E, uint32_t ua)
+ * \brief Book the mean current of the display frame from now on, when the display is not multiplexed
+ */
+void en_frame(en_meter_t *E, uint32_t ua);
+
+/**
+ * \fn void en_outputs(en_meter_t *E)
+ * \brief Read the LED and buzzer pins, call after every out_commit of the core that drives them
+ */
+void en_outputs(en_meter_t *E);
+
+/**
+ * \fn void en_process(en_meter_t *E, uint8_t state, uint32_t khz)
+ * \brief Call this method every pass of core0: book the CPU and the board, and move to state
+ * \param E         Pointer to the meter
+ * \param state     State of the application from now on, below EN_STATES
+ * \param khz       clk_sys since the last call
+ */
+void en_process(en_meter_t *E, uint8_t state, uint32_t khz);
+
+/**
+ * \fn uint32_t en_mean_uw(const en_meter_t *E, uint8_t state, int8_t part)
+ * \brief Mean power of a state in uW, of all the states with EN_STATES, one part or all of them with part -1
+ */
+uint32_t en_mean_uw(const en_meter_t *E, uint8_t state, int8_t part);
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * \file        FieldEditor.c
+ * \brief       Setting of numeric fields on the seven segment display with the push buttons
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "FieldEditor.h"
+
+/**
+ * \fn static void fe_put(fe_editor_t *E, uint8_t digit, uint8_t value)
+ * \brief Write a display digit if it shows something else
+ */
+static void fe_put(fe_editor_t *E, uint8_t digit, uint8_t value){
+    if(E->shown[digit] == value)
+        return;
+    E->shown[digit] = value;
+    ss_update_value(E->ss, digit, value);
+}
+
+/**
+ * \fn static void fe_render(fe_editor_t *E, uint8_t i)
+ * \brief Write the changed digits of a field
+ */
+static void fe_render(fe_editor_t *E, uint8_t i){
+    const fe_field_t *F = &E->fields[i];
+    uint16_t v = E->value[i];
+    for(uint8_t d = 0; d < F->width; d++, v /= 10)
+        fe_put(E, F->digit + d, v % 10);
+}
+
+/**
+ * \fn static void fe_show_page(fe_editor_t *E)
+ * \brief Show the page of the active field, the positions without a field are blank
+ */
+static void fe_show_page(fe_editor_t *E){
+    uint8_t page = E->fields[E->active].page;
+    uint8_t want[SS_MAXD];
+    memset(want, SS_BLANK, sizeof(want));
+    for(uint8_t i = 0; i < E->num; i++){
+        const fe_field_t *F = &E->fields[i];
+        if(F->page != page)
+            continue;
+        uint16_t v = E->value[i];
+        for(uint8_t d = 0; d < F->width; d++, v /= 10)
+            want[F->digit + d] = v % 10;
+    }
+    for(uint8_t d = 0; d < E->ss->numD; d++)
+        fe_put(E, d, want[d]);
+}
+
+/**
+ * \fn static void fe_blink(fe_editor_t *E)
+ * \brief Blink the active field, visible first
+ */
+static void fe_blink(fe_editor_t *E){
+    const fe_field_t *F = &E->fields[E->active];
+    ss_set_blink_mask(E->ss, ((1u << F->width) - 1) << F->digit);
+}
+
+/**
+ * \fn static bool fe_clamp(fe_editor_t *E, uint8_t i)
+ * \brief Bring a field into its range and limit
+ * \returns true if the value changed
+ */
+static bool fe_clamp(fe_editor_t *E, uint8_t i){
+    const fe_field_t *F = &E->fields[i];
+    int16_t max = F->limit ? F->limit(E->value) : F->max;
+    int16_t v = E->value[i] < F->min ? F->min : E->value[i] > max ? max : E->value[i];
+    if(v == E->value[i])
+        return false;
+    E->value[i] = v;
+    return true;
+}
+
+void fe_start(fe_editor_t *E, ss_config_t *ss, const fe_field_t *fields, uint8_t num, const int16_t *values){
+    E->ss = ss;
+    E->fields = fields;
+    E->num = num < FE_MAX_FIELDS ? num : FE_MAX_FIELDS;
+    E->active = 0;
+    memcpy(E->value, values, E->num * sizeof(int16_t));
+    for(uint8_t i = 0; i < E->num; i++)
+        fe_clamp(E, i);
+    memset(E->shown, FE_UNKNOWN, sizeof(E->shown));
+    fe_show_page(E);
+    fe_blink(E);
+    tb_init(&E->idleTB, FE_IDLE_US, true);
+}
+
+void fe_step(fe_editor_t *E, int16_t delta){
+    const fe_field_t *F = &E->fields[E->active];
+    int16_t max = F->limit ? F->limit(E->value) : F->max;
+    int16_t v = E->value[E->active] + delta;
+    if(v > max)
+        v = F->wrap ? F->min + (v - max - 1) % (max - F->min + 1) : max;
+    else if(v < F->min)
+        v = F->wrap ? max - (F->min - v - 1) % (max - F->min + 1) : F->min;
+    E->value[E->active] = v;
+    fe_render(E, E->active);
+    for(uint8_t i = 0; i < E->num; i++)     ///< The day after a change of the month or the year
+        if(i != E->active && E->fields[i].limit && fe_clamp(E, i) && E->fields[i].page == F->page)
+            fe_render(E, i);
+    fe_blink(E);
+    tb_update(&E->idleTB);
+}
+
+void fe_next(fe_editor_t *E){
+    if(fe_is_last(E))
+        return;
+    uint8_t page = E->fields[E->active++].page;
+    if(E->fields[E->active].page != page)
+        fe_show_page(E);
+    fe_blink(E);
+    tb_update(&E->idleTB);
+}
+
+void fe_stop(fe_editor_t *E){
+    ss_set_blink_mask(E->ss, 0);
+    tb_disable(&E->idleTB);
+}
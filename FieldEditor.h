@@ -0,0 +1,98 @@
+/**
+ * \file        FieldEditor.h
+ * \brief       Setting of numeric fields on the seven segment display with the push buttons
+ * \details     A setting mode is a constant table of fields: display page, position and number of
+ * digits, range, wrap, and an optional limit computed from the other fields (the day from the
+ * month and the year). The editor keeps a shadow copy of the values, the application loads it from
+ * the running settings when the mode starts and writes it back at once when the last field is
+ * accepted, so a cancelled or timed out setting changes nothing.
+ *
+ * The active field blinks with ss_set_blink_mask. The editor remembers the digit shown in every
+ * position and writes only the digits that change: a +/- touches the digits of the active field
+ * and of a field whose limit cut it, a page change the digits of the display. The blink restarts
+ * visible at every key, and FE_IDLE_US without keys ends the mode (README: inactivity over 30 s
+ * cancels the changes).
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __FIELD_EDITOR_H_
+#define __FIELD_EDITOR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "SevenSegments.h"
+#include "TimeBase.h"
+
+#define FE_MAX_FIELDS 8             ///< Fields of one setting mode
+#define FE_IDLE_US 30000000         ///< Time without keys that cancels the setting
+#define FE_UNKNOWN 0xFF             ///< Digit not written by the editor
+
+typedef struct{
+    uint8_t page;               ///< Display page, the fields of a page are shown together
+    uint8_t digit;              ///< Rightmost display digit of the field
+    uint8_t width;              ///< Number of digits, 1 to 4
+    int16_t min;                ///< Lowest value
+    int16_t max;                ///< Highest value
+    bool wrap;                  ///< +/- past an end goes to the other end, else it stops
+    int16_t (*limit)(const int16_t *values);    ///< Highest value from the other fields, NULL for max
+} fe_field_t;
+
+typedef struct{
+    ss_config_t *ss;            ///< Display of the editor
+    const fe_field_t *fields;   ///< Field table of the setting mode
+    uint8_t num;                ///< Number of fields
+    uint8_t active;             ///< Field being set
+    int16_t value[FE_MAX_FIELDS];   ///< Shadow copy of the settings
+    uint8_t shown[SS_MAXD];     ///< Digit written in every display position, FE_UNKNOWN before
+    time_base_t idleTB;         ///< Inactivity timeout
+} fe_editor_t;
+
+/**
+ * \fn void fe_start(fe_editor_t *E, ss_config_t *ss, const fe_field_t *fields, uint8_t num, const int16_t *values)
+ * \brief Start a setting mode on the first field
+ * \param E         Pointer to the editor
+ * \param ss        Display
+ * \param fields    Field table, up to FE_MAX_FIELDS
+ * \param num       Number of fields
+ * \param values    Current settings, out of range values are brought into range
+ */
+void fe_start(fe_editor_t *E, ss_config_t *ss, const fe_field_t *fields, uint8_t num, const int16_t *values);
+
+/**
+ * \fn void fe_step(fe_editor_t *E, int16_t delta)
+ * \brief Add delta to the active field, fields limited by it are cut to their new limit
+ */
+void fe_step(fe_editor_t *E, int16_t delta);
+
+/**
+ * \fn void fe_next(fe_editor_t *E)
+ * \brief Go to the next field, to its page if it is on another one
+ */
+void fe_next(fe_editor_t *E);
+
+/**
+ * \fn void fe_stop(fe_editor_t *E)
+ * \brief End the setting mode, the blinking stops, the application restores the display
+ */
+void fe_stop(fe_editor_t *E);
+
+/**
+ * \fn static inline bool fe_is_last(const fe_editor_t *E)
+ * \brief Return true on the last field, accepting it ends the setting
+ */
+static inline bool fe_is_last(const fe_editor_t *E){
+    return E->active + 1 >= E->num;
+}
+
+/**
+ * \fn static inline bool fe_idle(fe_editor_t *E)
+ * \brief Return true after FE_IDLE_US without keys
+ */
+static inline bool fe_idle(fe_editor_t *E){
+    return tb_check(&E->idleTB);
+}
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * \file        FlashStore.c
+ * \brief       Small persistent records stored in the last sectors of the on-board flash
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "FlashStore.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "ClockGov.h"
+#include "Audio.h"
+
+#define FSTORE_MAGIC 0x5743u    ///< "WC" tag at the beginning of every record
+#define FSTORE_LOCKOUT_MS 100   ///< Longest wait for core1 to park before a write
+
+typedef struct{
+    uint16_t magic;
+    uint16_t len;
+    uint16_t crc;
+    uint16_t ncrc;              ///< Complement of crc, an erased sector (0xFFFF/0xFFFF) never validates
+} fstore_header_t;
+
+typedef struct{
+    uint32_t offset;            ///< Flash offset of the slot
+    const fstore_header_t *h;   ///< Header of the record
+    const void *data;           ///< Record in RAM
+    uint16_t len;               ///< Record length
+} fstore_job_t;
+
+static inline uint32_t fstore_offset(fstore_slot_t slot){
+    return PICO_FLASH_SIZE_BYTES - (FSTORE_NUM_SLOTS - slot) * FLASH_SECTOR_SIZE;
+}
+
+uint16_t fstore_crc16(const void *data, size_t len){
+    const uint8_t *p = (const uint8_t *)data;
+    uint16_t crc = 0xFFFF;
+    while(len--){
+        crc ^= (uint16_t)(*p++) << 8;
+        for(int i=0;i<8;i++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+bool fstore_read(fstore_slot_t slot, void *data, uint16_t len){
+    const uint8_t *base = (const uint8_t *)(XIP_BASE + fstore_offset(slot));
+    fstore_header_t h;
+    memcpy(&h, base, sizeof(h));
+    if(h.magic != FSTORE_MAGIC || h.len != len || (uint16_t)~h.crc != h.ncrc)
+        return false;
+    if(fstore_crc16(base + sizeof(h), len) != h.crc)
+        return false;
+    memcpy(data, base + sizeof(h), len);
+    return true;
+}
+
+/**
+ * \fn static void fstore_program(void *param)
+ * \brief Erase and program a slot, run by flash_safe_execute with interrupts off and core1 parked
+ */
+static void fstore_program(void *param){
+    static uint8_t page[FLASH_PAGE_SIZE];        ///< Program granularity buffer, static to keep it off the stack
+    const fstore_job_t *J = (const fstore_job_t *)param;
+    flash_range_erase(J->offset, FLASH_SECTOR_SIZE);
+    uint32_t total = sizeof(*J->h) + J->len;
+    for(uint32_t done = 0; done < total; done += FLASH_PAGE_SIZE){
+        memset(page, 0xFF, FLASH_PAGE_SIZE);
+        for(uint32_t i = 0; i < FLASH_PAGE_SIZE && done + i < total; i++){
+            uint32_t k = done + i;
+            page[i] = k < sizeof(*J->h) ? ((const uint8_t *)J->h)[k] : ((const uint8_t *)J->data)[k - sizeof(*J->h)];
+        }
+        flash_range_program(J->offset + done, page, FLASH_PAGE_SIZE);
+    }
+}
+
+bool fstore_write(fstore_slot_t slot, const void *data, uint16_t len){
+    assert(slot < FSTORE_NUM_SLOTS && "ERROR!!! Flash store slot not valid");
+    if(len > FSTORE_MAX_LEN || aud_is_playing(&aud))   ///< The clip DMA reads its samples from XIP
+        return false;
+
+    fstore_header_t h = {FSTORE_MAGIC, len, fstore_crc16(data, len), 0};
+    h.ncrc = ~h.crc;
+
+    fstore_job_t job = {fstore_offset(slot), &h, data, len};
+    cg_boost(&cgGov, CG_FLASH);         ///< Erase and program with the fastest XIP clock
+    if(flash_safe_execute(fstore_program, &job, FSTORE_LOCKOUT_MS) != PICO_OK)
+        return false;
+
+    return memcmp((const uint8_t *)(XIP_BASE + job.offset + sizeof(h)), data, len) == 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * \file        FlashStore.h
+ * \brief       Small persistent records stored in the last sectors of the on-board flash
+ * \details     Each record owns one flash sector (slot) counted backwards from the end of flash. A record
+ * is stored with a magic word, its length and a CRC so that erased or partially written sectors are
+ * detected and rejected on read.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __FLASH_STORE_H_
+#define __FLASH_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+#define FSTORE_NUM_SLOTS 4                      ///< Number of sectors reserved at the end of flash
+#define FSTORE_MAX_LEN (FLASH_SECTOR_SIZE - 8)  ///< Maximum payload of one record in bytes
+
+/**
+ * \brief Slot assignment, one flash sector per record
+ */
+typedef enum {
+    FSTORE_SLOT_DRIFT = 0,      ///< RTC drift correction
+    FSTORE_SLOT_HOLIDAY,        ///< Holiday rules
+    FSTORE_SLOT_ZONE,           ///< Time zone rule
+    FSTORE_SLOT_3
+} fstore_slot_t;
+
+/**
+ * \fn bool fstore_read(fstore_slot_t slot, void *data, uint16_t len)
+ * \brief Copy a record from flash to RAM
+ * \param slot  Record slot
+ * \param data  Pointer to the destination buffer
+ * \param len   Expected record length in bytes
+ * \returns true when the slot holds a valid record of exactly len bytes, false in other case (data untouched)
+ */
+bool fstore_read(fstore_slot_t slot, void *data, uint16_t len);
+
+/**
+ * \fn bool fstore_write(fstore_slot_t slot, const void *data, uint16_t len)
+ * \brief Erase the slot sector and program a new record
+ * \param slot  Record slot
+ * \param data  Pointer to the record in RAM
+ * \param len   Record length in bytes (at most FSTORE_MAX_LEN)
+ * \returns true if the record was read back correctly
+ * \note Interrupts are disabled for the erase and program operations (tens of ms) and core1, when it
+ * runs (WUCLOCK_DUAL_CORE), is parked in RAM by flash_safe_execute: the display freezes meanwhile.
+ * Do not call from timing sensitive states. Returns false if core1 could not be parked, or while an
+ * audio clip plays (aud_is_playing): its DMA reads the samples from XIP, which is off during the write.
+ */
+bool fstore_write(fstore_slot_t slot, const void *data, uint16_t len);
+
+/**
+ * \fn uint16_t fstore_crc16(const void *data, size_t len)
+ * \brief CRC-16/CCITT-FALSE of a buffer, used to validate records
+ */
+uint16_t fstore_crc16(const void *data, size_t len);
+
+#endif
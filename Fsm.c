@@ -0,0 +1,63 @@
+/**
+ * \file        Fsm.c
+ * \brief       Table driven state machine with entry and exit actions
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "Fsm.h"
+#include "Trace.h"
+
+void fsm_init(fsm_t *M, const fsm_state_t *states, uint8_t numStates, const fsm_transition_t *rows, uint8_t numRows){
+    M->states = states;
+    M->rows = rows;
+    M->numStates = numStates < FSM_MAX_STATES ? numStates : FSM_MAX_STATES;
+    M->numRows = numRows;
+    M->state = 0;
+    M->lastEvent = FSM_NONE;
+    memset(M->first, FSM_NONE, sizeof(M->first));
+    for(uint8_t i = numRows; i-- > 0; ){     ///< Backwards, the first row of a group is kept
+        const fsm_transition_t *r = &rows[i];
+        if(r->state < M->numStates && r->event < FSM_MAX_EVENTS)
+            M->first[r->state][r->event] = i;
+    }
+}
+
+void fsm_start(fsm_t *M, uint8_t state){
+    M->state = state;
+    M->lastEvent = FSM_NONE;
+    if(M->states[state].entry)
+        M->states[state].entry();
+}
+
+bool fsm_dispatch(fsm_t *M, uint8_t event){
+    if(event >= FSM_MAX_EVENTS)
+        return false;
+    uint8_t state = M->state;
+    uint8_t i = M->first[state][event];
+    if(i == FSM_NONE)
+        return false;
+    for(const fsm_transition_t *r = &M->rows[i]; i < M->numRows && r->state == state && r->event == event; i++, r++){
+        if(r->guard && !r->guard())
+            continue;
+        if(r->next == FSM_SAME){
+            if(r->action)
+                r->action();
+            return true;
+        }
+        if(M->states[state].exit)
+            M->states[state].exit();
+        if(r->action)
+            r->action();
+        M->state = r->next;
+        M->lastEvent = event;
+        TRACE(TR_STATE, r->next, state | event << 8);
+        if(M->states[r->next].entry)
+            M->states[r->next].entry();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+/**
+ * \file        Fsm.h
+ * \brief       Table driven state machine with entry and exit actions
+ * \details     The application is described by two constant tables in flash: the states, with
+ * their entry and exit actions and the mask of the services (drivers and event sources) the
+ * superloop runs in them, and the transitions (state, event, guard, action, next state). Rows of
+ * the same state and event are consecutive and tried in order, the first row whose guard passes
+ * (or that has no guard) is taken:
+ *
+ *      exit of the state, action, entry of the next state      (next is a state)
+ *      action                                                  (next is FSM_SAME)
+ *
+ * fsm_init builds a [state][event] index of the first row, so fsm_dispatch costs one table read
+ * whatever the number of states and transitions. An event without a row is ignored. Transitions
+ * are traced (TR_STATE with the event) and the last event is kept for the replay log.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __FSM_H_
+#define __FSM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FSM_MAX_STATES 8            ///< States of one machine
+#define FSM_MAX_EVENTS 32           ///< Events of one machine
+#define FSM_NONE 0xFF               ///< No row in the index
+#define FSM_SAME 0xFE               ///< next of an internal transition, no exit and entry
+
+typedef struct{
+    const char *name;           ///< State name for the logs
+    void (*entry)(void);        ///< Run when the state is entered, NULL for none
+    void (*exit)(void);         ///< Run when the state is left, NULL for none
+    uint16_t services;          ///< Mask of the services run in this state, defined by the application
+} fsm_state_t;
+
+typedef struct{
+    uint8_t state;              ///< Source state
+    uint8_t event;              ///< Triggering event
+    bool (*guard)(void);        ///< Condition of the row, NULL for always
+    void (*action)(void);       ///< Transition action, NULL for none
+    uint8_t next;               ///< Target state or FSM_SAME
+} fsm_transition_t;
+
+typedef struct{
+    const fsm_state_t *states;  ///< State table, indexed by state
+    const fsm_transition_t *rows;   ///< Transition table
+    uint8_t numStates;          ///< Number of states
+    uint8_t numRows;            ///< Number of transitions
+    uint8_t state;              ///< Current state
+    uint8_t lastEvent;          ///< Event of the last transition, FSM_NONE after fsm_start
+    uint8_t first[FSM_MAX_STATES][FSM_MAX_EVENTS];  ///< First row of every state and event
+} fsm_t;
+
+/**
+ * \fn void fsm_init(fsm_t *M, const fsm_state_t *states, uint8_t numStates, const fsm_transition_t *rows, uint8_t numRows)
+ * \brief Index the tables of a machine, rows out of range are ignored
+ * \param M         Pointer to the machine
+ * \param states    State table
+ * \param numStates Number of states, up to FSM_MAX_STATES
+ * \param rows      Transition table, rows of the same state and event consecutive
+ * \param numRows   Number of transitions
+ */
+void fsm_init(fsm_t *M, const fsm_state_t *states, uint8_t numStates, const fsm_transition_t *rows, uint8_t numRows);
+
+/**
+ * \fn void fsm_start(fsm_t *M, uint8_t state)
+ * \brief Enter the first state, its entry action runs
+ */
+void fsm_start(fsm_t *M, uint8_t state);
+
+/**
+ * \fn bool fsm_dispatch(fsm_t *M, uint8_t event)
+ * \brief Run the transition of an event in the current state
+ * \returns true if a row was taken
+ */
+bool fsm_dispatch(fsm_t *M, uint8_t event);
+
+/**
+ * \fn static inline uint16_t fsm_services(const fsm_t *M)
+ * \brief Services mask of the current state
+ */
+static inline uint16_t fsm_services(const fsm_t *M){
+    return M->states[M->state].services;
+}
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * \file        Holiday.c
+ * \brief       Holiday calendar compiled from rules into a bitmap per year, to skip the alarms on holidays
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "Holiday.h"
+#include "Calendar.h"
+#include "FlashStore.h"
+#include "pico/stdlib.h"
+
+#define HOL_MAGIC 0x484F4C49u       ///< "HOLI"
+
+hol_calendar_t holCalendar;
+
+const hol_set_t holDefault = {HOL_MAGIC, 18, {
+    {HOL_FIXED, 1, 1, 0},                       ///< New Year
+    {HOL_FIXED | HOL_MONDAY, 1, 6, 0},          ///< Epiphany
+    {HOL_FIXED | HOL_MONDAY, 3, 19, 0},         ///< Saint Joseph
+    {HOL_EASTER, 0, -3, 0},                     ///< Maundy Thursday
+    {HOL_EASTER, 0, -2, 0},                     ///< Good Friday
+    {HOL_FIXED, 5, 1, 0},                       ///< Labour Day
+    {HOL_EASTER | HOL_MONDAY, 0, 39, 0},        ///< Ascension
+    {HOL_EASTER | HOL_MONDAY, 0, 60, 0},        ///< Corpus Christi
+    {HOL_EASTER | HOL_MONDAY, 0, 68, 0},        ///< Sacred Heart
+    {HOL_FIXED | HOL_MONDAY, 6, 29, 0},         ///< Saint Peter and Saint Paul
+    {HOL_FIXED, 7, 20, 0},                      ///< Independence Day
+    {HOL_FIXED, 8, 7, 0},                       ///< Battle of Boyaca
+    {HOL_FIXED | HOL_MONDAY, 8, 15, 0},         ///< Assumption
+    {HOL_FIXED | HOL_MONDAY, 10, 12, 0},        ///< Columbus Day
+    {HOL_FIXED | HOL_MONDAY, 11, 1, 0},         ///< All Saints
+    {HOL_FIXED | HOL_MONDAY, 11, 11, 0},        ///< Independence of Cartagena
+    {HOL_FIXED, 12, 8, 0},                      ///< Immaculate Conception
+    {HOL_FIXED, 12, 25, 0},                     ///< Christmas
+}};
+
+/**
+ * \fn static void hol_drop(hol_calendar_t *H)
+ * \brief Drop both maps, they are compiled again with the rules in use
+ */
+static void hol_drop(hol_calendar_t *H){
+    H->days[0] = H->days[1] = 0;
+    H->year[0] = H->year[1] = -1;
+}
+
+void hol_init(hol_calendar_t *H){
+    hol_set_t set;
+    H->compiles = 0;
+    H->compileUs = 0;
+    if(fstore_read(FSTORE_SLOT_HOLIDAY, &set, sizeof(set)) && set.magic == HOL_MAGIC && set.num <= HOL_MAX_RULES)
+        hol_load(H, &set);
+    else
+        hol_load(H, &holDefault);
+}
+
+void hol_load(hol_calendar_t *H, const hol_set_t *set){
+    H->set = *set;
+    H->set.magic = HOL_MAGIC;
+    hol_drop(H);
+}
+
+bool hol_add(hol_calendar_t *H, hol_rule_t rule){
+    uint8_t kind = rule.kind & ~HOL_MONDAY;
+    bool ok = H->set.num < HOL_MAX_RULES;
+    if(kind == HOL_FIXED)
+        ok &= rule.month >= 1 && rule.month <= 12 && rule.day >= 1 && rule.day <= cal_days_in_month(2000, rule.month);
+    else if(kind == HOL_NTH)
+        ok &= rule.month >= 1 && rule.month <= 12 && ((rule.day >= 1 && rule.day <= 5) || rule.day == -1) && rule.dotw <= 6;
+    else
+        ok &= kind == HOL_EASTER;
+    if(!ok)
+        return false;
+    H->set.rule[H->set.num++] = rule;
+    hol_drop(H);
+    return true;
+}
+
+bool hol_save(const hol_calendar_t *H){
+    return fstore_write(FSTORE_SLOT_HOLIDAY, &H->set, sizeof(H->set));
+}
+
+/**
+ * \fn static int64_t hol_easter(int16_t year)
+ * \brief Easter Sunday in days since 01/01/1970, anonymous Gregorian algorithm
+ */
+static int64_t hol_easter(int16_t year){
+    int32_t a = year % 19, b = year / 100, c = year % 100;
+    int32_t d = b / 4, e = b % 4, f = (b + 8) / 25, g = (b - f + 1) / 3;
+    int32_t h = (19 * a + b - d - g + 15) % 30;
+    int32_t i = c / 4, k = c % 4;
+    int32_t l = (32 + 2 * e + 2 * i - h - k) % 7;
+    int32_t m = (a + 11 * h + 22 * l) / 451;
+    int32_t n = h + l - 7 * m + 114;
+    return cal_days_from_civil(year, n / 31, n % 31 + 1);
+}
+
+/**
+ * \fn static inline uint8_t hol_dotw(int64_t day)
+ * \brief Day of the week of a day since 01/01/1970, a Thursday
+ */
+static inline uint8_t hol_dotw(int64_t day){
+    return (uint8_t)(((day + 4) % 7 + 7) % 7);
+}
+
+int16_t hol_rule_day(hol_rule_t rule, int16_t year){
+    int64_t day;
+    switch(rule.kind & ~HOL_MONDAY){
+    case HOL_FIXED:
+        if(rule.day > cal_days_in_month(year, rule.month))
+            return -1;
+        day = cal_days_from_civil(year, rule.month, rule.day);
+        break;
+    case HOL_NTH:{
+        int8_t mday = cal_nth_dotw(year, rule.month, rule.day, rule.dotw);
+        if(mday < 0)
+            return -1;                      ///< No 5th occurrence this month
+        day = cal_days_from_civil(year, rule.month, mday);
+        break;
+    }
+    default:
+        day = hol_easter(year) + rule.day;
+        break;
+    }
+    if(rule.kind & HOL_MONDAY)
+        day += (8 - hol_dotw(day)) % 7;     ///< Monday is 1
+    int64_t doy = day - cal_days_from_civil(year, 1, 1);
+    return doy >= 0 && doy < 365 + cal_is_leap(year) ? (int16_t)doy : -1;
+}
+
+void hol_compile(hol_calendar_t *H, int16_t year){
+    uint64_t t0 = time_us_64();
+    uint8_t m = year & 1;
+    memset(H->bits[m], 0, sizeof(H->bits[m]));
+    for(uint8_t r = 0; r < H->set.num; r++){
+        int16_t doy = hol_rule_day(H->set.rule[r], year);
+        if(doy >= 0)
+            H->bits[m][doy >> 5] |= 1u << (doy & 31);
+    }
+    H->year[m] = year;
+    H->first[m] = cal_days_from_civil(year, 1, 1);
+    H->days[m] = 365 + cal_is_leap(year);
+    H->compiles++;
+    H->compileUs = (uint32_t)(time_us_64() - t0);
+}
+
+bool hol_is_holiday(hol_calendar_t *H, int64_t day){
+    for(uint8_t m = 0; m < 2; m++){
+        int64_t doy = day - H->first[m];
+        if(doy >= 0 && doy < H->days[m])
+            return H->bits[m][doy >> 5] >> (doy & 31) & 1;
+    }
+    datetime_t dt;
+    cal_from_epoch(day * CAL_SECS_PER_DAY, &dt);
+    hol_compile(H, dt.year);                ///< First day tested of a new year
+    uint8_t m = dt.year & 1;
+    int64_t doy = day - H->first[m];
+    return H->bits[m][doy >> 5] >> (doy & 31) & 1;
+}
+
+uint16_t hol_count(hol_calendar_t *H, int16_t year){
+    uint8_t m = year & 1;
+    if(H->year[m] != year || !H->days[m])
+        hol_compile(H, year);
+    uint16_t n = 0;
+    for(uint8_t w = 0; w < HOL_WORDS; w++)
+        n += __builtin_popcount(H->bits[m][w]);
+    return n;
+}
@@ -0,0 +1,120 @@
+/**
+ * \file        Holiday.h
+ * \brief       Holiday calendar compiled from rules into a bitmap per year, to skip the alarms on holidays
+ * \details     A holiday is given by a rule, 4 bytes each:
+ *  - HOL_FIXED: a day of a month, e.g. 25/12.
+ *  - HOL_NTH: the nth day of the week of a month, or the last one, e.g. the 4th Thursday of November.
+ *  - HOL_EASTER: days from Easter Sunday (Gregorian computus), e.g. -2 for Good Friday.
+ * Any rule can carry HOL_MONDAY, the holiday moves to the next Monday when it does not fall on a
+ * Monday (Colombian law 51 of 1983). The default set is the 18 Colombian holidays, the HOLIDAY
+ * command replaces it over USB (tools/wuhost.py holiday) and saves it in its FlashStore slot.
+ *
+ * The rules are evaluated once per year: hol_compile sets one bit per holiday in a 366 bit map of
+ * the days of the year, so hol_is_holiday is a range compare and a bit test. Two years are kept,
+ * the year of a day selects its map (year & 1), so the search of the next alarm across the new
+ * year does not compile again and again. A year is compiled the first time one of its days is
+ * tested, normally once at the year rollover. A change of the rules drops both maps.
+ *
+ * A holiday moved past 31/12 by HOL_MONDAY is dropped, no rule of the default set can do it.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __HOLIDAY_H_
+#define __HOLIDAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HOL_MAX_RULES 32            ///< Rules of a set
+#define HOL_WORDS 12                ///< Words of the map of one year, 366 bits
+#define HOL_MONDAY 0x80             ///< Flag of hol_rule_t.kind: moved to the next Monday
+
+/// Kinds of rules
+typedef enum{
+    HOL_FIXED = 0,              ///< day of month
+    HOL_NTH,                    ///< day nth dotw of month, -1 for the last
+    HOL_EASTER                  ///< day days from Easter Sunday
+} hol_kind_t;
+
+typedef struct{
+    uint8_t kind;               ///< hol_kind_t, plus HOL_MONDAY
+    uint8_t month;              ///< Month 1-12, HOL_FIXED and HOL_NTH
+    int8_t day;                 ///< Day of the month, occurrence 1-5 or -1, or days from Easter
+    uint8_t dotw;               ///< Day of the week of HOL_NTH, 0 is Sunday
+} hol_rule_t;
+
+typedef struct{
+    uint32_t magic;             ///< HOL_MAGIC in flash
+    uint8_t num;                ///< Rules in use
+    hol_rule_t rule[HOL_MAX_RULES];
+} hol_set_t;
+
+typedef struct{
+    hol_set_t set;              ///< Rules
+    int16_t year[2];            ///< Year of every map
+    int64_t first[2];           ///< Day of 01/01 of every map, days since 01/01/1970
+    uint16_t days[2];           ///< Days of the year of every map, 0 while the map is not compiled
+    uint32_t bits[2][HOL_WORDS];    ///< Bit d is day d of the year, 0 is 01/01
+    uint32_t compiles;          ///< Years compiled since the boot
+    uint32_t compileUs;         ///< Time of the last compile
+} hol_calendar_t;
+
+extern hol_calendar_t holCalendar;  ///< Holiday rules and the bitmap of the year
+extern const hol_set_t holDefault;  ///< Colombian holidays
+
+/**
+ * \fn void hol_init(hol_calendar_t *H)
+ * \brief Load the rules saved in flash, or the default set
+ */
+void hol_init(hol_calendar_t *H);
+
+/**
+ * \fn void hol_load(hol_calendar_t *H, const hol_set_t *set)
+ * \brief Use a new set of rules, both maps are compiled again when needed
+ */
+void hol_load(hol_calendar_t *H, const hol_set_t *set);
+
+/**
+ * \fn bool hol_add(hol_calendar_t *H, hol_rule_t rule)
+ * \brief Add a rule to the set in use
+ * \returns false if the rule is not valid or the set is full
+ */
+bool hol_add(hol_calendar_t *H, hol_rule_t rule);
+
+/**
+ * \fn bool hol_save(const hol_calendar_t *H)
+ * \brief Save the set in use in flash, see fstore_write for the cost
+ */
+bool hol_save(const hol_calendar_t *H);
+
+/**
+ * \fn int16_t hol_rule_day(hol_rule_t rule, int16_t year)
+ * \brief Day of the year of a rule, 0 is 01/01
+ * \returns The day, -1 if the rule has no day in that year (29/02, moved past 31/12)
+ */
+int16_t hol_rule_day(hol_rule_t rule, int16_t year);
+
+/**
+ * \fn void hol_compile(hol_calendar_t *H, int16_t year)
+ * \brief Evaluate every rule for a year into its map
+ */
+void hol_compile(hol_calendar_t *H, int16_t year);
+
+/**
+ * \fn bool hol_is_holiday(hol_calendar_t *H, int64_t day)
+ * \brief Test a day, compiling its year the first time
+ * \param H     Pointer to the calendar
+ * \param day   Days since 01/01/1970
+ */
+bool hol_is_holiday(hol_calendar_t *H, int64_t day);
+
+/**
+ * \fn uint16_t hol_count(hol_calendar_t *H, int16_t year)
+ * \brief Holidays of a year, days with more than one rule count once
+ */
+uint16_t hol_count(hol_calendar_t *H, int16_t year);
+
+#endif
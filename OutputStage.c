@@ -0,0 +1,43 @@
+/**
+ * \file        OutputStage.c
+ * \brief       Per pass staging of the GPIO outputs of all the drivers
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "OutputStage.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/sio.h"
+
+out_stage_t outStage[OUT_CORES];
+
+void out_commit(void){
+    out_stage_t *S = OUT_STAGE;
+    uint32_t out = sio_hw->gpio_out;
+    uint32_t level = (S->level & S->force) | (out & ~S->force);     ///< Level before the toggles
+    level ^= S->toggle;
+    uint32_t change = (S->force | S->toggle) & (level ^ out);       ///< Only pins that change
+    uint32_t clr = change & out;
+    uint32_t set = change & level;
+    if(clr){                    ///< Clear first, see the file description
+        gpio_clr_mask(clr);
+        S->writes++;
+    }
+    if(set){
+        gpio_set_mask(set);
+        S->writes++;
+    }
+    S->force = 0;
+    S->toggle = 0;
+    S->commits++;
+}
+
+void out_clear(void){
+    for(uint8_t i = 0; i < OUT_CORES; i++){
+        outStage[i].posts = 0;
+        outStage[i].writes = 0;
+        outStage[i].commits = 0;
+    }
+}
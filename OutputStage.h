@@ -0,0 +1,101 @@
+/**
+ * \file        OutputStage.h
+ * \brief       Per pass staging of the GPIO outputs of all the drivers
+ * \details     The drivers do not write the SIO registers, they post their changes to a shadow:
+ * forced bits with their level (out_put, out_put_masked) and toggled bits (out_xor_mask). Posts
+ * are composed in order, a later post of a pin overrides or toggles the earlier ones. out_commit
+ * flushes the shadow once per superloop pass: the final levels are computed against the current
+ * output register and only the pins that change are written, with at most two SIO writes, clear
+ * then set. Clearing first blanks the display during the change of digit, the job of the separate
+ * segment and digit writes the display did before.
+ *
+ * The main loop commits right after the state function, where the display is refreshed, so the
+ * multiplexing slot is not delayed by the host services. Blocking code outside the superloop (the
+ * driver tests) uses out_sleep_ms. Outputs are posted outside interrupt handlers, the refresh ISR
+ * of the display (ss_set_alarm) writes its own pins with one SIO clear and one set instead. In
+ * WUCLOCK_DUAL_CORE builds every core has its own shadow and commits it, the pins of the two cores
+ * are disjoint and the SIO set and clear writes are atomic.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __OUTPUT_STAGE_H_
+#define __OUTPUT_STAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+typedef struct{
+    uint32_t force;             ///< Pins with a level posted in this pass
+    uint32_t level;             ///< Posted level of the forced pins
+    uint32_t toggle;            ///< Pins toggled after their forced level, or after the current level
+    uint32_t posts;             ///< Driver posts since the counters were cleared
+    uint32_t writes;            ///< SIO register writes since the counters were cleared
+    uint32_t commits;           ///< Commits since the counters were cleared
+} out_stage_t;
+
+#ifdef WUCLOCK_DUAL_CORE
+#define OUT_CORES 2
+#define OUT_STAGE (&outStage[get_core_num()])  ///< Shadow of the calling core
+#else
+#define OUT_CORES 1
+#define OUT_STAGE (&outStage[0])
+#endif
+
+extern out_stage_t outStage[OUT_CORES];    ///< Output shadows, one per core
+
+/**
+ * \fn static inline void out_put_masked(uint32_t mask, uint32_t value)
+ * \brief Post the level of the pins in mask, the equivalent of gpio_put_masked
+ */
+static inline void out_put_masked(uint32_t mask, uint32_t value){
+    out_stage_t *S = OUT_STAGE;
+    S->force |= mask;
+    S->level = (S->level & ~mask) | (value & mask);
+    S->toggle &= ~mask;
+    S->posts++;
+}
+
+/**
+ * \fn static inline void out_put(uint8_t gpio, bool value)
+ * \brief Post the level of one pin, the equivalent of gpio_put
+ */
+static inline void out_put(uint8_t gpio, bool value){
+    out_put_masked(1u << gpio, value ? 1u << gpio : 0);
+}
+
+/**
+ * \fn static inline void out_xor_mask(uint32_t mask)
+ * \brief Post a toggle of the pins in mask, the equivalent of gpio_xor_mask
+ */
+static inline void out_xor_mask(uint32_t mask){
+    out_stage_t *S = OUT_STAGE;
+    S->toggle ^= mask;
+    S->posts++;
+}
+
+/**
+ * \fn void out_commit(void)
+ * \brief Write the posted changes of the calling core to the pins and empty its shadow
+ */
+void out_commit(void);
+
+/**
+ * \fn void out_clear(void)
+ * \brief Clear the post, write and commit counters of all the cores
+ */
+void out_clear(void);
+
+/**
+ * \fn static inline void out_sleep_ms(uint32_t ms)
+ * \brief Commit the posted changes and sleep, for blocking code outside the superloop
+ */
+static inline void out_sleep_ms(uint32_t ms){
+    out_commit();
+    sleep_ms(ms);
+}
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * \file        Pattern.c
+ * \brief       Byte-code pattern player shared by the LEDs and the buzzer
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stddef.h>
+#include "Pattern.h"
+
+pat_player_t patPlayer = {.next = UINT64_MAX};
+#ifdef WUCLOCK_DUAL_CORE
+spin_lock_t *patLock;
+volatile int8_t patOwner = -1;
+#endif
+
+const uint8_t patBlink[] = {PAT_MARK, PAT_ON(1), PAT_OFF(1), PAT_REPEAT};
+const uint8_t patPulseOn[] = {PAT_ON(1), PAT_END(0)};
+const uint8_t patPulseOff[] = {PAT_OFF(1), PAT_END(PAT_LEVEL_MAX)};
+
+/**
+ * \fn static void pat_run(pat_channel_t *C)
+ * \brief Run instructions up to the next step and schedule it from the previous change
+ */
+static void pat_run(pat_channel_t *C){
+    for(uint8_t ops = 0; ops < PAT_MAX_OPS; ops++){
+        uint8_t level = C->pc[0];
+        uint8_t units = C->pc[1];
+        if(units != PAT_CTRL){
+            C->put(C->dev, level);
+            if(!C->pc)                                      ///< The output ended the pattern
+                return;
+            if(!units){                                     ///< PAT_END
+                C->pc = NULL;
+                return;
+            }
+            C->pc += 2;
+            C->next += (uint64_t)units * C->unitUs;
+            return;
+        }
+        if(level == PAT_OP_MARK){
+            C->pc += 2;
+            C->mark = C->pc;
+            C->loops = 0;
+        }
+        else if(level == PAT_OP_REPEAT){
+            C->pc = C->mark;
+        }
+        else{                                               ///< PAT_LOOP(n)
+            if(!C->loops)
+                C->loops = level & ~PAT_OP_LOOP;
+            if(--C->loops)
+                C->pc = C->mark;
+            else
+                C->pc += 2;
+        }
+    }
+    C->pc = NULL;                                           ///< No step found, the pattern is malformed
+}
+
+void pat_attach(pat_player_t *P, pat_channel_t *C, void (*put)(void *dev, uint8_t level), void *dev){
+    C->pc = NULL;
+    C->put = put;
+    C->dev = dev;
+    for(uint8_t i = 0; i < P->num; i++)
+        if(P->ch[i] == C)
+            return;
+    if(P->num < PAT_CHANNELS)
+        P->ch[P->num++] = C;
+}
+
+void pat_detach(pat_player_t *P, pat_channel_t *C){
+    for(uint8_t i = 0; i < P->num; i++){
+        if(P->ch[i] == C){
+            P->ch[i] = P->ch[--P->num];
+            return;
+        }
+    }
+}
+
+void pat_play(pat_player_t *P, pat_channel_t *C, const uint8_t *pattern, uint32_t unitUs){
+    uint32_t save = pat_lock();
+    C->pc = pattern;
+    C->mark = pattern;
+    C->loops = 0;
+    C->unitUs = unitUs;
+    C->next = tb_now();
+    pat_run(C);
+    if(C->pc && C->next < P->next)
+        P->next = C->next;
+    pat_unlock(save);
+}
+
+void pat_advance(pat_player_t *P){
+    uint32_t save = pat_lock();
+    uint64_t now = tb_now();
+    uint64_t next = UINT64_MAX;
+    for(uint8_t i = 0; i < P->num; i++){
+        pat_channel_t *C = P->ch[i];
+        if(!C->pc)
+            continue;
+        if(C->next <= now){
+            pat_run(C);
+            if(C->next <= now)                              ///< The loop was late, next change in the next pass
+                C->next = now;
+        }
+        if(C->pc && C->next < next)
+            next = C->next;
+    }
+    P->next = next;
+    pat_unlock(save);
+}
@@ -0,0 +1,181 @@
+/**
+ * \file        Pattern.h
+ * \brief       Byte-code pattern player shared by the LEDs and the buzzer
+ * \details     A pattern is a constant array of two byte instructions {level, units}:
+ *
+ *      units 1-254     PAT_STEP: output level, then wait units
+ *      units 0         PAT_END: output level and stop
+ *      units 255       control: PAT_MARK starts the section repeated by PAT_LOOP(n) (played n times in
+ *                      total) or by PAT_REPEAT (forever). Loops are not nested, a PAT_MARK after a
+ *                      loop starts the next section.
+ *
+ * For example an alarm that beeps slowly, then faster and then for ever:
+ *
+ *      PAT_MARK, PAT_ON(20), PAT_OFF(80), PAT_LOOP(10),
+ *      PAT_MARK, PAT_ON(20), PAT_OFF(30), PAT_LOOP(20),
+ *      PAT_MARK, PAT_ON(20), PAT_OFF(10), PAT_REPEAT
+ *
+ * Every device owns a channel with its position in the pattern, attached once to the player with
+ * an output function. pat_process is called every superloop pass: while no change is due it costs
+ * one comparison, at a change it advances the due channels and computes the time of the next one.
+ * The control instructions before a step run in the same advance, so a complex rhythm costs the
+ * same per change as a plain blink. Changes are scheduled from the previous change time, so the
+ * superloop latency does not accumulate. An output function may call pat_stop on its own channel,
+ * the buzzer does it to end a sound at its time limit.
+ *
+ * In WUCLOCK_DUAL_CORE builds the player runs on core1 while core0 starts and stops patterns:
+ * pat_play, pat_stop and pat_advance hold the patLock spin lock, taken again without waiting by
+ * the core that holds it (an output calling pat_stop). The outputs run under the lock.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __PATTERN_H_
+#define __PATTERN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "TimeBase.h"
+#ifdef WUCLOCK_DUAL_CORE
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#endif
+
+#define PAT_CHANNELS 8              ///< Channels the player can attach
+#define PAT_UNIT_US 10000           ///< Default duration of one unit, 10 ms
+#define PAT_MAX_OPS 8               ///< Instructions run in one advance, ends a pattern without steps
+#define PAT_LEVEL_MAX 255           ///< Full level, any level but 0 is ON for a GPIO output
+
+#define PAT_CTRL 255                ///< units value of the control instructions
+#define PAT_OP_MARK 0               ///< Control opcodes, in the level byte
+#define PAT_OP_REPEAT 1
+#define PAT_OP_LOOP 0x80            ///< Low 7 bits are the number of plays of the section
+
+#define PAT_STEP(level, units) (level), (units)     ///< units from 1 to 254
+#define PAT_ON(units) PAT_STEP(PAT_LEVEL_MAX, units)
+#define PAT_OFF(units) PAT_STEP(0, units)
+#define PAT_END(level) (level), 0
+#define PAT_MARK PAT_OP_MARK, PAT_CTRL
+#define PAT_REPEAT PAT_OP_REPEAT, PAT_CTRL
+#define PAT_LOOP(n) (PAT_OP_LOOP | (n)), PAT_CTRL     ///< n from 1 to 127
+
+typedef struct{
+    const uint8_t *pc;          ///< Next instruction, NULL when the channel is idle
+    const uint8_t *mark;        ///< Start of the section repeated by PAT_LOOP and PAT_REPEAT
+    uint8_t loops;              ///< Plays left of the running PAT_LOOP, 0 when none
+    uint32_t unitUs;            ///< Duration of one unit in us
+    uint64_t next;              ///< Time of the next change
+    void (*put)(void *dev, uint8_t level);  ///< Output of the device
+    void *dev;                  ///< Device given to put
+} pat_channel_t;
+
+typedef struct{
+    pat_channel_t *ch[PAT_CHANNELS];    ///< Attached channels
+    uint8_t num;                ///< Number of attached channels
+    uint64_t next;              ///< Earliest change of the playing channels, UINT64_MAX when idle
+} pat_player_t;
+
+extern pat_player_t patPlayer;  ///< Blink and tone patterns of the LEDs and the buzzer
+extern const uint8_t patBlink[];      ///< ON and OFF for one unit each, for ever
+extern const uint8_t patPulseOn[];    ///< ON for one unit, then OFF
+extern const uint8_t patPulseOff[];   ///< OFF for one unit, then ON
+
+/**
+ * \fn void pat_attach(pat_player_t *P, pat_channel_t *C, void (*put)(void *dev, uint8_t level), void *dev)
+ * \brief Attach an idle channel to the player, attaching it again only resets it
+ * \param P     Pointer to the player
+ * \param C     Pointer to the channel of the device
+ * \param put   Output function of the device
+ * \param dev   Device given to put
+ */
+void pat_attach(pat_player_t *P, pat_channel_t *C, void (*put)(void *dev, uint8_t level), void *dev);
+
+/**
+ * \fn void pat_detach(pat_player_t *P, pat_channel_t *C)
+ * \brief Remove a channel from the player, for devices that go out of scope
+ */
+void pat_detach(pat_player_t *P, pat_channel_t *C);
+
+/**
+ * \fn void pat_play(pat_player_t *P, pat_channel_t *C, const uint8_t *pattern, uint32_t unitUs)
+ * \brief Start a pattern on a channel, the first level is output now
+ * \param P         Pointer to the player
+ * \param C         Pointer to the channel
+ * \param pattern   Byte-code of the pattern
+ * \param unitUs    Duration of one unit in us, PAT_UNIT_US for the usual patterns
+ */
+void pat_play(pat_player_t *P, pat_channel_t *C, const uint8_t *pattern, uint32_t unitUs);
+
+#ifdef WUCLOCK_DUAL_CORE
+#define PAT_NESTED 0xFFFFFFFFu      ///< pat_lock result when the lock was already held by this core
+extern spin_lock_t *patLock;        ///< Lock of the player, NULL before dc_init
+extern volatile int8_t patOwner;    ///< Core holding patLock, -1 when free
+
+/**
+ * \fn static inline uint32_t pat_lock(void)
+ * \brief Take the player lock, interrupts are disabled while it is held
+ * \returns Value for pat_unlock
+ */
+static inline uint32_t pat_lock(void){
+    int8_t core = get_core_num();
+    if(!patLock || patOwner == core)
+        return PAT_NESTED;
+    uint32_t save = spin_lock_blocking(patLock);
+    patOwner = core;
+    return save;
+}
+
+/**
+ * \fn static inline void pat_unlock(uint32_t save)
+ * \brief Release the player lock taken by pat_lock
+ */
+static inline void pat_unlock(uint32_t save){
+    if(save == PAT_NESTED)
+        return;
+    patOwner = -1;
+    spin_unlock(patLock, save);
+}
+#else
+static inline uint32_t pat_lock(void){ return 0; }
+static inline void pat_unlock(uint32_t save){ (void)save; }
+#endif
+
+/**
+ * \fn static inline void pat_stop(pat_channel_t *C)
+ * \brief Stop the pattern of a channel, the output keeps its level
+ */
+static inline void pat_stop(pat_channel_t *C){
+    uint32_t save = pat_lock();
+    C->pc = NULL;
+    pat_unlock(save);
+}
+
+/**
+ * \fn static inline bool pat_is_playing(pat_channel_t *C)
+ * \brief Return true while the channel plays a pattern
+ */
+static inline bool pat_is_playing(pat_channel_t *C){
+    return C->pc != NULL;
+}
+
+/**
+ * \fn void pat_advance(pat_player_t *P)
+ * \brief Advance the due channels and compute the next change, called by pat_process
+ */
+void pat_advance(pat_player_t *P);
+
+/**
+ * \fn static inline void pat_process(pat_player_t *P)
+ * \brief Call this method in the superloop to play the patterns of all the channels
+ * \param P Pointer to the player
+ */
+static inline void pat_process(pat_player_t *P){
+    TB_HINT(P, P->next != UINT64_MAX);
+    if(tb_now() >= P->next)
+        pat_advance(P);
+}
+
+#endif
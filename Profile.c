@@ -0,0 +1,78 @@
+/**
+ * \file        Profile.c
+ * \brief       Cycle profiler for the superloop states and driver process calls
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "Profile.h"
+#include "hardware/clocks.h"
+
+profiler_t profiler;
+
+static const char *PROF_NAME[PROF_NUM] = {
+    "NORMAL", "SET_TIME", "SET_ALARM", "SET_SNOOZE", "ALARM", "SHOW_DATE", "SNOOZE",
+    "UI", "SS_REFRESH", "PB_POLL", "PATTERN", "OUT_COMMIT", "CONSOLE", "TRACE", "DRIFT", "SYNC", "CLOCK", "LIGHT", "LOOP"
+};
+
+void prof_init(void){
+    systick_hw->csr = 0;
+    systick_hw->rvr = PROF_SYSTICK_MASK;
+    systick_hw->cvr = 0;                                            ///< Any write reloads the counter
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    uint32_t best = PROF_SYSTICK_MASK;
+    for(int i = 0; i < 8; i++){                                     ///< Cost of an empty probe
+        uint32_t t0 = prof_cycles();
+        uint32_t c = (t0 - prof_cycles()) & PROF_SYSTICK_MASK;
+        if(c < best) best = c;
+    }
+    profiler.overhead = best;
+    profiler.dumpNext = PROF_NUM;
+    prof_clear();
+}
+
+void prof_clear(void){
+    memset(profiler.stat, 0, sizeof(profiler.stat));
+    for(int i = 0; i < PROF_NUM; i++)
+        profiler.stat[i].min = UINT32_MAX;
+    profiler.loopStart = prof_cycles();
+}
+
+void prof_start_dump(void){
+#ifdef WUCLOCK_PROFILE
+    con_printf("PROF cycles at %lu Hz, overhead %lu\n", (unsigned long)clock_get_hz(clk_sys), (unsigned long)profiler.overhead);
+    profiler.dumpNext = 0;
+#else
+    con_printf("ERR profiling not built, enable WUCLOCK_PROFILE\n");
+#endif
+}
+
+void prof_dump(console_t *C){
+    if(profiler.dumpNext >= PROF_NUM || con_tx_pending(C) > CON_TX_SIZE / 2)
+        return;
+
+    const prof_stat_t *s = &profiler.stat[profiler.dumpNext];
+    const char *name = PROF_NAME[profiler.dumpNext];
+    profiler.dumpNext++;
+    if(!s->count){
+        con_printf("PROF %s 0\n", name);
+        return;
+    }
+    con_printf("PROF %s %lu %lu %lu %lu\n", name, (unsigned long)s->count, (unsigned long)s->min,
+        (unsigned long)(s->sum / s->count), (unsigned long)s->max);
+
+    char line[CON_MSG_MAX + 64];
+    int n = snprintf(line, sizeof(line), "PROF %s H", name);
+    for(int k = 0; k < PROF_HIST_BINS && n < (int)sizeof(line) - 16; k++)
+        if(s->hist[k])
+            n += snprintf(line + n, sizeof(line) - n, " %d:%lu", k, (unsigned long)s->hist[k]);
+    line[n++] = '\n';
+    con_write(C, line, n);
+    if(profiler.dumpNext == PROF_NUM)
+        con_printf("PROF END\n");
+}
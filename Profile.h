@@ -0,0 +1,135 @@
+/**
+ * \file        Profile.h
+ * \brief       Cycle profiler for the superloop states and driver process calls
+ * \details     PROF(probe, call) samples the SysTick down counter (clk_sys, 24 bits) before and after
+ * the call and adds the elapsed cycles to the statistics of the probe: count, min, mean, max and a
+ * log2 histogram. A sample costs two register reads and a few additions, the cycles of an empty
+ * probe are measured by prof_init and subtracted. Samples longer than 2^24 cycles (134 ms at
+ * 125 MHz) wrap and are not meaningful.
+ *
+ * Probes are compiled only when WUCLOCK_PROFILE is defined (CMake option WUCLOCK_PROFILE),
+ * otherwise PROF(probe, call) is just the call. The statistics are printed over the console with
+ * the PROF command, one probe per pass so the dump does not flood the TX queue.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __PROFILE_H_
+#define __PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/structs/systick.h"
+#include "Console.h"
+
+#define PROF_SYSTICK_MASK 0x00FFFFFF    ///< SysTick is a 24 bit counter
+#define PROF_HIST_BINS 25               ///< Bin k counts samples of [2^(k-1), 2^k) cycles, bin 0 counts zeros
+
+/**
+ * \brief Profiling probes, the app_pass of each state comes first in watch_ui_state_t order
+ */
+typedef enum{
+    PROF_STATE_NORMAL = 0,      ///< Pass of the NORMAL state
+    PROF_STATE_SET_TIME,        ///< Pass of the SET_TIME state
+    PROF_STATE_SET_ALARM,       ///< Pass of the SET_ALARM state
+    PROF_STATE_SET_SNOOZE,      ///< Pass of the SET_SNOOZE state
+    PROF_STATE_ALARM,           ///< Pass of the ALARM state
+    PROF_STATE_SHOW_DATE,       ///< Pass of the SHOW_DATE state
+    PROF_STATE_SNOOZE,          ///< Pass of the SNOOZE state
+    PROF_UI_PROCESS,            ///< watch_ui_process, included in the state
+    PROF_SS_REFRESH,            ///< ss_refresh, included in watch_ui_process
+    PROF_PB_POLL,               ///< One push button FSM step, included in watch_ui_process
+    PROF_PATTERN,               ///< pat_process of the LEDs and the buzzer, included in watch_ui_process
+    PROF_OUT_COMMIT,            ///< out_commit
+    PROF_CONSOLE,               ///< con_process
+    PROF_TRACE_DRAIN,           ///< trace_drain
+    PROF_DRIFT,                 ///< drift_process
+    PROF_SYNC,                  ///< ts_process
+    PROF_CLOCK,                 ///< cg_process, a clock switch included
+    PROF_LIGHT,                 ///< al_process, an ADC conversion included
+    PROF_LOOP,                  ///< Complete superloop pass
+    PROF_NUM
+} prof_probe_t;
+
+typedef struct{
+    uint32_t count;             ///< Number of samples
+    uint32_t min;               ///< Minimum cycles
+    uint32_t max;               ///< Maximum cycles
+    uint64_t sum;               ///< Sum of cycles, mean = sum / count
+    uint32_t hist[PROF_HIST_BINS];  ///< log2 histogram of cycles
+} prof_stat_t;
+
+typedef struct{
+    prof_stat_t stat[PROF_NUM]; ///< Statistics per probe
+    uint32_t overhead;          ///< Cycles of an empty probe, subtracted from every sample
+    uint32_t loopStart;         ///< SysTick value at the start of the current pass
+    uint8_t dumpNext;           ///< Next probe to print, PROF_NUM when no dump is in progress
+} profiler_t;
+
+extern profiler_t profiler;     ///< Cycle statistics per probe
+
+/**
+ * \fn static inline uint32_t prof_cycles(void)
+ * \brief Current value of the SysTick down counter
+ */
+static inline uint32_t prof_cycles(void){
+    return systick_hw->cvr;
+}
+
+/**
+ * \fn static inline void prof_record(uint8_t probe, uint32_t start)
+ * \brief Add the cycles elapsed since start to the statistics of a probe, use the PROF macro
+ * \param probe prof_probe_t
+ * \param start prof_cycles() at the beginning of the measured code
+ */
+static inline void prof_record(uint8_t probe, uint32_t start){
+    uint32_t c = (start - systick_hw->cvr) & PROF_SYSTICK_MASK;    ///< The counter counts down
+    c = c > profiler.overhead ? c - profiler.overhead : 0;
+    prof_stat_t *s = &profiler.stat[probe];
+    if(c < s->min) s->min = c;
+    if(c > s->max) s->max = c;
+    s->sum += c;
+    s->count++;
+    s->hist[c ? 32 - __builtin_clz(c) : 0]++;
+}
+
+#ifdef WUCLOCK_PROFILE
+#define PROF(probe, call) do{ uint32_t prof_t0 = prof_cycles(); call; prof_record((probe), prof_t0); }while(0)
+#define PROF_PASS() do{ uint32_t prof_t0 = prof_cycles(); prof_record(PROF_LOOP, profiler.loopStart); profiler.loopStart = prof_t0; }while(0)
+#else
+#define PROF(probe, call) do{ (void)(probe); call; }while(0)
+#define PROF_PASS() ((void)0)
+#endif
+
+/**
+ * \fn void prof_init(void)
+ * \brief Start the SysTick counter from clk_sys, measure the probe overhead and clear the statistics
+ */
+void prof_init(void);
+
+/**
+ * \fn void prof_clear(void)
+ * \brief Clear the statistics of all probes
+ */
+void prof_clear(void);
+
+/**
+ * \fn void prof_start_dump(void)
+ * \brief Start printing the statistics, prof_dump sends them over the following passes
+ */
+void prof_start_dump(void);
+
+/**
+ * \fn void prof_dump(console_t *C)
+ * \brief Call this method in the main loop. While a dump is in progress and the console TX queue
+ * is less than half full, the statistics of one probe are queued:
+ *
+ *      PROF <name> <count> <min> <mean> <max>
+ *      PROF <name> H <k>:<samples> ...     (non empty bins, bin k is [2^(k-1), 2^k) cycles)
+ * \param C Pointer to the console used to print the statistics
+ */
+void prof_dump(console_t *C);
+
+#endif
@@ -8,25 +8,62 @@
 #include <stdint.h>
 #include "PushButton.h"
 #include "TimeBase.h"
+#include "Trace.h"
 #include "hardware/gpio.h"
+#include "Coroutine.h"
+
+#ifdef WUCLOCK_REPLAY
+#include "Replay.h"
+#define pb_read(PB) replay_gpio_get((PB)->BITS.gpioNum)     ///< Virtual input while a replay runs
+#else
+#define pb_read(PB) gpio_get((PB)->BITS.gpioNum)            ///< Push button level
+#endif
+#define pb_rise(PB) co_rise((PB)->BITS.gpioNum)             ///< Read and acknowledge the rising edge latch
+
+/**
+ * \fn static void pb_thread(push_button_t *PB)
+ * \brief Debouncer and click counter of a push button
+ * \details The first press opens the click window of eventT_ms. Every press is debounced: debT_ms
+ * without a new rising edge after the press, the release, then debT_ms without a rising edge
+ * after the release. A press before the end of the window counts one more click.
+ */
+static void pb_thread(push_button_t *PB){
+    co_t *C = &PB->co;
+    CO_BEGIN(C);
+    while(true){
+        CO_AWAIT_EDGE(C, PB->BITS.gpioNum, CO_FOREVER);        ///< First press
+        PB->BITS.eventON = true;
+        PB->eventEnd = tb_now() + PB->BITS.eventT_ms * 1000ull;
+        do{
+            PB->BITS.eventCnt += 1;
+            PB->BITS.debON = true;
+            do
+                CO_AWAIT_UNTIL(C, tb_now() + PB->BITS.debT_ms * 1000u);
+            while(pb_rise(PB));                                 ///< Bounced, the period starts again
+            CO_AWAIT(C, !pb_read(PB));                          ///< Release
+            do
+                CO_AWAIT_UNTIL(C, tb_now() + PB->BITS.debT_ms * 1000u);
+            while(pb_rise(PB));
+            PB->BITS.debON = false;
+            CO_AWAIT_EDGE(C, PB->BITS.gpioNum, PB->eventEnd);   ///< Next press in the window
+        }while(co_edge(C));
+        PB->BITS.eventON = false;
+    }
+    CO_END(C);
+}
 
-void PBCatchEventFSM(void *ptr);
-void PBDebounceFSM1(void *ptr);
-void PBDebounceFSM2(void *ptr); 
-void PBDebounceFSM3(void *ptr);
-void PBCatchEventNFSM(void *ptr);
 
 void pb_init(push_button_t *PB, uint8_t gpioNum, uint8_t alarmNum, uint8_t pwmNum){
     PB->BITS.alarmNum = alarmNum;
     PB->BITS.debON = false;
     PB->BITS.debT_ms = 20;
     PB->BITS.eventCnt = 0;
+    PB->BITS.eventON = false;
     PB->BITS.eventT_ms = 1000;
     PB->BITS.gpioNum = gpioNum;
     PB->BITS.pwmNum = pwmNum;
-    tb_init(&(PB->pbTBDebouncer), 20000, false);
-    tb_init(&(PB->pbTBEvent),1000000,false);
-    PB->PBProcess = PBCatchEventFSM;
+    co_init(&PB->co);
+    PB->eventEnd = 0;
     PB->PBEvent = NONE;
 
     gpio_init(gpioNum);
@@ -35,28 +72,87 @@ void pb_init(push_button_t *PB, uint8_t gpioNum, uint8_t alarmNum, uint8_t pwmNu
     gpio_set_pulls(gpioNum,false,true);
     gpio_set_input_enabled(gpioNum,true);
     gpio_set_input_hysteresis_enabled(gpioNum,true);
+    pb_rise(PB);                            ///< No edge before the initialization
+}
+
+void pb_flush(push_button_t *PB){
+    co_init(&PB->co);
+    PB->BITS.eventCnt = 0;
+    PB->BITS.eventON = false;
+    PB->BITS.debON = false;
+    PB->PBEvent = NONE;
+    pb_rise(PB);                            ///< The edge latched while the button was not polled
 }
 
 
 pb_event_t pb_get_event(push_button_t *PB){
+    pb_event_t event;
     switch (PB->BITS.eventCnt)
     {
     case 0:
-        PB->PBEvent = NONE;
+        event = NONE;
         break;
     case 1:
-        PB->PBEvent = ONCE;
+        event = ONCE;
         break;
     case 2:
-        PB->PBEvent = TWICE;
+        event = TWICE;
         break;
     default:
-        PB->PBEvent = MORE;
+        event = MORE;
         break;
     }
+    if(event != PB->PBEvent)
+        TRACE(TR_PB_EVENT, PB->BITS.gpioNum, event);
+    PB->PBEvent = event;
     return PB->PBEvent;
 }
 
+pb_event_t pb_poll_event(push_button_t *PB){
+    if(co_ready(&PB->co))
+        pb_thread(PB);
+    if(PB->BITS.eventON || !PB->BITS.eventCnt)
+        return NONE;
+    pb_event_t event = pb_get_event(PB);
+    pb_clear_event(PB);
+    PB->PBEvent = NONE;
+    return event;
+}
+
+void pb_gov_init(pb_gov_t *G){
+    tb_init(&G->sampleTB, PB_GOV_SLOW_US, true);
+    tb_init(&G->quietTB, PB_GOV_QUIET_US, false);
+    G->fast = false;
+    pb_gov_clear(G);
+}
+
+void pb_gov_report(pb_gov_t *G, bool busy){
+    G->samples[G->fast]++;
+    if(busy){
+        tb_update(&G->quietTB);             ///< The quiet time starts again
+        tb_enable(&G->quietTB);
+        if(!G->fast){
+            G->fast = true;
+            G->toFast++;
+            G->sampleTB.delta = PB_GOV_FAST_US;
+            tb_update(&G->sampleTB);
+        }
+    }
+    else if(G->fast && tb_check(&G->quietTB)){
+        G->fast = false;
+        tb_disable(&G->quietTB);
+        G->sampleTB.delta = PB_GOV_SLOW_US;
+        tb_update(&G->sampleTB);
+    }
+}
+
+void pb_gov_clear(pb_gov_t *G){
+    G->passes = 0;
+    G->samples[0] = 0;
+    G->samples[1] = 0;
+    G->toFast = 0;
+}
+
 void pb_test(uint8_t numGPIO){
     push_button_t PB;
     pb_init(&PB,0,0,numGPIO);
@@ -68,8 +164,7 @@ void pb_test(uint8_t numGPIO){
     time_base_t tout;
     tb_init(&tout,5000000,true);
     while(epb==NONE){
-        PB.PBProcess(&PB);
-        epb = pb_get_event(&PB);
+        epb = pb_poll_event(&PB);       ///< Reported when the click window ends
         if(tb_check(&tout))
             break;
     }
@@ -85,8 +180,7 @@ void pb_test(uint8_t numGPIO){
     epb = NONE;
     tb_init(&tout,5000000,true);
     while(epb==NONE){
-        PB.PBProcess(&PB);
-        epb = pb_get_event(&PB);
+        epb = pb_poll_event(&PB);       ///< Reported when the click window ends
         if(tb_check(&tout))
             break;
     }
@@ -100,109 +194,3 @@ void pb_test(uint8_t numGPIO){
         printf("We might have a problem!!! TWICE event wasn't detected in the last 5 seconds");
     }
 }
-
-/**
- * \fn
- * \brief
- * \param PB
- * \returns 
- */
-void PBCatchEventFSM(void *ptr){
-    push_button_t *PB = (push_button_t *)ptr;
-    bool gpioValue = gpio_get(PB->BITS.gpioNum);
-    if(gpioValue){
-        PB->BITS.debON = true;
-        PB->BITS.eventON = true;
-        tb_update(&(PB->pbTBEvent));
-        tb_update(&(PB->pbTBDebouncer));
-        tb_enable(&(PB->pbTBEvent));
-        tb_enable(&(PB->pbTBDebouncer));
-        PB->BITS.eventCnt += 1;
-        PB->PBProcess = PBDebounceFSM1;
-        gpio_acknowledge_irq(PB->BITS.gpioNum,GPIO_IRQ_EDGE_RISE);
-    }
-}
-
-/**
- * \fn
- * \brief
- * \param PB
- * \returns 
- */
-void PBDebounceFSM1(void *ptr){
-    push_button_t *PB = (push_button_t *)ptr;
-    if(tb_check(&(PB->pbTBDebouncer))){
-        uint32_t gpioEvent = gpio_get_irq_event_mask(PB->BITS.gpioNum);
-        gpio_acknowledge_irq(PB->BITS.gpioNum,GPIO_IRQ_EDGE_RISE);
-        if(!gpioEvent){
-            PB->PBProcess = PBDebounceFSM2;
-        }
-        else{
-            tb_update(&(PB->pbTBDebouncer));
-            tb_enable(&(PB->pbTBDebouncer));
-        }
-    }
-}
-
-/**
- * \fn
- * \brief
- * \param PB
- * \returns 
- */
-void PBDebounceFSM2(void *ptr){
-    push_button_t *PB = (push_button_t *)ptr;
-    bool gpioValue = gpio_get(PB->BITS.gpioNum);
-    if(!gpioValue){
-        PB->PBProcess = PBDebounceFSM3;
-        tb_update(&(PB->pbTBDebouncer));
-        tb_enable(&(PB->pbTBDebouncer));
-    }
-}
-
-/**
- * \fn
- * \brief
- * \param PB
- * \returns 
- */
-void PBDebounceFSM3(void *ptr){
-    push_button_t *PB = (push_button_t *)ptr;
-    if(tb_check(&(PB->pbTBDebouncer))){
-        uint32_t gpioEvent = gpio_get_irq_event_mask(PB->BITS.gpioNum);
-        gpio_acknowledge_irq(PB->BITS.gpioNum,GPIO_IRQ_EDGE_RISE);
-        if(!gpioEvent){
-            PB->PBProcess = PBCatchEventNFSM;
-            PB->BITS.debON = false;
-        }
-        else{
-            tb_update(&(PB->pbTBDebouncer));
-            tb_enable(&(PB->pbTBDebouncer));
-        }
-    }
-}
-
-/**
- * \fn
- * \brief
- * \param PB
- * \returns 
- */
-void PBCatchEventNFSM(void *ptr){
-    push_button_t *PB = (push_button_t *)ptr;
-    if(tb_check(&(PB->pbTBEvent))){
-        PB->BITS.eventON = false;
-        PB->PBProcess = PBCatchEventFSM;
-    }
-    else{
-        bool gpioValue = gpio_get(PB->BITS.gpioNum);
-        if(gpioValue){
-            PB->BITS.debON = true;
-            tb_update(&(PB->pbTBDebouncer));
-            tb_enable(&(PB->pbTBDebouncer));
-            PB->BITS.eventCnt += 1;
-            PB->PBProcess = PBDebounceFSM1;
-            gpio_acknowledge_irq(PB->BITS.gpioNum,GPIO_IRQ_EDGE_RISE);
-        }
-    }
-}
\ No newline at end of file
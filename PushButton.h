@@ -12,6 +12,11 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "TimeBase.h"
+#include "Coroutine.h"
+
+#define PB_GOV_SLOW_US 20000    ///< Sampling period of the button bank while all the buttons are idle, 50 Hz
+#define PB_GOV_FAST_US 1000     ///< Sampling period after an edge and while a click window is open, 1 kHz
+#define PB_GOV_QUIET_US 500000  ///< Time without a busy button before the sampling slows down
 
  typedef enum{NONE, ONCE, TWICE, MORE} pb_event_t;
 
@@ -26,12 +31,27 @@ typedef struct{
         uint8_t debT_ms     : 8;
         uint8_t eventCnt    : 3;
     } BITS;
-    time_base_t pbTBEvent;
-    time_base_t pbTBDebouncer;
-    void (*PBProcess) (void * PB);
+    co_t co;                     ///< Debouncer thread, see pb_thread
+    uint64_t eventEnd;           ///< End of the click window
     pb_event_t PBEvent;
 } push_button_t;
 
+/**
+ * \brief Polling governor of a bank of push buttons
+ * \details Idle and released buttons only wait for an edge, so the bank is sampled slowly. A press
+ * found by a sample, a debouncer or an open click window makes the bank busy and the sampling
+ * fast, PB_GOV_QUIET_US after the last busy sample it is slow again. The debouncer and the click
+ * window keep their own deadlines, the fast period is much shorter than both.
+ */
+typedef struct{
+    time_base_t sampleTB;       ///< Sampling period of the bank
+    time_base_t quietTB;        ///< Time since the last busy sample
+    bool fast;                  ///< Fast sampling
+    uint32_t passes;            ///< Passes that asked for a sample
+    uint32_t samples[2];        ///< Samples of the bank, [0] slow and [1] fast
+    uint32_t toFast;            ///< Changes from slow to fast sampling
+} pb_gov_t;
+
 /**
  * \fn void pb_init(uint8_t gpioNum, uint8_t alarmNum, uint8_t pwmNum, push_button_t *PB)
  * \brief Initialize a push button to detect pulses in a defined period of time
@@ -43,6 +63,16 @@ typedef struct{
  */
 void pb_init(push_button_t *PB, uint8_t gpioNum, uint8_t alarmNum, uint8_t pwmNum);
 
+/**
+ * \fn void pb_flush(push_button_t *PB)
+ * \brief Drop the presses made while the push button was not polled
+ * \details The edge latch keeps a press made while the state did not poll the button, it would be
+ * taken as a new press at the next poll. Call it when the button is polled again: the latch is
+ * acknowledged and the thread starts again waiting for the first press, without an event.
+ * \param PB Pointer to push button data structure
+ */
+void pb_flush(push_button_t *PB);
+
 /**
  * \fn pb_event_t pb_get_event(push_button_t *PB)
  * \brief
@@ -51,6 +81,15 @@ void pb_init(push_button_t *PB, uint8_t gpioNum, uint8_t alarmNum, uint8_t pwmNu
  */
 pb_event_t pb_get_event(push_button_t *PB);
 
+/**
+ * \fn pb_event_t pb_poll_event(push_button_t *PB)
+ * \brief Resume the push button thread if its wait is over and report the event once its event period is over
+ * \param PB Pointer to push button data structure
+ * \returns NONE while the event period is running, otherwise the event of the finished period
+ * (ONCE, TWICE o MORE). The event is cleared, so it is reported only once.
+ */
+pb_event_t pb_poll_event(push_button_t *PB);
+
 /**
  * \fn static inline void pb_clear_event(push_button_t *PB)
  * \brief Call this metod to clear last event
@@ -83,4 +122,44 @@ static inline void pb_set_debouncer_period(push_button_t *PB, uint16_t T){
 
 void pb_test(uint8_t numGPIO);
 
+/**
+ * \fn static inline bool pb_is_busy(const push_button_t *PB)
+ * \brief Return true from the press of a button until the end of its click window
+ */
+static inline bool pb_is_busy(const push_button_t *PB){
+    return PB->BITS.debON || PB->BITS.eventON;
+}
+
+/**
+ * \fn void pb_gov_init(pb_gov_t *G)
+ * \brief Start the governor of a button bank in slow sampling
+ */
+void pb_gov_init(pb_gov_t *G);
+
+/**
+ * \fn static inline bool pb_gov_due(pb_gov_t *G)
+ * \brief Return true when the bank must be sampled in this pass, then call pb_gov_report
+ */
+static inline bool pb_gov_due(pb_gov_t *G){
+    G->passes++;
+    if(!tb_check(&G->sampleTB))
+        return false;
+    tb_update(&G->sampleTB);                ///< From now, a late pass does not cause a burst
+    return true;
+}
+
+/**
+ * \fn void pb_gov_report(pb_gov_t *G, bool busy)
+ * \brief Choose the sampling rate after a sample of the bank
+ * \param G     Pointer to the governor
+ * \param busy  A button of the bank is busy, see pb_is_busy
+ */
+void pb_gov_report(pb_gov_t *G, bool busy);
+
+/**
+ * \fn void pb_gov_clear(pb_gov_t *G)
+ * \brief Clear the pass and sample counters
+ */
+void pb_gov_clear(pb_gov_t *G);
+
  #endif
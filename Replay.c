@@ -0,0 +1,123 @@
+/**
+ * \file        Replay.c
+ * \brief       Deterministic replay of scripted button input on a virtual clock
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "Replay.h"
+
+#define REPLAY_FNV_BASIS 2166136261u
+#define REPLAY_FNV_PRIME 16777619u
+
+replay_t replay;
+
+void replay_log(const char *fmt, ...){
+    char msg[96];
+    int n = snprintf(msg, sizeof(msg), "%6lu.%03lu ", (unsigned long)(replay.now / 1000000),
+        (unsigned long)(replay.now / 1000 % 1000));
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(msg + n, sizeof(msg) - n, fmt, args);
+    va_end(args);
+    for(const char *p = msg; *p; p++)
+        replay.hash = (replay.hash ^ (uint8_t)*p) * REPLAY_FNV_PRIME;
+    replay.lines++;
+    printf("%s\n", msg);
+}
+
+static void replay_set_input(uint8_t gpio, bool level){
+    uint32_t bit = 1u << gpio;
+    if(level && !(replay.inputs & bit))
+        replay.rises |= bit;
+    replay.inputs = level ? replay.inputs | bit : replay.inputs & ~bit;
+}
+
+/**
+ * \brief Apply the script steps and bounce changes that are due
+ * \returns false when the end of the script is reached
+ */
+static bool replay_apply(void (*boot)(void)){
+    while((uint64_t)replay.step->atMs * 1000 <= replay.now){
+        const replay_step_t *s = replay.step;
+        switch (s->op)
+        {
+        case RP_EDGE:
+            replay.bounceLeft = 0;
+            replay_set_input(s->gpio, s->arg);
+            replay_log("IN %u %u", s->gpio, s->arg);
+            break;
+        case RP_BOUNCE:
+            replay.bounceGpio = s->gpio;
+            replay.bounceLeft = s->arg;
+            replay.bounceNext = replay.now;
+            replay_log("BOUNCE %u %u", s->gpio, s->arg);
+            break;
+        case RP_POWER:
+            replay_log("POWER OFF %u ms", s->arg);
+            replay.now += (uint64_t)s->arg * 1000;
+            replay.inputs = replay.rises = 0;
+            replay.bounceLeft = 0;
+            replay_log("POWER ON");
+            boot();
+            break;
+        default:
+            return false;
+        }
+        replay.step++;
+    }
+    while(replay.bounceLeft && replay.bounceNext <= replay.now){
+        replay_set_input(replay.bounceGpio, !((replay.inputs >> replay.bounceGpio) & 1));
+        replay.bounceNext += REPLAY_BOUNCE_US;
+        replay.bounceLeft--;
+    }
+    return true;
+}
+
+/**
+ * \brief Remove the deadlines already reached
+ * \returns The earliest future deadline, UINT64_MAX if there is none
+ */
+static uint64_t replay_next_deadline(void){
+    uint64_t next = UINT64_MAX;
+    for(uint8_t i = 0; i < REPLAY_DEADLINES; i++){
+        if(replay.deadlines[i] && replay.deadlines[i] <= replay.now)
+            replay.deadlines[i] = 0;
+        if(replay.deadlines[i] && replay.deadlines[i] < next)
+            next = replay.deadlines[i];
+    }
+    return next;
+}
+
+bool replay_run(const replay_script_t *S, void (*boot)(void), void (*pass)(void)){
+    memset(&replay, 0, sizeof(replay));
+    replay.step = S->steps;
+    replay.hash = REPLAY_FNV_BASIS;
+    uint64_t t0 = time_us_64();
+    printf("REPLAY %s\n", S->name);
+    replay.active = true;
+    boot();
+
+    while(replay_apply(boot)){
+        pass();
+        replay.passes++;
+        uint64_t next = replay_next_deadline();
+        uint64_t stepAt = (uint64_t)replay.step->atMs * 1000;
+        if(stepAt < next) next = stepAt;
+        if(replay.bounceLeft && replay.bounceNext < next) next = replay.bounceNext;
+        replay.now = next > replay.now ? next : replay.now + REPLAY_MIN_STEP_US;
+    }
+
+    replay.active = false;
+    uint64_t real = time_us_64() - t0;
+    bool ok = !S->expect || S->expect == replay.hash;
+    printf("REPLAY END %s sim %lu ms real %lu ms passes %lu lines %lu hash %08lx %s\n", S->name,
+        (unsigned long)(replay.now / 1000), (unsigned long)(real / 1000), (unsigned long)replay.passes,
+        (unsigned long)replay.lines, (unsigned long)replay.hash, !S->expect ? "NEW" : ok ? "PASS" : "FAIL");
+    return ok;
+}
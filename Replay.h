@@ -0,0 +1,138 @@
+/**
+ * \file        Replay.h
+ * \brief       Deterministic replay of scripted button input on a virtual clock
+ * \details     In WUCLOCK_REPLAY builds the time bases read the virtual clock of the replay engine
+ * instead of the hardware timer, and the push buttons read virtual input levels. replay_run boots
+ * the application and runs superloop passes, applying the timed steps of a script (GPIO edges,
+ * bounce bursts, power cycles). The time bases report every future deadline they see, between
+ * passes the clock jumps to the earliest of them or to the next script step, so idle periods cost
+ * one pass and an hour of interaction runs in a few seconds. A deadline that is no longer pending
+ * (time base disabled or moved) only costs an extra pass. The RTC of the time handler counts the
+ * virtual clock too (t4h_sim_rtc), loaded at every boot with the date of the time handler, so the
+ * display ticks and the alarm fires as on the clock.
+ *
+ * The pass callback records outputs and state transitions with replay_log. Every line is printed
+ * with its virtual time and hashed (FNV-1a), the hash of a run is compared with the expected value
+ * of the script to gate regressions. Outside replay_run the real timer and GPIOs are used.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __REPLAY_H_
+#define __REPLAY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/timer.h"
+#include "hardware/gpio.h"
+
+#define REPLAY_BOUNCE_US 300        ///< Time between the level changes of a bounce burst
+#define REPLAY_MIN_STEP_US 1000     ///< Clock advance when no future deadline was reported
+#define REPLAY_DEADLINES 16         ///< Future time base deadlines remembered by the engine
+
+/**
+ * \brief Script step operations
+ */
+typedef enum{
+    RP_EDGE,                    ///< Set input gpio to level arg
+    RP_BOUNCE,                  ///< Toggle input gpio arg times, REPLAY_BOUNCE_US apart
+    RP_POWER,                   ///< Power off for arg ms, then boot again
+    RP_END                      ///< End of the script
+} replay_op_t;
+
+typedef struct{
+    uint32_t atMs;              ///< Virtual time of the step in ms
+    uint8_t op;                 ///< replay_op_t
+    uint8_t gpio;               ///< Input GPIO of RP_EDGE and RP_BOUNCE
+    uint16_t arg;               ///< Level, toggles or ms depending on op
+} replay_step_t;
+
+/// Clean press of hold ms
+#define RP_PRESS(t, gpio, hold) {(t), RP_EDGE, (gpio), 1}, {(t) + (hold), RP_EDGE, (gpio), 0}
+/// Press of hold ms with five bounces on both edges
+#define RP_PRESS_BOUNCE(t, gpio, hold) {(t), RP_BOUNCE, (gpio), 5}, {(t) + 2, RP_EDGE, (gpio), 1}, \
+    {(t) + (hold), RP_BOUNCE, (gpio), 5}, {(t) + (hold) + 2, RP_EDGE, (gpio), 0}
+
+typedef struct{
+    const char *name;           ///< Script name
+    const replay_step_t *steps; ///< Steps in time order, terminated by RP_END
+    uint32_t expect;            ///< Expected log hash, 0 if not recorded yet
+} replay_script_t;
+
+typedef struct{
+    bool active;                ///< true while replay_run is running
+    uint64_t now;               ///< Virtual time in us
+    uint64_t deadlines[REPLAY_DEADLINES];   ///< Future deadlines reported by the time bases, 0 if free
+    uint32_t inputs;            ///< Virtual input levels, one bit per GPIO
+    uint32_t rises;             ///< Rising edges not acknowledged yet, one bit per GPIO
+    const replay_step_t *step;  ///< Next script step
+    uint8_t bounceGpio;         ///< GPIO of the running bounce burst
+    uint16_t bounceLeft;        ///< Level changes left in the bounce burst
+    uint64_t bounceNext;        ///< Virtual time of the next bounce level change
+    uint32_t hash;              ///< FNV-1a hash of the log
+    uint32_t lines;             ///< Log lines
+    uint32_t passes;            ///< Superloop passes
+} replay_t;
+
+extern replay_t replay;         ///< Virtual clock and inputs of the running script
+
+/**
+ * \fn static inline uint64_t replay_now(void)
+ * \brief Virtual time while a replay is running, the hardware timer otherwise
+ */
+static inline uint64_t replay_now(void){
+    return replay.active ? replay.now : time_us_64();
+}
+
+/**
+ * \fn static inline void replay_hint(uint64_t next, bool en)
+ * \brief Report the deadline of a time base, called by the time base methods
+ */
+static inline void replay_hint(uint64_t next, bool en){
+    if(!replay.active || !en || next <= replay.now)
+        return;
+    uint8_t slot = 0;                                       ///< First free slot, or the latest deadline when full
+    for(uint8_t i = 0; i < REPLAY_DEADLINES; i++){
+        if(replay.deadlines[i] == next)
+            return;
+        if(!replay.deadlines[i]){
+            slot = i;
+            break;
+        }
+        if(replay.deadlines[i] > replay.deadlines[slot])
+            slot = i;
+    }
+    if(!replay.deadlines[slot] || next < replay.deadlines[slot])
+        replay.deadlines[slot] = next;
+}
+
+/**
+ * \fn static inline bool replay_gpio_get(uint8_t gpio)
+ * \brief Virtual input level while a replay is running, gpio_get otherwise
+ */
+static inline bool replay_gpio_get(uint8_t gpio){
+    return replay.active ? (replay.inputs >> gpio) & 1 : gpio_get(gpio);
+}
+
+/**
+ * \fn bool replay_run(const replay_script_t *S, void (*boot)(void), void (*pass)(void))
+ * \brief Run a script on the virtual clock and print its log, blocking until the script ends
+ * \param S     Script to run
+ * \param boot  Initializes the application, called at the start and after every power cycle
+ * \param pass  Runs one superloop pass and logs the changes of the outputs
+ * \returns true if the log hash matches the expected one or none is recorded
+ */
+bool replay_run(const replay_script_t *S, void (*boot)(void), void (*pass)(void));
+
+/**
+ * \fn void replay_log(const char *fmt, ...)
+ * \brief Print one log line with the virtual time in ms and add it to the hash
+ */
+void replay_log(const char *fmt, ...);
+
+extern const replay_script_t replayScripts[];   ///< Built-in scripts, see ReplayScripts.c
+extern const uint8_t replayNumScripts;          ///< Number of built-in scripts
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * \file        ReplayScripts.c
+ * \brief       Built-in input scripts for the replay engine, run with the REPLAY command
+ * \details     Record the expected hash of a script after checking its log, a script with expect 0
+ * reports NEW instead of PASS or FAIL.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "Replay.h"
+
+#define BTN_SET_TIME 2      ///< GPIOs of the push buttons, see watch_ui_init
+#define BTN_SET_ALARM 3
+#define BTN_PLUS 4
+#define BTN_MINUS 5
+#define BTN_SNOOZE 6
+#define BTN_SHOW_DATE 7
+
+static const replay_step_t rpSetAlarmTwice[] = {   ///< Double press enters the set alarm mode
+    RP_PRESS(1000, BTN_SET_ALARM, 120),
+    RP_PRESS(1400, BTN_SET_ALARM, 120),
+    {5000, RP_END, 0, 0}
+};
+
+static const replay_step_t rpEnableAlarmBounce[] = {   ///< A bouncing single press is one event
+    RP_PRESS_BOUNCE(1000, BTN_SET_ALARM, 150),
+    {5000, RP_END, 0, 0}
+};
+
+static const replay_step_t rpPowerCycle[] = {   ///< Power loss in the middle of a double press
+    RP_PRESS(1000, BTN_SHOW_DATE, 100),
+    {1200, RP_POWER, 0, 3000},
+    RP_PRESS(5000, BTN_SHOW_DATE, 100),
+    RP_PRESS(5300, BTN_SHOW_DATE, 100),
+    {8000, RP_END, 0, 0}
+};
+
+static const replay_step_t rpIdleHour[] = {     ///< One hour without input
+    {3600000, RP_END, 0, 0}
+};
+
+static const replay_step_t rpAlarmFire[] = {    ///< Alarm set to 00:01 with the buttons, rings at the tick of 00:01
+    RP_PRESS(1000, BTN_SET_ALARM, 120),
+    RP_PRESS(1400, BTN_SET_ALARM, 120),
+    RP_PRESS(3000, BTN_SET_ALARM, 120),
+    RP_PRESS(4000, BTN_PLUS, 120),
+    RP_PRESS(5000, BTN_SET_ALARM, 120),
+    RP_PRESS(70000, BTN_SET_ALARM, 120),
+    {75000, RP_END, 0, 0}
+};
+
+const replay_script_t replayScripts[] = {
+    {"SET_ALARM_TWICE", rpSetAlarmTwice, 0x826e8e6b},
+    {"ENABLE_ALARM_BOUNCE", rpEnableAlarmBounce, 0x3e94ca77},
+    {"POWER_CYCLE", rpPowerCycle, 0x48cedd1e},
+    {"IDLE_HOUR", rpIdleHour, 0xb25daa17},
+    {"ALARM_FIRE", rpAlarmFire, 0xe10ab9de},
+};
+
+const uint8_t replayNumScripts = sizeof(replayScripts) / sizeof(replayScripts[0]);
@@ -0,0 +1,222 @@
+/**
+ * \file        RtcDrift.c
+ * \brief       RTC drift measurement against a host reference and ppm trim
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "RtcDrift.h"
+#include "FlashStore.h"
+#include "Console.h"
+#include "hardware/clocks.h"
+#include "hardware/rtc.h"
+
+#define DRIFT_NVM_MAGIC 0x44524654u     ///< "DRFT"
+#define DRIFT_WEEK_S 604800
+#define DRIFT_EDGE_POLL_US 1000         ///< Seconds edge polling period of a due leap
+
+typedef struct{
+    uint32_t magic;
+    int32_t ppb;
+    uint32_t mode;
+} drift_nvm_t;
+
+/**
+ * \brief Split a correction between the clk_rtc divider and leap seconds
+ * \param nominalDiv    Untrimmed divider in 16.8 fixed point
+ * \param ppb           Total correction in ppb
+ * \param mode          How the correction is applied
+ * \param div           Divider to program
+ * \returns Residual correction in ppb left to leap seconds
+ */
+static int32_t drift_split(uint32_t nominalDiv, int32_t ppb, drift_apply_t mode, uint32_t *div){
+    int32_t steps = 0;
+    if(mode == DRIFT_APPLY_DIVIDER){
+        int64_t num = (int64_t)nominalDiv * ppb;
+        steps = (int32_t)((num + (num >= 0 ? 500000000 : -500000000)) / 1000000000);
+    }
+    *div = nominalDiv + steps;
+    return ppb - (int32_t)((int64_t)steps * 1000000000 / nominalDiv);
+}
+
+static void drift_schedule_leap(rtc_drift_t *D){
+    if(D->residualPpb == 0){
+        tb_disable(&D->leapTB);
+        return;
+    }
+    uint32_t absPpb = D->residualPpb > 0 ? D->residualPpb : -D->residualPpb;
+    D->leapDir = D->residualPpb > 0 ? -1 : 1;
+    D->leapSec = -1;
+    tb_init(&D->leapTB, 1000000000000000ull / absPpb, true);    ///< One second of error every 1e9/ppb seconds
+}
+
+void drift_init(rtc_drift_t *D){
+    D->nominalDiv = clocks_hw->clk[clk_rtc].div;
+    D->appliedPpb = 0;
+    D->residualPpb = 0;
+    D->mode = DRIFT_APPLY_DIVIDER;
+    D->leapCount = 0;
+    D->leapDir = 0;
+    D->leapSec = -1;
+    tb_init(&D->leapTB, 1000000, false);
+    drift_clear(D);
+
+    drift_nvm_t nvm;
+    if(fstore_read(FSTORE_SLOT_DRIFT, &nvm, sizeof(nvm)) && nvm.magic == DRIFT_NVM_MAGIC)
+        drift_set_correction(D, nvm.ppb, (drift_apply_t)nvm.mode, false);
+}
+
+void drift_clear(rtc_drift_t *D){
+    D->samples = 0;
+    D->hostRef = 0;
+    D->localRef = 0;
+    D->hostLast = 0;
+    D->sx = D->sy = D->sxx = D->sxy = D->syy = 0.0;
+}
+
+void drift_add_pulse(rtc_drift_t *D, uint64_t hostUs, uint64_t localUs){
+    if(D->samples == 0){
+        D->hostRef = hostUs;
+        D->localRef = localUs;
+    }
+    else if(hostUs <= D->hostLast){
+        return;                                                 ///< Duplicated or reordered pulse
+    }
+    double x = (double)(int64_t)(hostUs - D->hostRef) * 1e-6;
+    double y = (double)((int64_t)(localUs - D->localRef) - (int64_t)(hostUs - D->hostRef));
+    D->sx += x;
+    D->sy += y;
+    D->sxx += x * x;
+    D->sxy += x * y;
+    D->syy += y * y;
+    D->hostLast = hostUs;
+    D->samples++;
+}
+
+void drift_get_report(rtc_drift_t *D, drift_report_t *R){
+    R->samples = D->samples;
+    R->spanS = (uint32_t)((D->hostLast - D->hostRef) / 1000000);
+    R->measuredPpb = 0;
+    R->stderrPpb = 0;
+    R->appliedPpb = D->appliedPpb;
+    R->residualPpb = D->residualPpb;
+    R->mode = D->mode;
+    R->leapCount = D->leapCount;
+    R->valid = false;
+    if(D->samples >= 3){
+        double n = D->samples;
+        double cxx = D->sxx - D->sx * D->sx / n;
+        double cxy = D->sxy - D->sx * D->sy / n;
+        double cyy = D->syy - D->sy * D->sy / n;
+        if(cxx > 0.0){
+            double slope = cxy / cxx;                           ///< us/s = ppm
+            double sse = cyy - slope * cxy;
+            R->measuredPpb = (int32_t)lround(slope * 1000.0);
+            R->stderrPpb = (int32_t)lround(sqrt((sse > 0.0 ? sse : 0.0) / (n - 2) / cxx) * 1000.0);
+            R->valid = D->samples >= DRIFT_MIN_SAMPLES && R->spanS >= DRIFT_MIN_SPAN_S;
+        }
+    }
+    R->weekErrorMs = (int32_t)((int64_t)(R->measuredPpb - D->appliedPpb) * DRIFT_WEEK_S / 1000000);
+}
+
+void drift_print_report(rtc_drift_t *D){
+    drift_report_t R;
+    drift_get_report(D, &R);
+    con_printf("DRIFT n=%lu span=%lus meas=%ldppb se=%ldppb applied=%ldppb leap=%ldppb mode=%c leaps=%lu week=%ldms %s\n",
+        (unsigned long)R.samples, (unsigned long)R.spanS, (long)R.measuredPpb, (long)R.stderrPpb,
+        (long)R.appliedPpb, (long)R.residualPpb, R.mode == DRIFT_APPLY_DIVIDER ? 'D' : 'L',
+        (unsigned long)R.leapCount, (long)R.weekErrorMs, R.valid ? "valid" : "pending");
+}
+
+bool drift_set_correction(rtc_drift_t *D, int32_t ppb, drift_apply_t mode, bool persist){
+    if(ppb > DRIFT_MAX_PPB || ppb < -DRIFT_MAX_PPB)
+        return false;
+    uint32_t div;
+    D->residualPpb = drift_split(D->nominalDiv, ppb, mode, &div);
+    D->appliedPpb = ppb;
+    D->mode = mode;
+    clocks_hw->clk[clk_rtc].div = div;                          ///< Fractional dividers can change on the fly
+    drift_schedule_leap(D);
+
+    if(persist){
+        drift_nvm_t nvm = {DRIFT_NVM_MAGIC, ppb, mode};
+        return fstore_write(FSTORE_SLOT_DRIFT, &nvm, sizeof(nvm));
+    }
+    return true;
+}
+
+bool drift_apply(rtc_drift_t *D, drift_apply_t mode){
+    drift_report_t R;
+    drift_get_report(D, &R);
+    if(!R.valid)
+        return false;
+    return drift_set_correction(D, R.measuredPpb, mode, true);
+}
+
+void drift_process(rtc_drift_t *D){
+    if(tb_check(&D->leapTB)){
+        datetime_t dt;
+        if(!rtc_running() || !rtc_get_datetime(&dt)){
+            D->leapSec = -1;
+            tb_next(&D->leapTB);                                ///< Nothing to correct while the RTC is stopped
+            return;
+        }
+        if(D->leapSec < 0 || dt.sec == D->leapSec               ///< Wait for the seconds edge
+            || dt.sec < 1 || dt.sec > 58){                      ///< and until a +-1 s change has no carry
+            D->leapSec = dt.sec;
+            tb_after(&D->leapTB, DRIFT_EDGE_POLL_US);
+            return;
+        }
+        dt.sec += D->leapDir;
+        rtc_set_datetime(&dt);                                  ///< Right after the edge, the divider restarts in phase
+        D->leapSec = -1;
+        tb_after(&D->leapTB, D->leapTB.delta);
+        D->leapCount++;
+    }
+}
+
+void drift_test(int32_t skewPpb){
+    static rtc_drift_t D;                                       ///< Static, not applied to the hardware
+    const uint32_t nominalDiv = 1024 << 8;                      ///< clk_rtc = 48 MHz / 1024
+    uint32_t seed = 12345;
+
+    printf("TESTING RTC DRIFT ESTIMATOR!!!\n");
+    printf("Simulated crystal error %ld ppb, pulses every 60 s with +-1.5 ms jitter\n", (long)skewPpb);
+    D.nominalDiv = nominalDiv;
+    D.appliedPpb = 0;
+    drift_clear(&D);
+
+    drift_report_t R;
+    for(uint32_t k = 0; k <= 24 * 60; k++){
+        uint64_t host = 1000000000ull + (uint64_t)k * 60000000ull;
+        seed = seed * 1664525u + 1013904223u;
+        int32_t jitter = (int32_t)(seed >> 16) % 3001 - 1500;
+        int64_t local = (int64_t)host + (int64_t)(host - 1000000000ull) * skewPpb / 1000000000 + jitter;
+        drift_add_pulse(&D, host, (uint64_t)local);
+        if(k && !(k % 240)){
+            drift_get_report(&D, &R);
+            printf("%2lu h: measured %ld ppb, se %ld ppb\n", (unsigned long)(k / 60), (long)R.measuredPpb, (long)R.stderrPpb);
+        }
+    }
+
+    drift_get_report(&D, &R);
+    uint32_t div;
+    int32_t residual = drift_split(nominalDiv, R.measuredPpb, DRIFT_APPLY_DIVIDER, &div);
+    int64_t dividerPpb = (int64_t)(int32_t)(div - nominalDiv) * 1000000000 / nominalDiv;
+    int64_t leaps = residual ? (int64_t)DRIFT_WEEK_S * (residual > 0 ? residual : -residual) / 1000000000 : 0;
+    int64_t weekErrMs = ((int64_t)skewPpb - dividerPpb) * DRIFT_WEEK_S / 1000000 - (residual > 0 ? leaps : -leaps) * 1000;
+    printf("Divider %lu (%+ld steps), %ld ppb left to %ld leap seconds per week\n",
+        (unsigned long)div, (long)(int32_t)(div - nominalDiv), (long)residual, (long)leaps);
+    printf("Uncorrected error %ld ms/week, corrected error %ld ms/week\n",
+        (long)((int64_t)skewPpb * DRIFT_WEEK_S / 1000000), (long)weekErrMs);
+
+    if(llabs((int64_t)R.measuredPpb - skewPpb) < 100 && llabs(weekErrMs) < 1000)
+        printf("Well done!!! Drift estimate converged\n");
+    else
+        printf("We might have a problem!!! Drift estimate did not converge\n");
+}
@@ -0,0 +1,145 @@
+/**
+ * \file        RtcDrift.h
+ * \brief       RTC drift measurement against a host reference and ppm trim (RNF01: +-1 min/week)
+ * \details     The host sends sync pulses stamped with its own clock over the USB console. Every pulse
+ * is stamped again on arrival with time_us_64(). The microsecond timer and clk_rtc come from the same
+ * crystal, so the slope of (local - host) against host time is the drift of the RTC before any trim.
+ * The measured drift is therefore independent of the correction already applied.
+ *
+ * The correction is applied in one of two ways:
+ * - DRIFT_APPLY_DIVIDER: the clk_rtc fractional divider is trimmed in steps of 1/div (about 3.8 ppm
+ *   with the default 48 MHz/1024), and the residual below one step is handled with leap seconds.
+ * - DRIFT_APPLY_LEAP: clk_rtc is left at its nominal divider and the whole correction is done by
+ *   periodically repeating (RTC fast) or skipping (RTC slow) one second.
+ *
+ * Leap seconds are applied only when the RTC second is between 1 and 58, so minute carries and
+ * alarms are never skipped or duplicated.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __RTC_DRIFT_H_
+#define __RTC_DRIFT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "TimeBase.h"
+
+#define DRIFT_MIN_SAMPLES 8             ///< Minimum number of pulses before a measurement can be applied
+#define DRIFT_MIN_SPAN_S 600            ///< Minimum time between first and last pulse in seconds
+#define DRIFT_MAX_PPB 500000            ///< Corrections beyond +-500 ppm are rejected as measurement errors
+
+typedef enum {DRIFT_APPLY_DIVIDER, DRIFT_APPLY_LEAP} drift_apply_t;
+
+typedef struct{
+    uint32_t samples;           ///< Number of sync pulses accumulated
+    uint64_t hostRef;           ///< Host timestamp of the first pulse in us
+    uint64_t localRef;          ///< Local timestamp of the first pulse in us
+    uint64_t hostLast;          ///< Host timestamp of the last pulse in us
+    double sx, sy, sxx, sxy, syy; ///< Regression sums, x host elapsed in s and y local-host offset in us
+    int32_t appliedPpb;         ///< Correction currently applied in ppb (+ means the RTC runs fast)
+    int32_t residualPpb;        ///< Part of appliedPpb handled with leap seconds
+    drift_apply_t mode;         ///< How the correction is applied
+    uint32_t nominalDiv;        ///< clk_rtc divider (16.8 fixed point) found at boot, without trim
+    uint32_t leapCount;         ///< Leap seconds applied since boot
+    int8_t leapDir;             ///< -1 repeat a second (RTC fast), +1 skip a second (RTC slow)
+    int8_t leapSec;             ///< Seconds field seen when the leap fell due, -1 while no leap is due
+    time_base_t leapTB;         ///< Time base for leap second insertion and deletion
+} rtc_drift_t;
+
+/**
+ * \brief Drift report, see drift_get_report
+ */
+typedef struct{
+    uint32_t samples;           ///< Number of sync pulses in the current measurement
+    uint32_t spanS;             ///< Seconds between first and last pulse
+    int32_t measuredPpb;        ///< Measured drift in ppb (+ means the RTC runs fast)
+    int32_t stderrPpb;          ///< Standard error of the measured drift in ppb
+    int32_t appliedPpb;         ///< Correction currently applied in ppb
+    int32_t residualPpb;        ///< Part of the correction handled with leap seconds
+    drift_apply_t mode;         ///< How the correction is applied
+    uint32_t leapCount;         ///< Leap seconds applied since boot
+    int32_t weekErrorMs;        ///< Projected error per week with the applied correction in ms
+    bool valid;                 ///< true when the measurement has enough samples and span to be applied
+} drift_report_t;
+
+/**
+ * \fn void drift_init(rtc_drift_t *D)
+ * \brief Initialize the drift data structure and apply the correction persisted in flash, if any
+ * \param D Pointer to drift data structure
+ * \note Must be called before any other code modifies the clk_rtc divider
+ */
+void drift_init(rtc_drift_t *D);
+
+/**
+ * \fn void drift_clear(rtc_drift_t *D)
+ * \brief Discard all sync pulses and start a new measurement, the applied correction is kept
+ * \param D Pointer to drift data structure
+ */
+void drift_clear(rtc_drift_t *D);
+
+/**
+ * \fn void drift_add_pulse(rtc_drift_t *D, uint64_t hostUs, uint64_t localUs)
+ * \brief Add a sync pulse to the measurement
+ * \param D         Pointer to drift data structure
+ * \param hostUs    Host timestamp of the pulse in us
+ * \param localUs   time_us_64 when the pulse was received
+ */
+void drift_add_pulse(rtc_drift_t *D, uint64_t hostUs, uint64_t localUs);
+
+/**
+ * \fn void drift_get_report(rtc_drift_t *D, drift_report_t *R)
+ * \brief Compute the drift estimate and fill the report
+ * \param D Pointer to drift data structure
+ * \param R Pointer to report data structure
+ */
+void drift_get_report(rtc_drift_t *D, drift_report_t *R);
+
+/**
+ * \fn void drift_print_report(rtc_drift_t *D)
+ * \brief Print the drift report in one line over stdio
+ * \param D Pointer to drift data structure
+ */
+void drift_print_report(rtc_drift_t *D);
+
+/**
+ * \fn bool drift_set_correction(rtc_drift_t *D, int32_t ppb, drift_apply_t mode, bool persist)
+ * \brief Apply a correction and optionally store it in flash
+ * \param D         Pointer to drift data structure
+ * \param ppb       Correction in ppb, positive when the RTC runs fast
+ * \param mode      DRIFT_APPLY_DIVIDER or DRIFT_APPLY_LEAP
+ * \param persist   true to store the correction in flash
+ * \returns false if the correction is out of range or could not be stored
+ */
+bool drift_set_correction(rtc_drift_t *D, int32_t ppb, drift_apply_t mode, bool persist);
+
+/**
+ * \fn bool drift_apply(rtc_drift_t *D, drift_apply_t mode)
+ * \brief Apply and persist the measured drift
+ * \param D     Pointer to drift data structure
+ * \param mode  DRIFT_APPLY_DIVIDER or DRIFT_APPLY_LEAP
+ * \returns false when the measurement is not valid yet (see DRIFT_MIN_SAMPLES and DRIFT_MIN_SPAN_S)
+ */
+bool drift_apply(rtc_drift_t *D, drift_apply_t mode);
+
+/**
+ * \fn void drift_process(rtc_drift_t *D)
+ * \brief Call this method in the main loop to insert or delete leap seconds
+ * \details rtc_set_datetime restarts the 1 Hz divider, so a due leap waits for the seconds
+ * field to change and is applied right after the edge, the second in progress is not cut short.
+ * \param D Pointer to drift data structure
+ */
+void drift_process(rtc_drift_t *D);
+
+/**
+ * \fn void drift_test(int32_t skewPpb)
+ * \brief Feed the estimator with pulses from a simulated crystal with skewPpb error and USB jitter,
+ * and verify that the estimate and the resulting weekly error converge
+ * \param skewPpb Simulated crystal error in ppb
+ */
+void drift_test(int32_t skewPpb);
+
+#endif
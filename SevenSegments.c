@@ -8,8 +8,14 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "SevenSegments.h"
+#include "Profile.h"
 #include "hardware/gpio.h"
+#include "hardware/timer.h"
+#include "hardware/sync.h"
+
+static ss_config_t *ssAlarm[4];     ///< Display of each claimed timer alarm
 
  const uint8_t SS_CODES_CC[] = {
     // abcdefgp
@@ -41,7 +47,8 @@
      0b00001010,  // 25 r
      0b00011110,  // 26 t
      0b00111000,  // 27 u
-     0b01111100   // 28 U
+     0b01111100,  // 28 U
+     0b00000000   // 29 blank
  };
 
  const uint8_t SS_CODES_CA[] = {
@@ -74,10 +81,15 @@
      0b11110101,  // 25 r CA
      0b11100001,  // 26 t CA
      0b11000111,  // 27 u CA
-     0b10000011   // 28 U CA
+     0b10000011,  // 28 U CA
+     0b11111111   // 29 blank CA
  };
 
 void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, uint32_t disMask){
+    for(uint8_t i = 0; i < 4; i++)
+        if(ssAlarm[i] == SS)                        ///< Initialized again, the ISR stops until ss_turn_on
+            hardware_alarm_cancel(i);
+    SS->alarmNum = SS_NO_ALARM;
     SS->type = type;
     assert(NumD <= SS_MAXD && "ERROR!!! The number of displays is not supported");
     SS->numD = NumD;       // total number of displays
@@ -109,9 +121,9 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
         }
         pos++;
         mask = mask >> 1;
-        assert(cnt<8 && "ERROR!!! There are more than 8 segments");
+        assert(cnt<=8 && "ERROR!!! There are more than 8 segments");
     }
-    assert(cnt<8 && "ERROR!!! There are missing GPIOS for the 8 segments in each display");
+    assert(cnt==8 && "ERROR!!! There are missing GPIOS for the 8 segments in each display");
 
     // SS->disPosArray[32] with GPIO number for each display control signal [0]-LSD, ... , [numD-1] - MSD
     mask = disMask;
@@ -123,12 +135,12 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
             cnt++;
         }
         pos++;
-        mask == mask >> 1;
-        assert(cnt<NumD && "There are more control GPIOs than displays to control");
+        mask = mask >> 1;
+        assert(cnt<=NumD && "There are more control GPIOs than displays to control");
     }
-    assert(cnt==NumD-1 && "There are missing GPIOs for controlling each display");
+    assert(cnt==NumD && "There are missing GPIOs for controlling each display");
 
-    for(int i=0;i<28;i++){
+    for(int i=0;i<=SS_BLANK;i++){
         uint32_t temp = 0;
         for(int j=0;j<8;j++){
              temp |= ((ptr[i]>>j)&0x00000001)<<(SS->segPosArray[j]);
@@ -146,6 +158,8 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
 
     SS->blinkMask = 0x00000000;
     SS->blinkState = false;
+    SS->duty = SS_DUTY_MAX;
+    SS->dimmed = false;
     SS->blinkFreq = 1;
 
     tb_init(&(SS->ssRefreshTB),1000000/SS->refFreq,false);
@@ -154,7 +168,7 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
     // Initialize GPIOs to drive segments
     gpio_init_mask(SS->segMask);
     gpio_set_dir_masked(SS->segMask,SS->segMask);
-    gpio_put_masked(SS->segMask,SS->disOff); 
+    gpio_put_masked(SS->segMask,SS->bcd2SSDeco[SS_BLANK]); 
     for(int i=0;i<8;i++){
         gpio_set_drive_strength(SS->segPosArray[i],GPIO_DRIVE_STRENGTH_12MA);
     }
@@ -164,7 +178,137 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
     gpio_put_masked(SS->disMask,0x00000000);
 }
 
+/**
+ * \fn static void ss_publish(ss_config_t *SS)
+ * \brief Build the frame that is not live if the display changed and make it live
+ */
+static void ss_publish(ss_config_t *SS){
+    const ss_frame_t *L = &SS->frame[SS->live];
+    uint32_t onUs = ss_on_us(SS);
+    if(L->show == SS->enMask && L->blink == SS->blinkMask && L->restart == SS->ssBlinkTB.next && L->onUs == onUs &&
+        !memcmp(L->array, SS->array, SS->numD * sizeof(uint32_t)))
+        return;
+    ss_frame_t *F = &SS->frame[SS->live ^ 1];       ///< The ISR reads only the live one
+    uint32_t show[2] = {SS->enMask & ~SS->blinkMask, SS->enMask};
+    for(uint8_t h = 0; h < 2; h++){
+        uint8_t n = 0;
+        for(uint8_t d = 0; d < SS->numD; d++)
+            if(show[h] & (1u << d))
+                F->slot[h][n++] = SS->muxSeq[d] | SS->array[d];
+        F->num[h] = n;
+    }
+    F->halfSlots = SS->ssBlinkTB.delta / SS->ssRefreshTB.delta;
+    if(!F->halfSlots)
+        F->halfSlots = 1;
+    memcpy(F->array, SS->array, SS->numD * sizeof(uint32_t));
+    F->show = SS->enMask;
+    F->blink = SS->blinkMask;
+    F->restart = SS->ssBlinkTB.next;
+    F->onUs = onUs;
+    __compiler_memory_barrier();                    ///< The frame is complete before it goes live
+    SS->live ^= 1;
+}
+
+/**
+ * \fn static void ss_alarm_irq(uint alarmNum)
+ * \brief Refresh ISR: output the next slot of the live frame and arm the next one
+ * \details A dimmed slot takes two alarms, the second one blanks the display after the lit part.
+ */
+static void __not_in_flash_func(ss_alarm_irq)(uint alarmNum){
+    uint32_t t0 = prof_cycles();
+    ss_config_t *SS = ssAlarm[alarmNum];
+    ss_isr_t *I = &SS->isr;
+    const ss_frame_t *F = &SS->frame[SS->live];
+    uint32_t level = SS->bcd2SSDeco[SS_BLANK];      ///< No digit selected, segments off
+    uint32_t step = SS->ssRefreshTB.delta;
+    if(I->dark){                                    ///< Rest of a dimmed slot
+        I->dark = false;
+        step -= I->onUs;
+    }
+    else{
+        if(F->restart != I->restart){               ///< ss_set_blink_mask, visible first
+            I->restart = F->restart;
+            I->blinkState = true;
+            I->blinkCnt = F->halfSlots;
+        }
+        else if(!--I->blinkCnt){
+            I->blinkState = !I->blinkState;
+            I->blinkCnt = F->halfSlots;
+        }
+        uint8_t n = F->num[I->blinkState];
+        if(n){
+            if(++I->slot >= n)
+                I->slot = 0;
+            level = F->slot[I->blinkState][I->slot];
+            if(F->onUs < step){                     ///< Dimmed, blank after the lit part
+                I->dark = true;
+                I->onUs = F->onUs;
+                step = F->onUs;
+            }
+        }
+    }
+    uint32_t pins = SS->disMask | SS->segMask;
+    gpio_clr_mask(pins & ~level);                   ///< Clear first blanks the change of digit
+    gpio_set_mask(pins & level);
+    ss_energy(SS, level);
+
+    I->target += step;                              ///< From the last target, no drift
+    if(hardware_alarm_set_target(alarmNum, from_us_since_boot(I->target))){
+        I->late++;
+        I->target = time_us_64() + step;
+        hardware_alarm_set_target(alarmNum, from_us_since_boot(I->target));
+    }
+    uint32_t c = (t0 - prof_cycles()) & PROF_SYSTICK_MASK;
+    I->count++;
+    I->cyclesSum += c;
+    if(c > I->cyclesMax)
+        I->cyclesMax = c;
+    if(c > SS_ISR_BUDGET)
+        I->over++;
+}
+
+void ss_set_alarm(ss_config_t *SS, uint8_t alarmNum){
+    assert(alarmNum < 3 && "ERROR!!! Alarm 3 belongs to the default alarm pool");
+    if(!ssAlarm[alarmNum]){                         ///< The alarm stays claimed when the display is initialized again
+        hardware_alarm_claim(alarmNum);
+        hardware_alarm_set_callback(alarmNum, ss_alarm_irq);
+    }
+    ssAlarm[alarmNum] = SS;
+    SS->alarmNum = alarmNum;
+}
+
+void ss_isr_start(ss_config_t *SS){
+    hardware_alarm_cancel(SS->alarmNum);
+    memset(SS->frame, 0, sizeof(SS->frame));
+    SS->frame[SS->live].show = ~0u;                 ///< Never equal, the first frame is built
+    ss_publish(SS);
+    SS->isr.slot = 0;
+    SS->isr.dark = false;
+    SS->isr.restart = SS->frame[SS->live].restart;
+    SS->isr.blinkState = true;
+    SS->isr.blinkCnt = SS->frame[SS->live].halfSlots;
+    SS->isr.target = time_us_64() + SS->ssRefreshTB.delta;
+    hardware_alarm_set_target(SS->alarmNum, from_us_since_boot(SS->isr.target));
+}
+
+void ss_isr_stop(ss_config_t *SS){
+    hardware_alarm_cancel(SS->alarmNum);
+}
+
+void ss_isr_clear(ss_config_t *SS){
+    SS->isr.count = 0;
+    SS->isr.late = 0;
+    SS->isr.over = 0;
+    SS->isr.cyclesMax = 0;
+    SS->isr.cyclesSum = 0;
+}
+
 void ss_refresh(ss_config_t *SS){
+    if(SS->alarmNum != SS_NO_ALARM){                ///< The ISR multiplexes
+        if(SS->ssRefreshTB.en)
+            ss_publish(SS);
+        return;
+    }
 
     if(tb_check(&(SS->ssRefreshTB))){                       ///< Refresh displays at the every refresh time base event
         tb_next(&(SS->ssRefreshTB));                        ///< Update refresh time base for next event
@@ -180,16 +324,25 @@ void ss_refresh(ss_config_t *SS){
             uint8_t cnt = ((SS->display)+1)%(SS->numD);     ///< Compute next display to show
             while(!(muxMask & (0x00000001<<cnt)))           ///< While next display disable
                 cnt = (cnt+1)%(SS->numD);                   ///< continue searching for display to refresh
-            gpio_put_masked(SS->segMask,SS->disOff);        ///< Turn off segments before moving to new display
-            gpio_put_masked(SS->disMask,SS->muxSeq[cnt]);   ///< Next display is now current display
-            gpio_put_masked(SS->segMask,SS->array[cnt]);    ///< Write segments value to current display
+            out_put_masked(SS->disMask,SS->muxSeq[cnt]);    ///< Next display is now current display, the commit
+            out_put_masked(SS->segMask,SS->array[cnt]);     ///< clears the old pins before setting the new ones
+            ss_energy(SS, SS->muxSeq[cnt] | SS->array[cnt]);
             SS->display = cnt;
+            SS->dimmed = SS->duty < SS_DUTY_MAX;            ///< Blank the rest of the slot at darkAt
+            SS->darkAt = SS->ssRefreshTB.next - SS->ssRefreshTB.delta + ss_on_us(SS);
         }
         else{                                               ///< when there are not display to show
-            gpio_put_masked(SS->disMask,0x00000000);        ///< Turn off all display
-            gpio_put_masked(SS->segMask,SS->disOff);        ///< Let's ensure all segments off
+            out_put_masked(SS->disMask,0x00000000);         ///< Turn off all display
+            out_put_masked(SS->segMask,SS->bcd2SSDeco[SS_BLANK]);   ///< Let's ensure all segments off
+            ss_energy(SS, 0);
         }
     }
+    else if(SS->dimmed && tb_now() >= SS->darkAt){          ///< End of the lit part of a dimmed slot
+        SS->dimmed = false;
+        out_put_masked(SS->disMask,0x00000000);
+        out_put_masked(SS->segMask,SS->bcd2SSDeco[SS_BLANK]);
+        ss_energy(SS, 0);
+    }
 }
 
 void ss_test(uint32_t segMask, uint32_t disMask, uint8_t numD, ss_type_t type){ 
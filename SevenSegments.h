@@ -4,7 +4,8 @@
  * \author RAVV
  * \date
  * \version
- * \todo Dimerization using PWM signals to drive the LED segments
+ * \details The brightness is the duty of the multiplexing: a dimmed digit is lit for the first part
+ * of its slot and the display is blank for the rest.
  */
 
 
@@ -13,6 +14,8 @@
 #define __SEVEN_SEGMENTS_H
 
 #include "TimeBase.h"
+#include "OutputStage.h"
+#include "Energy.h"
 #include "hardware/gpio.h"
 #include "pico/stdlib.h"
 #include <stdint.h>
@@ -21,11 +24,56 @@
 #define SS_MAXD 18 ///< Maximum number of Displays for RPP
 #define SS_DOFF_CC 0x00 ///< segments code to turn off display in a common cathode
 #define SS_DOFF_CA 0xFF ///< segments code to turn off display in a common anode
+#define SS_BLANK 29 ///< Value of ss_update_value for a digit with all segments off
+#define SS_NO_ALARM 0xFF ///< alarmNum of a display multiplexed by ss_refresh from the superloop
+#define SS_ISR_BUDGET 1000 ///< Cycles allowed to the refresh ISR per slot, longer slots are counted
+#define SS_DUTY_MAX 256 ///< Full brightness, a digit is lit for its whole slot
+#define SS_DUTY_MIN_US 20 ///< Shortest lit part of a dimmed slot, above the latency of the refresh ISR
 
 
 
 typedef enum{COMMON_CATHODE, COMMON_ANODE} ss_type_t;
 
+/**
+ * \brief Precomputed multiplexing of the refresh ISR
+ * \details With a timer alarm (ss_set_alarm) the multiplexing does not depend on the superloop:
+ * the alarm IRQ outputs the next slot of the live frame with one clear and one set of the SIO,
+ * and arms the alarm one refresh period after its last target. The slot is precomputed: digit
+ * select and segment pins of every digit shown, one list for each half of the blink, so the
+ * handler has no loops and its cost is the same for every slot.
+ *
+ * ss_refresh becomes the publisher: when the digits, masks or the blink restart changed it builds
+ * the frame that is not live and switches live with one byte write. The foreground never writes
+ * what the handler reads, the blink state is kept by the handler and restarts visible when the
+ * frame carries a new restart. The handler runs on the core that calls ss_turn_on, the same that
+ * calls ss_refresh.
+ */
+typedef struct{
+    uint32_t slot[2][SS_MAXD];  ///< Digit and segment pins of the digits shown, [0] hidden half of the blink, [1] visible half
+    uint8_t num[2];             ///< Number of slots of each half, 0 blanks the display
+    uint32_t halfSlots;         ///< Slots in a half of the blink
+    uint32_t array[SS_MAXD];    ///< Segment codes the frame was built from
+    uint32_t show;              ///< Digits enabled
+    uint32_t blink;             ///< Digits blinking
+    uint64_t restart;           ///< ssBlinkTB.next when built, a change restarts the blink visible
+    uint32_t onUs;              ///< Lit part of a slot in us, the refresh period when not dimmed
+}ss_frame_t;
+
+typedef struct{
+    uint8_t slot;               ///< Slot of the live frame on the pins
+    bool dark;                  ///< The next alarm blanks the rest of a dimmed slot
+    uint32_t onUs;              ///< Lit part of the current slot
+    bool blinkState;            ///< Half of the blink, true visible
+    uint32_t blinkCnt;          ///< Slots left in the half of the blink
+    uint64_t restart;           ///< Blink restart of the live frame last adopted
+    uint64_t target;            ///< Time of the next slot in us
+    uint32_t count;             ///< Alarms served since the counters were cleared, two per dimmed slot
+    uint32_t late;              ///< Targets missed, the alarm was armed again from the current time
+    uint32_t over;              ///< Slots longer than SS_ISR_BUDGET cycles
+    uint32_t cyclesMax;         ///< Longest slot in cycles
+    uint64_t cyclesSum;         ///< Sum of the slot cycles
+}ss_isr_t;
+
 /**
  * \brief Status and control information for a visualizer compose of multiple seven segment displays
  * 
@@ -39,7 +87,7 @@ typedef struct{
     uint32_t disOff;            ///< Segment value to turn display OFF
     uint32_t enMask;            ///< Mask with active displays
     uint16_t refFreq;           ///< Multiplexation frequency, default frequency set to 60*numD
-    uint8_t array[32];          ///< Array with the segment code for each display [0]-LSD, ... , [numD-1] - MSD
+    uint32_t array[32];         ///< Array with the segment code for each display [0]-LSD, ... , [numD-1] - MSD
     uint8_t segPosArray[8];     ///< Array with GPIO number for each segment 0-a, 1-b, .. 7-p
     uint8_t disPosArray[32];    ///< Array with GPIO number for each display control signal [0]-LSD, ... , [numD-1] - MSD 
     uint32_t bcd2SSDeco[32];    ///< Array with 7 segment codes in user provided segment positions
@@ -47,8 +95,15 @@ typedef struct{
     uint16_t blinkFreq;         ///< Blink Frequency for displays with blinking activated
     uint32_t blinkMask;         ///< Mask to enable blinking feature in the asociate display
     bool blinkState;            ///< Blink state, true if display ON and false if display OFF
+    uint16_t duty;              ///< Brightness, lit part of a slot in 1/SS_DUTY_MAX
+    bool dimmed;                ///< The current slot of ss_refresh is blanked at darkAt
+    uint64_t darkAt;            ///< End of the lit part of the current slot of ss_refresh
     time_base_t ssRefreshTB;    ///< Time base for multiplexing
     time_base_t ssBlinkTB;      ///< Time base for blinking
+    uint8_t alarmNum;           ///< Timer alarm of the refresh ISR, SS_NO_ALARM to refresh from ss_refresh
+    ss_frame_t frame[2];        ///< Frames of the refresh ISR, the one not live is built by ss_refresh
+    volatile uint8_t live;      ///< Frame output by the refresh ISR
+    ss_isr_t isr;               ///< State and cost of the refresh ISR
 }ss_config_t;
 
 /**
@@ -64,11 +119,38 @@ void ss_init(ss_config_t *SS, uint8_t NumD, ss_type_t type, uint32_t segMask, ui
 
 /**
  * \fn void ss_refresh(ss_config_t *SS)
- * \brief Execute the seven segment display refreshing/multiplexing at a constant frequency
+ * \brief Execute the seven segment display refreshing/multiplexing at a constant frequency, or
+ * publish the changes to the refresh ISR when the display has a timer alarm
  * \param SS        pointer to seven segments displays data structure
  */
 void ss_refresh(ss_config_t *SS);
 
+/**
+ * \fn void ss_set_alarm(ss_config_t *SS, uint8_t alarmNum)
+ * \brief Multiplex the display from a timer alarm IRQ, call after ss_init and before ss_turn_on
+ * \param SS        pointer to seven segments displays data structure
+ * \param alarmNum  Hardware alarm 0 to 2, alarm 3 is the default alarm pool of the SDK
+ */
+void ss_set_alarm(ss_config_t *SS, uint8_t alarmNum);
+
+/**
+ * \fn void ss_isr_start(ss_config_t *SS)
+ * \brief Publish the first frame and arm the alarm of the refresh ISR, use ss_start_refresh
+ */
+void ss_isr_start(ss_config_t *SS);
+
+/**
+ * \fn void ss_isr_stop(ss_config_t *SS)
+ * \brief Cancel the alarm of the refresh ISR, use ss_stop_refresh
+ */
+void ss_isr_stop(ss_config_t *SS);
+
+/**
+ * \fn void ss_isr_clear(ss_config_t *SS)
+ * \brief Clear the slot counters and the cycle statistics of the refresh ISR
+ */
+void ss_isr_clear(ss_config_t *SS);
+
 /**
  * \fn static inline void ss_start_refresh(ss_config_t *SS)
  * \brief
@@ -76,7 +158,9 @@ void ss_refresh(ss_config_t *SS);
  */
 static inline void ss_start_refresh(ss_config_t *SS){
     tb_update(&SS->ssRefreshTB);
-    tb_enable(&SS->ssRefreshTB);
+    tb_enable(&SS->ssRefreshTB);                    ///< Also the running flag of the refresh ISR
+    if(SS->alarmNum != SS_NO_ALARM)
+        ss_isr_start(SS);
 }
 
 /**
@@ -85,18 +169,32 @@ static inline void ss_start_refresh(ss_config_t *SS){
  * \param SS        pointer to seven segments displays data structure
  */
 static inline void ss_stop_refresh(ss_config_t *SS){
+    if(SS->alarmNum != SS_NO_ALARM)
+        ss_isr_stop(SS);
     tb_disable(&SS->ssRefreshTB);
 }
 
+/**
+ * \fn static inline void ss_energy(ss_config_t *SS, uint32_t level)
+ * \brief Report the level written to the display pins to the energy meter
+ * \details A segment draws its current only while a digit is selected.
+ */
+static inline void ss_energy(ss_config_t *SS, uint32_t level){
+    uint32_t sel = level & SS->disMask;
+    uint32_t lit = sel ? (SS->type == COMMON_ANODE ? ~level : level) & SS->segMask : 0;
+    en_slot(&enMeter, sel | lit, __builtin_popcount(lit) * __builtin_popcount(sel));
+}
+
 /**
  * \fn static inline void ss_turn_off(ss_config_t *SS)
  * \brief
  * \param SS        pointer to seven segments displays data structure
  */
 static inline void ss_turn_off(ss_config_t *SS){
-    tb_disable(&SS->ssRefreshTB);
-    gpio_put_masked(SS->disMask,0x00000000);        ///< Turn off all display
-    gpio_put_masked(SS->segMask,SS->disOff);        ///< Let's ensure all segments off
+    ss_stop_refresh(SS);
+    out_put_masked(SS->disMask,0x00000000);         ///< Turn off all display
+    out_put_masked(SS->segMask,SS->bcd2SSDeco[SS_BLANK]);   ///< Let's ensure all segments off
+    ss_energy(SS, 0);
 }
 
 /**
@@ -105,10 +203,9 @@ static inline void ss_turn_off(ss_config_t *SS){
  * \param SS        pointer to seven segments displays data structure
  */
 static inline void ss_turn_on(ss_config_t *SS){
-    tb_update(&SS->ssRefreshTB);
-    tb_enable(&SS->ssRefreshTB);
-    SS->enMask = SS->disMask;
-    SS->blinkMask &= ~ SS->disMask;
+    SS->enMask = (1u << SS->numD) - 1;              ///< All the digits, the masks are in digit positions
+    SS->blinkMask = 0;
+    ss_start_refresh(SS);
 }
 
 /**
@@ -126,13 +223,20 @@ static inline void ss_update_value(ss_config_t *SS, uint8_t digit, uint8_t value
 
 /**
  * \fn static inline void ss_set_blink_mask(ss_config_t *SS, uint32_t mask)
- * \brief
+ * \brief Set the blinking digits, the blink starts in its visible half and stops with a 0 mask
  * \param SS        Pointer to seven segments displays data structure
  * \param mask      Bit mask with ones on the positions of the digits that should blink
  */
 static inline void ss_set_blink_mask(ss_config_t *SS, uint32_t mask){
     assert(!(mask>>SS->numD)&& "ERROR!!! One or more digits in the mask don't configured");
     SS->blinkMask = mask;
+    SS->blinkState = true;                          ///< Every new mask starts visible
+    if(mask){
+        tb_update(&SS->ssBlinkTB);
+        tb_enable(&SS->ssBlinkTB);
+    }
+    else
+        tb_disable(&SS->ssBlinkTB);
 }
 
 /**
@@ -168,6 +272,25 @@ static inline void ss_set_blink_freq(ss_config_t *SS, uint16_t freq){
     SS->ssBlinkTB.delta = 1000000/freq;
 }
 
+/**
+ * \fn static inline void ss_set_duty(ss_config_t *SS, uint16_t duty)
+ * \brief Set the brightness of the display as the duty of the multiplexing
+ * \param SS        pointer to seven segments displays data structure
+ * \param duty      Lit part of a slot, 1 to SS_DUTY_MAX
+ */
+static inline void ss_set_duty(ss_config_t *SS, uint16_t duty){
+    SS->duty = duty < 1 ? 1 : duty > SS_DUTY_MAX ? SS_DUTY_MAX : duty;
+}
+
+/**
+ * \fn static inline uint32_t ss_on_us(ss_config_t *SS)
+ * \brief Lit part of a slot in us at the current duty and refresh frequency
+ */
+static inline uint32_t ss_on_us(ss_config_t *SS){
+    uint32_t on = (uint32_t)SS->ssRefreshTB.delta * SS->duty / SS_DUTY_MAX;
+    return on < SS_DUTY_MIN_US ? SS_DUTY_MIN_US : on;
+}
+
 /**
  * \fn static inline void ss_enable_display_mask(ss_config_t *SS, uint32_t mask)
  * \brief
@@ -1,7 +1,19 @@
 /**
  * \file        SmartBuzzer.h
- * \brief       Define some utility methods to control a LED through a GPIO
- * \details
+ * \brief       Define some utility methods to control a buzzer through a GPIO or a PWM slice
+ * \details     A buzzer initialized with buzzer_init_pwm plays tones: the PWM slice generates the
+ * note frequency, the CPU only programs the divider and the wrap at the start of a note. Melodies
+ * are patterns of the shared pattern player (see Pattern.h) stored in flash, with a MIDI note
+ * (BZ_NOTE) as the level of a step and 0 as a rest; PAT_ON plays the default tone. The same
+ * patterns beep a GPIO buzzer on every note.
+ *
+ * The engine enforces the sound limits at note boundaries: a pattern is silenced and stopped at its
+ * first note after maxOnMs (60 s, the README limit), and buzzer_ring raises the volume from
+ * volStart to full volume over volRampMs. The volume is the duty cycle of the note, up to 50 %.
+ *
+ * The PWM slice of the buzzer may be shared with a PWM LED (GPIO 20 and 21 share slice 2): a tone
+ * changes the period of the slice, the level of the other channel is scaled to keep its duty.
+ * Tone changes are traced (TR_TONE), tools/wutrace.py --wav renders them to a WAV file.
  * \author      Ricardo Andres Velasquez Velez
  * \version     0.0.1
  * \date        05/10/2023
@@ -14,20 +26,115 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "hardware/gpio.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
 #include "pico/stdlib.h"
 #include "TimeBase.h"
+#include "OutputStage.h"
+#include "Pattern.h"
+#include "Trace.h"
+
+#define BUZZER_VOLUME_MAX 255       ///< Full volume, 50 % duty cycle
+#define BUZZER_MAX_ON_MS 60000      ///< Longest sound of a pattern, from the README
+#define BZ_NOTE_MAX 119             ///< Highest note, B8
+
+/// Semitones of an octave for BZ_NOTE
+enum { BZ_C, BZ_CS, BZ_D, BZ_DS, BZ_E, BZ_F, BZ_FS, BZ_G, BZ_GS, BZ_A, BZ_AS, BZ_B };
+
+#define BZ_NOTE(semitone, octave) (((octave) + 1) * 12 + (semitone))   ///< MIDI note, BZ_NOTE(BZ_A, 4) is 440 Hz
+
+/// Frequencies of the highest octave in 1/100 Hz, the lower octaves are divided by powers of 2
+static const uint32_t buzzerNoteCHz[12] = {
+    418601, 443492, 469864, 497803, 527404, 558765, 591991, 627193, 664488, 704000, 745862, 790213
+};
 
 typedef struct{
-    uint8_t numGPIO;            ///< GPIO to drive the LED
-    uint8_t ringFreq;          ///< Blink frequency in Hz
+    uint8_t numGPIO;            ///< GPIO to drive the buzzer
+    uint8_t ringFreq;           ///< Ring frequency in Hz
     uint32_t beepPeriod;        ///< Pulse period in us
-    time_base_t ringTB;        ///< time base for managing blinking feature
-    time_base_t beepTB;        ///< time base for controling pulse feature
+    pat_channel_t pat;          ///< Pattern channel for beeps, ringing, melodies and buzzer_play
+    bool pwm;                   ///< Tones from a PWM slice, see buzzer_init_pwm
+    uint8_t tone;               ///< Note of PAT_ON and buzzer_on on a PWM buzzer
+    uint8_t volStart;           ///< Volume at the start of buzzer_ring, 1 to BUZZER_VOLUME_MAX
+    uint32_t volRampMs;         ///< Time of buzzer_ring to reach full volume
+    uint32_t maxOnMs;           ///< Longest sound of a pattern in ms
+    uint64_t start;             ///< Start time of the running pattern
+    bool escalate;              ///< The running pattern was started by buzzer_ring
+    uint16_t hz;                ///< Sounding frequency, 0 when silent
+    uint8_t volume;             ///< Volume of the sounding note
 }buzzer_t;
 
+/**
+ * \fn static void buzzer_tone(buzzer_t * B, uint8_t note, uint8_t volume)
+ * \brief Program the PWM slice for a note, keeping the duty cycle of the other channel
+ * \param B Pointer to the buzzer data structure
+ * \param note MIDI note up to BZ_NOTE_MAX, 0 for silence
+ * \param volume Volume from 0 to BUZZER_VOLUME_MAX
+ */
+static void buzzer_tone(buzzer_t * B, uint8_t note, uint8_t volume){
+    uint8_t chan = pwm_gpio_to_channel(B->numGPIO);
+    pwm_slice_hw_t * S = &pwm_hw->slice[pwm_gpio_to_slice_num(B->numGPIO)];
+    uint32_t cHz = 0;
+    if(note){
+        if(note > BZ_NOTE_MAX)
+            note = BZ_NOTE_MAX;
+        cHz = buzzerNoteCHz[note % 12] >> (9 - note / 12);
+    }
+    uint32_t save = save_and_disable_interrupts();  ///< The LED of the other channel steps in a timer interrupt
+    uint32_t level = 0;
+    uint32_t other = chan ? S->cc & 0xFFFF : S->cc >> 16;
+    if(cHz && volume){
+        uint64_t period16 = (uint64_t)clock_get_hz(clk_sys) * 1600 / cHz;  ///< Period in 1/16 clk_sys cycles
+        uint32_t div16 = (period16 + 0xFFFF) >> 16;     ///< Smallest divider for a 16 bit wrap, 4 fraction bits
+        if(div16 < 16)
+            div16 = 16;
+        if(div16 > 0xFFF)
+            div16 = 0xFFF;
+        uint64_t top = period16 / div16;
+        if(top > 0x10000)
+            top = 0x10000;
+        other = (other * top + S->top / 2) / (S->top + 1);   ///< Same duty for the other channel, rounded
+        S->div = div16;                                 ///< DIV is INT.FRAC with 4 fraction bits
+        S->top = top - 1;
+        level = (top * volume) >> 9;
+    }
+    S->cc = chan ? other | level << 16 : level | other << 16;
+    restore_interrupts(save);
+    uint16_t hz = level ? cHz / 100 : 0;
+    if(hz != B->hz || volume != B->volume)
+        TRACE(TR_TONE, level ? volume : 0, hz);
+    B->hz = hz;
+    B->volume = level ? volume : 0;
+}
+
+/**
+ * \fn static void buzzer_put(void * dev, uint8_t level)
+ * \brief Output of the buzzer for the pattern player, enforces the time limit and the volume ramp
+ * \param dev Pointer to the buzzer data structure
+ * \param level Note, 0 for a rest, any level above BZ_NOTE_MAX plays the default tone
+ */
+static void buzzer_put(void * dev, uint8_t level){
+    buzzer_t * B = (buzzer_t *)dev;
+    uint64_t t = tb_now() - B->start;
+    if(t >= (uint64_t)B->maxOnMs * 1000){           ///< Time limit, silence and end the pattern
+        pat_stop(&B->pat);
+        level = 0;
+    }
+    if(!B->pwm){
+        out_put(B->numGPIO, level);
+        return;
+    }
+    uint8_t volume = BUZZER_VOLUME_MAX;
+    uint64_t ramp = (uint64_t)B->volRampMs * 1000;
+    if(B->escalate && t < ramp)
+        volume = B->volStart + (BUZZER_VOLUME_MAX - B->volStart) * t / ramp;
+    buzzer_tone(B, level > BZ_NOTE_MAX ? B->tone : level, volume);
+}
+
 /**
  * \fn void buzzer_init(buzzer_t * B, uint8_t numGPIO)
- * \brief Initialize the buzzer data struct: members, GPIO, time bases 
+ * \brief Initialize the buzzer data struct: members, GPIO, pattern channel
  * \param B Pointer to the buzzer data structure
  * \param numGPIO GPIO used to drive the buzzer
  */
@@ -36,71 +143,89 @@ void buzzer_init(buzzer_t * B, uint8_t numGPIO){
     B->numGPIO = numGPIO;                                           ///< Needed for all GPIO operations
     B->ringFreq = 1;                                                ///< Ring frequency is set to the default value of 2Hz
     B->beepPeriod = 1000000;                                        ///< Beep period is set to the default value of 1000000 us (1 s)
+    B->pwm = false;
+    B->tone = BZ_NOTE(BZ_A, 6);                                     ///< 1760 Hz, near the resonance of small piezos
+    B->volStart = BUZZER_VOLUME_MAX / 8;
+    B->volRampMs = 30000;
+    B->maxOnMs = BUZZER_MAX_ON_MS;
+    B->start = 0;
+    B->escalate = false;
+    B->hz = 0;
+    B->volume = 0;
     gpio_init( B->numGPIO);                                         ///< Initialize GPIO
     gpio_set_drive_strength(B->numGPIO,GPIO_DRIVE_STRENGTH_12MA);   ///< Set driving current to the maximum value
     gpio_set_dir(B->numGPIO,true);                                  ///< Configure the GPIO to output direction
     gpio_put(B->numGPIO,false);                                     ///< Write 0 to the GPIO
 
-    tb_init(&B->ringTB,1000000/(2*B->ringFreq),false);              ///< Initialize the time base for Ring feature
-    tb_init(&B->beepTB,1000000,false);                              ///< Initialize the time base for Beep feature
+    pat_attach(&patPlayer, &B->pat, buzzer_put, B);                 ///< Beeps and ringing are played by the pattern player
 }
 
 /**
- * \fn void buzzer_process(buzzer_t * B)
- * \brief call this method in the state or main loop to process both Beep and Ringing features
+ * \fn void buzzer_init_pwm(buzzer_t * B, uint8_t numGPIO)
+ * \brief Initialize a buzzer that plays tones from the PWM slice of its GPIO, silent
  * \param B Pointer to the buzzer data structure
+ * \param numGPIO GPIO used to drive the buzzer
+ * \note A PWM LED on the other channel of the slice must be initialized before the buzzer
  */
-
-void BED_process(buzzer_t * B){
-    if(tb_check(&B->ringTB)){                     ///< process ringing
-        gpio_xor_mask(0x00000001 << B->numGPIO);
-        tb_next(&B->ringTB);
-    }
-    if(tb_check(&B->beepTB)){                     ///< process beep
-        gpio_put(B->numGPIO, false);
-        tb_disable(&B->beepTB);
-    }
+void buzzer_init_pwm(buzzer_t * B, uint8_t numGPIO){
+    buzzer_init(B, numGPIO);
+    B->pwm = true;
+    pwm_set_chan_level(pwm_gpio_to_slice_num(numGPIO), pwm_gpio_to_channel(numGPIO), 0);
+    pwm_set_enabled(pwm_gpio_to_slice_num(numGPIO), true);
+    gpio_set_function(numGPIO, GPIO_FUNC_PWM);
 }
 
 /**
- * \fn void buzzer_process_ring(buzzer_t * B)
- * \brief call this method in a FSM state or main loop to process only the ringing feature
+ * \fn static inline void buzzer_on(buzzer_t * B)
+ * \brief call this method to turn ON the buzzer sound
  * \param B Pointer to the buzzer data structure
  */
-void buzzer_process_ring(buzzer_t * B){
-    if(tb_check(&B->ringTB)){
-        gpio_xor_mask(0x00000001 << B->numGPIO);
-        tb_next(&B->ringTB);
-    }
+static inline void buzzer_on(buzzer_t * B){
+    if(B->pwm)
+        buzzer_tone(B, B->tone, BUZZER_VOLUME_MAX);
+    else
+        out_put(B->numGPIO,true);
 }
-
 /**
- * \fn void buzzer_process_beep(buzzer_t * B)
- * \brief call this method in a FSM state or main loop to process only the beep feature
+ * \fn static inline void buzzer_off(buzzer_t * B)
+ * \brief call this method to turn OFF the buzzer sound
  * \param B Pointer to the buzzer data structure
  */
-void buzzer_process_beep(buzzer_t * B){
-    if(tb_check(&B->beepTB)){
-        gpio_put(B->numGPIO, false);
-        tb_disable(&B->beepTB);
-    }
+static inline void buzzer_off(buzzer_t * B){
+    if(B->pwm)
+        buzzer_tone(B, 0, 0);
+    else
+        out_put(B->numGPIO,false);
 }
 
 /**
- * \fn static inline void buzzer_on(buzzer_t * B)
- * \brief call this method to turn ON the buzzer sound
+ * \fn static inline void buzzer_start(buzzer_t * B, const uint8_t * pattern, uint32_t unitUs, bool escalate)
+ * \brief Start a pattern, the time limit counts from now
+ */
+static inline void buzzer_start(buzzer_t * B, const uint8_t * pattern, uint32_t unitUs, bool escalate){
+    B->start = tb_now();
+    B->escalate = escalate;
+    pat_play(&patPlayer, &B->pat, pattern, unitUs);
+}
+
+/**
+ * \fn static inline void buzzer_play(buzzer_t * B, const uint8_t * pattern)
+ * \brief Play a pattern on the buzzer with units of PAT_UNIT_US, see Pattern.h
  * \param B Pointer to the buzzer data structure
+ * \param pattern Byte-code of the pattern
  */
-static inline void buzzer_on(buzzer_t * B){
-    gpio_put(B->numGPIO,true);
+static inline void buzzer_play(buzzer_t * B, const uint8_t * pattern){
+    buzzer_start(B, pattern, PAT_UNIT_US, false);
 }
+
 /**
- * \fn static inline void buzzer_off(buzzer_t * B)
- * \brief call this method to turn OFF the buzzer sound
+ * \fn static inline void buzzer_ring(buzzer_t * B, const uint8_t * melody)
+ * \brief Play an alarm melody with units of PAT_UNIT_US, the volume rises from volStart over volRampMs
  * \param B Pointer to the buzzer data structure
+ * \param melody Byte-code of the melody, it ends by itself after maxOnMs
  */
-static inline void buzzer_off(buzzer_t * B){
-    gpio_put(B->numGPIO,false);
+static inline void buzzer_ring(buzzer_t * B, const uint8_t * melody){
+    buzzer_start(B, melody, PAT_UNIT_US, true);
 }
 
 /**
@@ -109,9 +234,7 @@ static inline void buzzer_off(buzzer_t * B){
  * \param B Pointer to the buzzer data structure
  */
 static inline void buzzer_beep(buzzer_t * B){
-    tb_update(&B->beepTB);
-    tb_enable(&B->beepTB);
-    gpio_put(B->numGPIO,true);
+    buzzer_start(B, patPulseOn, B->beepPeriod, false);
 }
 
 /**
@@ -120,19 +243,39 @@ static inline void buzzer_beep(buzzer_t * B){
  * \param B Pointer to the buzzer data structure
  */
 static inline void buzzer_start_ring(buzzer_t * B){
-    tb_update(&B->ringTB);
-    tb_enable(&B->ringTB);
-    gpio_put(B->numGPIO,true);
+    buzzer_start(B, patBlink, 1000000/(2*B->ringFreq), false);
 }
 
 /**
  * \fn static inline void buzzer_stop_ring(buzzer_t * B)
- * \brief Call this method to make the buzzer stop ringing.
+ * \brief Call this method to make the buzzer stop ringing, or playing a pattern.
  * \param B Pointer to the buzzer data structure
  */
 static inline void buzzer_stop_ring(buzzer_t * B){
-    tb_disable(&B->ringTB);
-    gpio_put(B->numGPIO,false);
+    pat_stop(&B->pat);
+    buzzer_off(B);
+}
+
+/**
+ * \fn static inline void buzzer_set_tone(buzzer_t * B, uint8_t note)
+ * \brief Set the note of buzzer_on and PAT_ON on a PWM buzzer, applies from the next note
+ * \param B Pointer to the buzzer data structure
+ * \param note MIDI note from 1 to BZ_NOTE_MAX, see BZ_NOTE
+ */
+static inline void buzzer_set_tone(buzzer_t * B, uint8_t note){
+    B->tone = note;
+}
+
+/**
+ * \fn static inline void buzzer_set_escalation(buzzer_t * B, uint8_t volStart, uint32_t rampMs)
+ * \brief Set the volume ramp of buzzer_ring
+ * \param B Pointer to the buzzer data structure
+ * \param volStart Volume of the first notes, 1 to BUZZER_VOLUME_MAX
+ * \param rampMs Time to reach full volume in ms, 0 for full volume from the start
+ */
+static inline void buzzer_set_escalation(buzzer_t * B, uint8_t volStart, uint32_t rampMs){
+    B->volStart = volStart;
+    B->volRampMs = rampMs;
 }
 
 /**
@@ -143,41 +286,39 @@ static inline void buzzer_stop_ring(buzzer_t * B){
  */
 static inline void buzzer_set_beep_period(buzzer_t * B,uint32_t period){
     B->beepPeriod = period;
-    B->beepTB.delta = period;
 }
 
 /**
  * \fn static inline void buzzer_set_ring_freq(buzzer_t * B,uint32_t freq)
  * \brief Call this method to setup the ring frequency.
  * \param B Pointer to the buzzer data structure
- * \param freq New ring frequency in Hz. By default the frequency is set to 1 Hz.
+ * \param freq New ring frequency in Hz. By default the frequency is set to 1 Hz. Applies from the next buzzer_start_ring.
  */
 static inline void buzzer_set_ring_freq(buzzer_t * B,uint32_t freq){
     B->ringFreq = freq;
-    B->ringTB.delta = 1000000/(2*freq);
 }
 
 void testBuzzer(uint8_t numGPIO){
     buzzer_t B;
     buzzer_init(&B,numGPIO);
     printf("TESTING BUZZZER!!!\n");
-    sleep_ms(1000);
+    out_sleep_ms(1000);
     printf("Turn ON buzzer\n");
     buzzer_on(&B);
-    sleep_ms(2000);
+    out_sleep_ms(2000);
     printf("Turn OFF buzzer\n");
     buzzer_off(&B);
-    sleep_ms(2000);
+    out_sleep_ms(2000);
         
     printf("Buzzer Beep 0.5 seconds\n");
     buzzer_set_beep_period(&B,500000);
     buzzer_beep(&B);
     uint16_t cnt = 0;
     while(cnt<=2000){
-        buzzer_process_beep(&B);
+        pat_process(&patPlayer);
         cnt++;
         printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
     }
 
     printf("Buzzer Beep 3 seconds\n");
@@ -185,10 +326,10 @@ void testBuzzer(uint8_t numGPIO){
     buzzer_beep(&B);
     cnt = 0;
     while(cnt<=5000){
-        buzzer_process_beep(&B);
+        pat_process(&patPlayer);
         cnt++;
         printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
     }
 
     printf("Buzzer rings during 10 seconds at 2 Hz");
@@ -196,15 +337,55 @@ void testBuzzer(uint8_t numGPIO){
     buzzer_start_ring(&B);
     cnt = 0;
     while(cnt<=12000){
-        buzzer_process_ring(&B);
+        pat_process(&patPlayer);
         cnt++;
         if(!(cnt%1000))
             printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
         if(cnt==10000){
             buzzer_stop_ring(&B);
         }
     }
+    pat_detach(&patPlayer, &B.pat);
+}
+
+/**
+ * \fn void testBuzzerTone(uint8_t numGPIO)
+ * \brief Exercise the PWM tones: a scale, the default tone and an escalating melody cut at 10 s
+ * \param numGPIO GPIO of the buzzer
+ */
+void testBuzzerTone(uint8_t numGPIO){
+    static const uint8_t scale[] = {
+        PAT_STEP(BZ_NOTE(BZ_C, 5), 25), PAT_STEP(BZ_NOTE(BZ_D, 5), 25), PAT_STEP(BZ_NOTE(BZ_E, 5), 25),
+        PAT_STEP(BZ_NOTE(BZ_F, 5), 25), PAT_STEP(BZ_NOTE(BZ_G, 5), 25), PAT_STEP(BZ_NOTE(BZ_A, 5), 25),
+        PAT_STEP(BZ_NOTE(BZ_B, 5), 25), PAT_STEP(BZ_NOTE(BZ_C, 6), 50), PAT_END(0)
+    };
+    static const uint8_t melody[] = {
+        PAT_MARK, PAT_STEP(BZ_NOTE(BZ_E, 6), 10), PAT_STEP(BZ_NOTE(BZ_A, 6), 10), PAT_OFF(30), PAT_REPEAT
+    };
+    buzzer_t B;
+    buzzer_init_pwm(&B,numGPIO);
+    printf("TESTING BUZZER TONES!!!\n");
+    printf("Default tone during 1 second\n");
+    buzzer_on(&B);
+    sleep_ms(1000);
+    buzzer_off(&B);
+    printf("C major scale\n");
+    buzzer_play(&B,scale);
+    while(pat_is_playing(&B.pat)){
+        pat_process(&patPlayer);
+        sleep_ms(1);
+    }
+    printf("Melody rising to full volume in 5 seconds, ends by itself at 10 seconds\n");
+    B.maxOnMs = 10000;
+    buzzer_set_escalation(&B,BUZZER_VOLUME_MAX/8,5000);
+    buzzer_ring(&B,melody);
+    while(pat_is_playing(&B.pat)){
+        pat_process(&patPlayer);
+        sleep_ms(1);
+    }
+    printf("Silent: %s\n", B.hz ? "NO" : "YES");
+    pat_detach(&patPlayer, &B.pat);
 }
 
 #endif
\ No newline at end of file
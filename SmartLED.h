@@ -1,7 +1,15 @@
 /**
  * \file        SmartLED.h
  * \brief       Define some utility methods to control a LED through a GPIO
- * \details
+ * \details     A LED initialized with sLED_init is switched by the superloop through the output stage.
+ * A LED initialized with sLED_init_pwm is driven by a PWM slice with 256 brightness levels, mapped
+ * to duty cycles by a gamma table in flash. Its effects (fades, breathing and blinking) run in a
+ * repeating timer interrupt that moves the level by a fixed amount per step and turns at the ends:
+ * the cost of a step is one table read and one register write, whatever the effect, and the
+ * superloop jitter does not reach the LED. on/off/toggle/pulse/blink work with both backends.
+ *
+ * Pulses, the blinking of GPIO LEDs and any pattern of sLED_play are played by the shared pattern
+ * player (see Pattern.h), the superloop calls pat_process instead of a process method per LED.
  * \author      Ricardo Andres Velasquez Velez
  * \version     0.0.1
  * \date        05/10/2023
@@ -14,70 +22,215 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "hardware/gpio.h"
+#include "hardware/pwm.h"
 #include "pico/stdlib.h"
 #include "TimeBase.h"
+#include "OutputStage.h"
+#include "Pattern.h"
+
+#define SLED_LEVEL_MAX 255             ///< Full brightness of a PWM LED
+#define SLED_PWM_TOP 0xFFFE             ///< PWM wrap, level 65535 of the gamma table keeps the output high
+#define SLED_FX_MIN_STEP_US 2000        ///< Shortest effect step, faster effects move more levels per step
 
 typedef struct{
     uint8_t numGPIO;            ///< GPIO to drive the LED
     uint8_t blinkFreq;          ///< Blink frequency in Hz
     uint32_t pulsePeriod;        ///< Pulse period in us
-    time_base_t blinkTB;        ///< time base for managing blinking feature
-    time_base_t pulseTB;        ///< time base for controling pulse feature
+    pat_channel_t pat;          ///< Pattern channel for pulses, blinking and sLED_play
+    bool pwm;                   ///< Driven by a PWM slice, see sLED_init_pwm
+    volatile uint8_t level;     ///< Brightness, 0 to SLED_LEVEL_MAX, a GPIO LED is ON for any level but 0
+    volatile bool fxOn;         ///< An effect timer is running
+    uint8_t fxTo;               ///< Level where the effect turns or ends
+    uint8_t fxFrom;             ///< Other end of a breathing effect
+    int16_t fxDelta;            ///< Level change per step, negative when dimming
+    bool fxLoop;                ///< Turn at the ends (breathing, blinking) instead of ending
+    repeating_timer_t fxTimer;  ///< Timer of the effect steps
 }smart_led_t;
 
+/// Duty cycle of every brightness level, gamma 2.2 over 16 bits
+static const uint16_t sLEDGamma[SLED_LEVEL_MAX + 1] = {
+    0, 0, 2, 4, 7, 11, 17, 24, 32, 42, 53, 65,
+    79, 94, 111, 129, 148, 169, 192, 216, 242, 270, 299, 330,
+    362, 396, 432, 469, 508, 549, 591, 635, 681, 729, 779, 830,
+    883, 938, 995, 1053, 1113, 1175, 1239, 1305, 1373, 1443, 1514, 1587,
+    1663, 1740, 1819, 1900, 1983, 2068, 2155, 2243, 2334, 2427, 2521, 2618,
+    2717, 2817, 2920, 3024, 3131, 3240, 3350, 3463, 3578, 3694, 3813, 3934,
+    4057, 4182, 4309, 4438, 4570, 4703, 4838, 4976, 5115, 5257, 5401, 5547,
+    5695, 5845, 5998, 6152, 6309, 6468, 6629, 6792, 6957, 7124, 7294, 7466,
+    7640, 7816, 7994, 8175, 8358, 8543, 8730, 8919, 9111, 9305, 9501, 9699,
+    9900, 10102, 10307, 10515, 10724, 10936, 11150, 11366, 11585, 11806, 12029, 12254,
+    12482, 12712, 12944, 13179, 13416, 13655, 13896, 14140, 14386, 14635, 14885, 15138,
+    15394, 15652, 15912, 16174, 16439, 16706, 16975, 17247, 17521, 17798, 18077, 18358,
+    18642, 18928, 19216, 19507, 19800, 20095, 20393, 20694, 20996, 21301, 21609, 21919,
+    22231, 22546, 22863, 23182, 23504, 23829, 24156, 24485, 24817, 25151, 25487, 25826,
+    26168, 26512, 26858, 27207, 27558, 27912, 28268, 28627, 28988, 29351, 29717, 30086,
+    30457, 30830, 31206, 31585, 31966, 32349, 32735, 33124, 33514, 33908, 34304, 34702,
+    35103, 35507, 35913, 36321, 36732, 37146, 37562, 37981, 38402, 38825, 39252, 39680,
+    40112, 40546, 40982, 41421, 41862, 42306, 42753, 43202, 43654, 44108, 44565, 45025,
+    45487, 45951, 46418, 46888, 47360, 47835, 48313, 48793, 49275, 49761, 50249, 50739,
+    51232, 51728, 52226, 52727, 53230, 53736, 54245, 54756, 55270, 55787, 56306, 56828,
+    57352, 57879, 58409, 58941, 59476, 60014, 60554, 61097, 61642, 62190, 62741, 63295,
+    63851, 64410, 64971, 65535,
+};
+
+/**
+ * \fn static inline void sLED_set_level(smart_led_t * SL, uint8_t level)
+ * \brief Set the brightness of a PWM LED, the effect running is not stopped
+ * \param SL Pointer to smart led data structure
+ * \param level Brightness from 0 to SLED_LEVEL_MAX
+ */
+static inline void sLED_set_level(smart_led_t * SL, uint8_t level){
+    SL->level = level;
+    uint32_t top = pwm_hw->slice[pwm_gpio_to_slice_num(SL->numGPIO)].top;  ///< A buzzer tone may share the slice, see SmartBuzzer.h
+    pwm_set_gpio_level(SL->numGPIO, ((uint32_t)sLEDGamma[level] * (top + 1) + 0xFFFF) >> 16);
+}
+
+/**
+ * \fn static void sLED_put(void * dev, uint8_t level)
+ * \brief Output of the LEDs for the pattern player and the LED methods
+ * \param dev Pointer to smart led data structure
+ * \param level Brightness, a GPIO LED is ON for any level but 0
+ */
+static void sLED_put(void * dev, uint8_t level){
+    smart_led_t * SL = (smart_led_t *)dev;
+    if(SL->pwm){
+        sLED_set_level(SL, level);
+        return;
+    }
+    SL->level = level;
+    out_put(SL->numGPIO, level);
+}
+
 /// @brief Initialize a gpio to drive a LED
 /// @param SL Pointer to smart led data structure
 void sLED_init(smart_led_t * SL, uint8_t numGPIO){
     SL->numGPIO = numGPIO;
     SL->blinkFreq = 1;
     SL->pulsePeriod = 1000000;
+    SL->pwm = false;
+    SL->fxOn = false;
+    SL->level = 0;
     gpio_init( SL->numGPIO); // gpios for key rows 2,3,4,5
     gpio_set_drive_strength(SL->numGPIO,GPIO_DRIVE_STRENGTH_12MA);
     gpio_set_dir(SL->numGPIO,true); // rows as outputs and cols as inputs
     gpio_put(SL->numGPIO,false);
 
-    tb_init(&SL->blinkTB,1000000/(2*SL->blinkFreq),false);
-    tb_init(&SL->pulseTB,1000000,false);
+    pat_attach(&patPlayer, &SL->pat, sLED_put, SL);
 }
 
 /**
- * \fn void sLED_process(smart_led_t * SL)
- * \brief call this method in the state or main loop to process both pulse and blinking features
+ * \fn void sLED_init_pwm(smart_led_t * SL, uint8_t numGPIO)
+ * \brief Initialize a LED driven by the PWM slice of its GPIO, the LED starts OFF
  * \param SL Pointer to smart led data structure
+ * \param numGPIO GPIO of the LED, its PWM channel must not be used by other outputs
  */
+void sLED_init_pwm(smart_led_t * SL, uint8_t numGPIO){
+    if(SL->pwm && SL->fxOn)                         ///< Initialized again, stop the effect timer first
+        cancel_repeating_timer(&SL->fxTimer);
+    sLED_init(SL, numGPIO);
+    SL->pwm = true;
+    pwm_config cfg = pwm_get_default_config();
+    pwm_config_set_wrap(&cfg, SLED_PWM_TOP);        ///< About 1.9 kHz at 125 MHz
+    pwm_init(pwm_gpio_to_slice_num(numGPIO), &cfg, true);
+    sLED_set_level(SL, 0);
+    gpio_set_function(numGPIO, GPIO_FUNC_PWM);
+}
 
-void sLED_process(smart_led_t * SL){
-    if(tb_check(&SL->blinkTB)){                     ///< process blinking
-        gpio_xor_mask(0x00000001 << SL->numGPIO);
-        tb_next(&SL->blinkTB);
+/**
+ * \fn static bool sLED_fx_step(repeating_timer_t * rt)
+ * \brief Effect step, runs in the timer interrupt
+ */
+static bool sLED_fx_step(repeating_timer_t * rt){
+    smart_led_t * SL = (smart_led_t *)rt->user_data;
+    int16_t level = SL->level + SL->fxDelta;
+    bool end = SL->fxDelta > 0 ? level >= SL->fxTo : level <= SL->fxTo;
+    if(!end){
+        sLED_set_level(SL, level);
+        return true;
     }
-    if(tb_check(&SL->pulseTB)){                     ///< process pulse
-        gpio_xor_mask(0x00000001 << SL->numGPIO);
-        tb_disable(&SL->pulseTB);
+    sLED_set_level(SL, SL->fxTo);
+    if(!SL->fxLoop){
+        SL->fxOn = false;
+        return false;
     }
+    SL->fxTo = SL->fxFrom;                          ///< Turn around
+    SL->fxFrom = SL->level;
+    SL->fxDelta = -SL->fxDelta;
+    return true;
 }
 
 /**
- * \fn void sLED_process_blink(smart_led_t * SL)
- * \brief call this method in a FSM state or main loop to process only the blinking feature
+ * \fn static inline void sLED_fx_stop(smart_led_t * SL)
+ * \brief Stop the effect of a PWM LED, the LED keeps its current level
  * \param SL Pointer to smart led data structure
  */
-void sLED_process_blink(smart_led_t * SL){
-    if(tb_check(&SL->blinkTB)){
-        gpio_xor_mask(0x00000001 << SL->numGPIO);
-        tb_next(&SL->blinkTB);
+static inline void sLED_fx_stop(smart_led_t * SL){
+    if(SL->fxOn){
+        cancel_repeating_timer(&SL->fxTimer);
+        SL->fxOn = false;
     }
 }
+
+/**
+ * \fn static void sLED_fx_run(smart_led_t * SL, uint8_t from, uint8_t to, int16_t delta, uint32_t stepUs, bool loop)
+ * \brief Start the effect timer, the level moves delta towards to every stepUs
+ */
+static void sLED_fx_run(smart_led_t * SL, uint8_t from, uint8_t to, int16_t delta, uint32_t stepUs, bool loop){
+    SL->fxFrom = from;
+    SL->fxTo = to;
+    SL->fxDelta = delta;
+    SL->fxLoop = loop;
+    SL->fxOn = add_repeating_timer_us(-(int64_t)stepUs, sLED_fx_step, SL, &SL->fxTimer);
+}
+
 /**
- * \fn void sLED_process_pulse(smart_led_t * SL)
- * \brief call this method in a FSM state or main loop to process only the pulse feature
+ * \fn void sLED_fx_start(smart_led_t * SL, uint8_t from, uint8_t to, uint32_t us, bool loop)
+ * \brief Start an effect on a PWM LED: move from one level to another in us, then stop or turn around
  * \param SL Pointer to smart led data structure
+ * \param from Start level
+ * \param to End level, or turning level when loop is true
+ * \param us Duration of the ramp from one end to the other
+ * \param loop Ramp back and forth until the effect is stopped
  */
-void sLED_process_pulse(smart_led_t * SL){
-    if(tb_check(&SL->pulseTB)){
-        gpio_xor_mask(0x00000001 << SL->numGPIO);
-        tb_disable(&SL->pulseTB);
+void sLED_fx_start(smart_led_t * SL, uint8_t from, uint8_t to, uint32_t us, bool loop){
+    sLED_fx_stop(SL);
+    pat_stop(&SL->pat);
+    sLED_set_level(SL, from);
+    uint16_t span = from > to ? from - to : to - from;
+    if(!span)
+        return;
+    uint32_t stepUs = us / span;
+    int16_t delta = 1;
+    if(stepUs < SLED_FX_MIN_STEP_US){               ///< Fast effect, several levels per step
+        uint32_t steps = us / SLED_FX_MIN_STEP_US;
+        steps = steps ? steps : 1;
+        delta = (span + steps - 1) / steps;
+        stepUs = us / ((span + delta - 1) / delta);
     }
+    sLED_fx_run(SL, from, to, from < to ? delta : -delta, stepUs, loop);
+}
+
+/**
+ * \fn static inline void sLED_fade(smart_led_t * SL, uint8_t to, uint32_t ms)
+ * \brief Fade a PWM LED from its current level to another one
+ * \param SL Pointer to smart led data structure
+ * \param to Final level
+ * \param ms Duration of the fade in ms
+ */
+static inline void sLED_fade(smart_led_t * SL, uint8_t to, uint32_t ms){
+    sLED_fx_start(SL, SL->level, to, ms * 1000, false);
+}
+
+/**
+ * \fn static inline void sLED_breathe(smart_led_t * SL, uint8_t low, uint8_t high, uint32_t periodMs)
+ * \brief Make a PWM LED breathe between two levels until it is stopped
+ * \param SL Pointer to smart led data structure
+ * \param low Lowest level
+ * \param high Highest level
+ * \param periodMs Duration of a complete breath, up and down, in ms
+ */
+static inline void sLED_breathe(smart_led_t * SL, uint8_t low, uint8_t high, uint32_t periodMs){
+    sLED_fx_start(SL, low, high, periodMs * 500, true);
 }
 
 /**
@@ -86,7 +239,8 @@ void sLED_process_pulse(smart_led_t * SL){
  * \param SL Pointer to smart led data structure
  */
 static inline void sLED_on(smart_led_t * SL){
-    gpio_put(SL->numGPIO,true);
+    sLED_fx_stop(SL);
+    sLED_put(SL, SLED_LEVEL_MAX);
 }
 /**
  * \fn static inline void sLED_off(smart_led_t * SL)
@@ -94,7 +248,8 @@ static inline void sLED_on(smart_led_t * SL){
  * \param SL Pointer to smart led data structure
  */
 static inline void sLED_off(smart_led_t * SL){
-    gpio_put(SL->numGPIO,false);
+    sLED_fx_stop(SL);
+    sLED_put(SL, 0);
 }
 
 /**
@@ -103,7 +258,19 @@ static inline void sLED_off(smart_led_t * SL){
  * \param SL Pointer to smart LED data structure
  */
 static inline void sLED_toggle(smart_led_t * SL){
-    gpio_xor_mask(0x00000001 << SL->numGPIO);
+    sLED_fx_stop(SL);
+    sLED_put(SL, SL->level ? 0 : SLED_LEVEL_MAX);
+}
+
+/**
+ * \fn static inline void sLED_play(smart_led_t * SL, const uint8_t * pattern)
+ * \brief Play a pattern on the LED with units of PAT_UNIT_US, see Pattern.h
+ * \param SL Pointer to smart LED data structure
+ * \param pattern Byte-code of the pattern
+ */
+static inline void sLED_play(smart_led_t * SL, const uint8_t * pattern){
+    sLED_fx_stop(SL);
+    pat_play(&patPlayer, &SL->pat, pattern, PAT_UNIT_US);
 }
 
 /**
@@ -114,19 +281,25 @@ static inline void sLED_toggle(smart_led_t * SL){
  * \param SL Pointer to smart LED data structure
  */
 static inline void sLED_pulse(smart_led_t * SL){
-    tb_update(&SL->pulseTB);
-    tb_enable(&SL->pulseTB);
-    gpio_xor_mask(0x00000001 << SL->numGPIO);
+    sLED_fx_stop(SL);
+    pat_play(&patPlayer, &SL->pat, SL->level ? patPulseOff : patPulseOn, SL->pulsePeriod);
 }
 
 /**
  * \fn static inline void sLED_start_blink(smart_led_t * SL)
  * \brief Call this method to make the LED blink with the configured blinking frequency.
+ * \details A PWM LED blinks from its effect timer, a GPIO LED from the pattern player.
  * \param SL Pointer to smart LED data structure
  */
 static inline void sLED_start_blink(smart_led_t * SL){
-    tb_update(&SL->blinkTB);
-    tb_enable(&SL->blinkTB);
+    if(SL->pwm){
+        uint8_t to = SL->level ? 0 : SLED_LEVEL_MAX;    ///< Full swing steps, a square wave
+        sLED_fx_stop(SL);
+        pat_stop(&SL->pat);
+        sLED_fx_run(SL, SLED_LEVEL_MAX - to, to, to ? SLED_LEVEL_MAX : -SLED_LEVEL_MAX, 1000000/(2*SL->blinkFreq), true);
+        return;
+    }
+    pat_play(&patPlayer, &SL->pat, patBlink, 1000000/(2*SL->blinkFreq));
 }
 
 /**
@@ -136,8 +309,9 @@ static inline void sLED_start_blink(smart_led_t * SL){
  * \param value final state of the LED after blinking TRUE->ON, FALSE->OFF
  */
 static inline void sLED_stop_blink(smart_led_t * SL, bool value){
-    tb_disable(&SL->blinkTB);
-    gpio_put(SL->numGPIO,value);
+    sLED_fx_stop(SL);
+    pat_stop(&SL->pat);
+    sLED_put(SL, value ? SLED_LEVEL_MAX : 0);
 }
 
 /**
@@ -148,35 +322,33 @@ static inline void sLED_stop_blink(smart_led_t * SL, bool value){
  */
 static inline void sLED_set_pulse_period(smart_led_t * SL,uint32_t period){
     SL->pulsePeriod = period;
-    SL->pulseTB.delta = period;
 }
 
 /**
  * \fn static inline void sLED_set_blink_freq(smart_led_t * SL,uint32_t freq)
  * \brief Call this method to setup the blink frequency.
  * \param SL Pointer to smart LED data structure
- * \param freq New blink frequency in Hz. By default the frequency is set to 1 Hz.
+ * \param freq New blink frequency in Hz. By default the frequency is set to 1 Hz. Applies from the next sLED_start_blink.
  */
 static inline void sLED_set_blink_freq(smart_led_t * SL,uint32_t freq){
     SL->blinkFreq = freq;
-    SL->blinkTB.delta = 1000000/(2*freq);
 }
 
 void testLED(uint8_t numGPIO){
     smart_led_t SL;
     sLED_init(&SL,numGPIO);
     printf("TESTING LED!!!!\n");
-    sleep_ms(1000);
+    out_sleep_ms(1000);
     printf("Turn ON LED\n");
     sLED_on(&SL);
-    sleep_ms(2000);
+    out_sleep_ms(2000);
     printf("Turn OFF LED\n");
     sLED_off(&SL);
-    sleep_ms(2000);
+    out_sleep_ms(2000);
     printf("Toggle LED 10 Times\n");
     for(int i=0;i<10;i++){
         sLED_toggle(&SL);
-        sleep_ms(1000);
+        out_sleep_ms(1000);
     }
     
     printf("Light ON Pulse 3 seconds\n");
@@ -185,10 +357,10 @@ void testLED(uint8_t numGPIO){
     sLED_pulse(&SL);
     uint16_t cnt = 0;
     while(cnt<=10000){
-        sLED_process_pulse(&SL);
+        pat_process(&patPlayer);
         cnt++;
         printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
     }
 
     printf("Light OFF Pulse 5 seconds\n");
@@ -197,11 +369,11 @@ void testLED(uint8_t numGPIO){
     sLED_pulse(&SL);
     cnt = 0;
     while(cnt<=10000){
-        sLED_process_pulse(&SL);
+        pat_process(&patPlayer);
         cnt++;
         if(!(cnt%1000))
             printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
     }
 
     printf("LED blinking during 10 seconds at 2 Hz, and it finishes ON");
@@ -210,11 +382,11 @@ void testLED(uint8_t numGPIO){
     sLED_start_blink(&SL);
     cnt = 0;
     while(cnt<=12000){
-        sLED_process_blink(&SL);
+        pat_process(&patPlayer);
         cnt++;
         if(!(cnt%1000))
             printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
         if(cnt==10000){
             sLED_stop_blink(&SL,true);
         }
@@ -226,15 +398,47 @@ void testLED(uint8_t numGPIO){
     sLED_start_blink(&SL);
     cnt = 0;
     while(cnt<=10000){
-        sLED_process_blink(&SL);
+        pat_process(&patPlayer);
         cnt++;
         if(!(cnt%1000))
             printf("%d sec\n",cnt);
-        sleep_ms(10);
+        out_sleep_ms(10);
         if(cnt==5000){
             sLED_stop_blink(&SL,false);
         }
     }
+    pat_detach(&patPlayer, &SL.pat);
+}
+
+/**
+ * \fn void testLEDPWM(uint8_t numGPIO)
+ * \brief Exercise the PWM backend: levels, fades, breathing and blinking
+ * \param numGPIO GPIO of the LED
+ */
+void testLEDPWM(uint8_t numGPIO){
+    smart_led_t SL;
+    SL.pwm = false;
+    sLED_init_pwm(&SL,numGPIO);
+    printf("TESTING PWM LED!!!!\n");
+    for(int level=0;level<=SLED_LEVEL_MAX;level+=51){
+        printf("Level %d\n",level);
+        sLED_set_level(&SL,level);
+        sleep_ms(1000);
+    }
+    printf("Fade OFF in 3 seconds, then ON in 3 seconds\n");
+    sLED_fade(&SL,0,3000);
+    sleep_ms(3500);
+    sLED_fade(&SL,SLED_LEVEL_MAX,3000);
+    sleep_ms(3500);
+    printf("Breathing during 10 seconds with a period of 2 seconds\n");
+    sLED_breathe(&SL,0,SLED_LEVEL_MAX,2000);
+    sleep_ms(10000);
+    printf("Blinking during 5 seconds at 4 Hz, and it finishes OFF\n");
+    sLED_set_blink_freq(&SL,4);
+    sLED_start_blink(&SL);
+    sleep_ms(5000);
+    sLED_stop_blink(&SL,false);
+    pat_detach(&patPlayer, &SL.pat);
 }
 
 #endif
\ No newline at end of file
@@ -17,6 +17,10 @@
 #include "hardware/rtc.h"
 #include "pico/types.h"
 #include "TimeBase.h"
+#include "Trace.h"
+#include "Calendar.h"
+#include "Holiday.h"
+#include "TimeZone.h"
 
 #ifndef PICO_INCLUDE_RTC_DATETIME
 typedef struct {
@@ -30,20 +34,149 @@ typedef struct {
 } datetime_t;
 #endif
 
+#define T4H_PHASE_US 2000 ///< Largest lag of the refresh after the RTC second
+
 typedef enum {T4H_DAILY_ALARM,T4H_WEEKLY_ALARM, T4H_DATE_ALARM} alarm_type_t;
 typedef enum {T4H_ALARM_READY,T4H_ALARM_ON, T4H_ALARM_OFF, T4H_ALARM_SUSPENDED} alarm_state_t;
 typedef enum {T4H_SUNDAY, T4H_MONDAY, T4H_TUESDAY, T4H_WEDNESDAY, T4H_THURSDAY, T4H_FRIDAY, T4H_SATURDAY} dotw_t;
 
 typedef struct{
-    datetime_t date; ///< Current date and time
+    datetime_t date; ///< Current local date and time, the RTC counts UTC (TimeZone.h)
     datetime_t alarm; ///< Alarm date and time
     alarm_type_t type; ///< Type of the alarm (daily, weekly, date)
     alarm_state_t state; ///< State of the alarm (ready, on, off, suspended)
     time_base_t postTB; ///< Time base for posting updates
-    time_base_t refreshTB; ///< Time base for refreshing the display
+    time_base_t refreshTB; ///< Time base for refreshing the display, phased just after the RTC second
+    int64_t rtcSecond; ///< UTC second of the last refresh, -1 before the first one
     uint8_t postPeriod; ///< Post period in minutes
+    bool skipHolidays; ///< Daily and weekly alarms do not ring on the holidays of holCalendar
 }time_h_t; ///< Time handler data structure
 
+static volatile bool t4hAlarmFired = false; ///< Set by the RTC alarm interrupt, consumed by t4h_refresh_time
+
+/**
+ * \fn static void t4h_rtc_alarm_callback(void)
+ * \brief RTC alarm interrupt callback. The SDK handler clears the interrupt before calling it,
+ * so the match is kept in t4hAlarmFired.
+ */
+static void t4h_rtc_alarm_callback(void){
+    t4hAlarmFired = true;
+}
+
+/// Simulated RTC of the soak test and the replay: UTC seconds counted on tb_now from a load
+typedef struct{
+    bool on;                ///< The time handler uses this RTC instead of the hardware one
+    int64_t utc;            ///< UTC time loaded, seconds since 01/01/1970
+    uint64_t loadUs;        ///< tb_now() at the load, the seconds restart there like the RTC divider
+    int64_t alarm;          ///< UTC time of the alarm
+    bool alarmOn;           ///< The alarm is compared
+    int64_t checked;        ///< Last second compared with the alarm
+    volatile bool fired;    ///< Alarm matched, t4hAlarmFired of the simulated RTC
+} t4h_sim_rtc_t;
+
+static t4h_sim_rtc_t t4hSimRtc;     ///< Off unless a soak test or a replay runs
+
+/**
+ * \fn static void t4h_sim_rtc(bool on)
+ * \brief Switch the time handler between the hardware RTC and the simulated one, the simulated alarm
+ * starts disarmed. A hardware alarm that matches meanwhile stays pending in t4hAlarmFired.
+ */
+static void t4h_sim_rtc(bool on){
+    t4hSimRtc.on = on;
+    t4hSimRtc.alarmOn = false;
+    t4hSimRtc.fired = false;
+}
+
+/**
+ * \fn static bool t4h_rtc_get(datetime_t * utc)
+ * \brief Read the UTC time of the RTC
+ * \returns false if the RTC is not running
+ */
+static bool t4h_rtc_get(datetime_t * utc){
+    t4h_sim_rtc_t *S = &t4hSimRtc;
+    if(!S->on)
+        return rtc_get_datetime(utc);
+    int64_t now = S->utc + (int64_t)((tb_now() - S->loadUs) / 1000000);
+    if(S->alarmOn && S->alarm > S->checked && S->alarm <= now)
+        S->fired = true;                    // The match interrupt of the hardware
+    S->checked = now;
+    cal_from_epoch(now, utc);
+    return true;
+}
+
+/**
+ * \fn static void t4h_rtc_set(const datetime_t * utc)
+ * \brief Load the RTC with a UTC time, the second restarts
+ */
+static void t4h_rtc_set(const datetime_t * utc){
+    t4h_sim_rtc_t *S = &t4hSimRtc;
+    if(!S->on){
+        rtc_set_datetime(utc);
+        return;
+    }
+    S->utc = cal_to_epoch(utc);
+    S->loadUs = tb_now();
+    S->checked = S->utc - 1;                // An alarm at the loaded second matches
+}
+
+/**
+ * \fn static void t4h_rtc_set_alarm(datetime_t * utc)
+ * \brief Arm the RTC alarm at a full UTC date and time
+ */
+static void t4h_rtc_set_alarm(datetime_t * utc){
+    if(!t4hSimRtc.on){
+        rtc_set_alarm(utc, t4h_rtc_alarm_callback);
+        return;
+    }
+    t4hSimRtc.alarm = cal_to_epoch(utc);
+    t4hSimRtc.alarmOn = true;
+}
+
+/**
+ * \fn static void t4h_rtc_enable_alarm(bool on)
+ * \brief Compare the alarm armed last again, or stop comparing it
+ */
+static void t4h_rtc_enable_alarm(bool on){
+    if(t4hSimRtc.on)
+        t4hSimRtc.alarmOn = on;
+    else if(on)
+        rtc_enable_alarm();
+    else
+        rtc_disable_alarm();
+}
+
+/**
+ * \fn static bool t4h_rtc_alarm_armed(void)
+ * \brief Check if the RTC alarm is compared
+ */
+static bool t4h_rtc_alarm_armed(void){
+    return t4hSimRtc.on ? t4hSimRtc.alarmOn : (rtc_hw->irq_setup_0 & RTC_IRQ_SETUP_0_MATCH_ENA_BITS) != 0;
+}
+
+/**
+ * \fn static bool t4h_rtc_alarm_fired(void)
+ * \brief Consume the alarm match of the RTC in use
+ */
+static bool t4h_rtc_alarm_fired(void){
+    volatile bool *fired = t4hSimRtc.on ? &t4hSimRtc.fired : &t4hAlarmFired;
+    if(!*fired)
+        return false;
+    *fired = false;
+    return true;
+}
+
+/**
+ * \fn static inline void t4h_set_alarm_state(time_h_t * T, alarm_state_t state)
+ * \brief Change the alarm state, every change is recorded in the trace
+ * \param T Pointer to time handler data structure
+ * \param state New alarm state
+ */
+static inline void t4h_set_alarm_state(time_h_t * T, alarm_state_t state){
+    if(T->state != state)
+        TRACE(TR_ALARM_STATE, state, T->state);
+    T->state = state;
+}
+
 /**
  * \fn void t4h_init(time_h_t * T)
  * \brief Initialize the time handler data structure
@@ -62,9 +195,11 @@ void t4h_init(time_h_t * T){
 
     T->type = T4H_DAILY_ALARM; // Default alarm type
     T->state = T4H_ALARM_OFF; // Alarm is initially off
+    T->skipHolidays = false; // Ring every day of the pattern
 
     tb_init(&T->postTB,300000000,false); // Initialize post time base with a period of 1 second
-    tb_init(&T->refreshTB,60000000,false); // Initialize refresh time base with a period of 1 second
+    tb_init(&T->refreshTB,1000000,true); // Initialize refresh time base with a period of 1 second
+    T->rtcSecond = -1; // The first refresh takes the RTC second, the next ones follow it
 
     T->postPeriod = 5; // Set post period in minutes
 }
@@ -166,7 +301,7 @@ void t4h_set_alarm_type(time_h_t * T, alarm_type_t type){
  * * \note The alarm state will be set to T4H_ALARM_ON.
  */
 void t4h_enable_alarm(time_h_t * T){
-    T->state = T4H_ALARM_ON;
+    t4h_set_alarm_state(T, T4H_ALARM_ON);
 }
 
 /**
@@ -177,7 +312,28 @@ void t4h_enable_alarm(time_h_t * T){
  * \note The alarm state will be set to T4H_ALARM_OFF.
  */
 void t4h_disable_alarm(time_h_t * T){
-    T->state = T4H_ALARM_OFF;
+    t4h_set_alarm_state(T, T4H_ALARM_OFF);
+}
+
+/**
+ * \fn void t4h_local_to_utc(const datetime_t * local, datetime_t * utc)
+ * \brief Convert a local date and time to the UTC base time of the RTC
+ */
+void t4h_local_to_utc(const datetime_t * local, datetime_t * utc){
+    cal_from_epoch(tz_to_utc(&tzZone, cal_to_epoch(local)), utc);
+}
+
+/**
+ * \fn bool t4h_read_local(datetime_t * local)
+ * \brief Read the RTC and convert its UTC time to local time
+ * \returns false if the RTC is not running, local is untouched
+ */
+bool t4h_read_local(datetime_t * local){
+    datetime_t utc;
+    if(!t4h_rtc_get(&utc))
+        return false;
+    cal_from_epoch(tz_local(&tzZone, cal_to_epoch(&utc)), local);
+    return true;
 }
 
 /**
@@ -185,10 +341,21 @@ void t4h_disable_alarm(time_h_t * T){
  * \brief Update the RTC time with the current time in the time handler
  * \param T Pointer to time handler data structure
  * \details This function updates the RTC with the current time stored in the time handler. 
- * It sets the RTC time to the values specified in the time handler's date and time fields.
+ * The local date and time of the handler are converted to UTC, the time the RTC counts.
  */
 void t4h_update_rtc_time(time_h_t * T){
-    rtc_set_datetime(&T->date);
+    datetime_t utc;
+    t4h_local_to_utc(&T->date, &utc);
+    t4h_rtc_set(&utc);
+}
+
+/**
+ * \fn void t4h_update_rtc_utc(time_h_t * T, const datetime_t * utc)
+ * \brief Load the RTC with a UTC time (host synchronization) and the handler with its local time
+ */
+void t4h_update_rtc_utc(time_h_t * T, const datetime_t * utc){
+    t4h_rtc_set(utc);
+    cal_from_epoch(tz_local(&tzZone, cal_to_epoch(utc)), &T->date);
 }
 
 
@@ -196,11 +363,107 @@ void t4h_update_rtc_time(time_h_t * T){
  * \fn void t4h_update_rtc_alarm(time_h_t * T)
  * \brief Update the RTC alarm with the current alarm in the time handler
  * \param T Pointer to time handler data structure
- * \details This function updates the RTC alarm with the current alarm settings stored in the time handler. 
- * It sets the RTC alarm to the values specified in the time handler's alarm fields.
+ * \details The RTC counts UTC and the alarm is in local time, so the RTC does not match the alarm
+ * fields: it is programmed with the full UTC date and time of the next occurrence (t4h_next_alarm
+ * after the current local time, holidays skipped), converted with the offset in force at that
+ * occurrence. The alarm follows the local time across DST transitions without reprogramming at
+ * the transition, but the next occurrence is programmed again after every match and after every
+ * change of the time, the alarm, the holidays or the zone. Without a next occurrence the RTC
+ * alarm is disabled.
  */
+int64_t t4h_next_alarm(time_h_t * T, int64_t from);
+
 void t4h_update_rtc_alarm(time_h_t * T){
-   // rtc_set_alarm(&T->alarm,);
+    datetime_t now, at;
+    int64_t next = t4h_read_local(&now) ? t4h_next_alarm(T, cal_to_epoch(&now) + 1) : -1;
+    if(next == -1){                            // None, an alarm matches at second 0 and before 1970 is negative
+        t4h_rtc_enable_alarm(false);
+        return;
+    }
+    cal_from_epoch(tz_to_utc(&tzZone, next), &at);
+    at.dotw = -1;                              // The date is compared, not the day of the week
+    t4h_rtc_set_alarm(&at);
+}
+
+/**
+ * \fn void t4h_get_alarm_pattern(time_h_t * T, datetime_t * pattern)
+ * \brief Build the match pattern of the alarm in local time, the fields that are not compared are -1
+ * \param T Pointer to time handler data structure
+ * \param pattern Pointer to the pattern: hh:mm:00 every day, plus the day of the week for a weekly
+ * alarm or the full date for a date alarm
+ */
+void t4h_get_alarm_pattern(time_h_t * T, datetime_t * pattern){
+    pattern->year = -1;
+    pattern->month = -1;
+    pattern->day = -1;
+    pattern->dotw = -1;
+    pattern->hour = T->alarm.hour;
+    pattern->min = T->alarm.min;
+    pattern->sec = 0;
+    if(T->type == T4H_WEEKLY_ALARM){
+        pattern->dotw = T->alarm.dotw;
+    }
+    else if(T->type == T4H_DATE_ALARM){
+        pattern->year = T->alarm.year;
+        pattern->month = T->alarm.month;
+        pattern->day = T->alarm.day;
+    }
+}
+
+/**
+ * \fn static inline bool t4h_alarm_skipped(time_h_t * T, int64_t day)
+ * \brief Check if a recurring alarm must stay silent on a day, one bit test of the holiday map
+ * \param T Pointer to time handler data structure
+ * \param day Days since 1970-01-01
+ */
+static inline bool t4h_alarm_skipped(time_h_t * T, int64_t day){
+    return T->skipHolidays && T->type != T4H_DATE_ALARM && hol_is_holiday(&holCalendar, day);
+}
+
+/**
+ * \fn bool t4h_alarm_match(time_h_t * T, const datetime_t * now)
+ * \brief Software model of the alarm match in local time, holidays skipped included
+ * \param T Pointer to time handler data structure
+ * \param now Local date and time to test
+ * \returns true if the alarm rings at now
+ */
+bool t4h_alarm_match(time_h_t * T, const datetime_t * now){
+    datetime_t p;
+    t4h_get_alarm_pattern(T, &p);
+    return (p.year < 0 || p.year == now->year) && (p.month < 0 || p.month == now->month)
+        && (p.day < 0 || p.day == now->day) && (p.dotw < 0 || p.dotw == now->dotw)
+        && p.hour == now->hour && p.min == now->min && p.sec == now->sec
+        && !t4h_alarm_skipped(T, cal_days_from_civil(now->year, now->month, now->day));
+}
+
+/**
+ * \fn int64_t t4h_next_alarm(time_h_t * T, int64_t from)
+ * \brief Compute the next time the alarm matches
+ * \param T Pointer to time handler data structure
+ * \param from Seconds since 1970-01-01 00:00:00 (cal_to_epoch) where the search starts
+ * \returns First match at or after from in the same scale, -1 if there is none up to year 4095
+ * \details A holiday skipped costs one bit test and one period more.
+ */
+int64_t t4h_next_alarm(time_h_t * T, int64_t from){
+    const int64_t last = (cal_days_from_civil(CAL_YEAR_MAX + 1, 1, 1)) * CAL_SECS_PER_DAY - 1;
+    int64_t tod = T->alarm.hour * 3600 + T->alarm.min * 60;
+    int64_t next;
+    if(T->type == T4H_DATE_ALARM){
+        datetime_t a = T->alarm;
+        a.sec = 0;
+        next = cal_is_valid(&a) ? cal_to_epoch(&a) : -1;
+        return (next >= from && next <= last) ? next : -1;
+    }
+    int64_t day = from / CAL_SECS_PER_DAY - (from % CAL_SECS_PER_DAY < 0);    ///< Floor division
+    if(day * CAL_SECS_PER_DAY + tod < from)
+        day++;
+    if(T->type == T4H_WEEKLY_ALARM)
+        day += ((T->alarm.dotw - (day + 4) % 7) % 7 + 14) % 7;             ///< 1970-01-01 was a Thursday
+    int64_t lastDay = last / CAL_SECS_PER_DAY;
+    while(day <= lastDay && t4h_alarm_skipped(T, day))
+        day += T->type == T4H_WEEKLY_ALARM ? 7 : 1;
+    next = day * CAL_SECS_PER_DAY + tod;
+    return next <= last ? next : -1;
 }
 
 /**
@@ -224,7 +487,7 @@ void t4h_set_post_period(time_h_t * T, uint8_t period){
 void t4h_start_post(time_h_t * T){
     tb_update(&T->postTB); // Update the post time base to start counting
     tb_enable(&T->postTB); // Enable the post time base
-    T->state = T4H_ALARM_SUSPENDED; // Set the alarm state to suspended while post is active
+    t4h_set_alarm_state(T, T4H_ALARM_SUSPENDED); // Set the alarm state to suspended while post is active
 }
 
 /**
@@ -236,20 +499,20 @@ void t4h_start_post(time_h_t * T){
 void t4h_stop_post(time_h_t * T){
     tb_disable(&T->postTB); // Disable the post time base
     if(T->type == T4H_DATE_ALARM) {
-        T->state = T4H_ALARM_OFF; // Set the alarm state to off after stopping post
-        rtc_disable_alarm(); // Disable the RTC alarm to prevent it from triggering
+        t4h_set_alarm_state(T, T4H_ALARM_OFF); // Set the alarm state to off after stopping post
+        t4h_rtc_enable_alarm(false); // Disable the RTC alarm to prevent it from triggering
     }
     else if(T->type == T4H_WEEKLY_ALARM) {
-        T->state = T4H_ALARM_ON; // Set the alarm state back to on after stopping post
-        rtc_enable_alarm(); // Re-enable the RTC alarm
+        t4h_set_alarm_state(T, T4H_ALARM_ON); // Set the alarm state back to on after stopping post
+        t4h_rtc_enable_alarm(true); // Re-enable the RTC alarm
     }
     else if(T->type == T4H_DAILY_ALARM) {
-        T->state = T4H_ALARM_ON; // Set the alarm state back to on after stopping post
-        rtc_enable_alarm(); // Re-enable the RTC alarm
+        t4h_set_alarm_state(T, T4H_ALARM_ON); // Set the alarm state back to on after stopping post
+        t4h_rtc_enable_alarm(true); // Re-enable the RTC alarm
     }
     else {
-        T->state = T4H_ALARM_OFF; // Default case, set the alarm state to off
-        rtc_disable_alarm(); // Disable the RTC alarm   
+        t4h_set_alarm_state(T, T4H_ALARM_OFF); // Default case, set the alarm state to off
+        t4h_rtc_enable_alarm(false); // Disable the RTC alarm
     }
 }
 
@@ -303,6 +566,19 @@ uint8_t t4h_get_second(time_h_t * T){
     return T->date.sec;
 }
 
+/**
+ * \fn void t4h_get_display_digits(time_h_t * T, uint8_t digits[4])
+ * \brief Get the hh:mm digits to show on a four digit display
+ * \param T Pointer to time handler data structure
+ * \param digits Digits from right to left: [0] minute units, [1] minute tens, [2] hour units, [3] hour tens
+ */
+void t4h_get_display_digits(time_h_t * T, uint8_t digits[4]){
+    digits[0] = T->date.min % 10;
+    digits[1] = T->date.min / 10;
+    digits[2] = T->date.hour % 10;
+    digits[3] = T->date.hour / 10;
+}
+
 /**
  * \fn uint8_t t4h_get_day(time_h_t * T)
  * \brief Get the current day from the time handler
@@ -354,19 +630,32 @@ uint16_t t4h_get_year(time_h_t * T);
  * This method controls the postpond feature through the postTB time base. When the alarm is postponed,
  * the postTB is enabled and will count the postponed period.
  * \note This function should be called in the main loop to keep the time handler's time synchronized with the RTC.
- * Time base refreshTB is used to control how often the time is refreshed.
+ * Time base refreshTB is used to control how often the time is refreshed: once per RTC second, at most
+ * T4H_PHASE_US after it. The refresh is planned T4H_PHASE_US before the next second and read again
+ * T4H_PHASE_US later while the RTC still shows the last second, so it follows the RTC phase after an
+ * RTC load and when the trimmed RTC and the timer drift apart. An RTC alarm match sets the alarm
+ * ready only when it is on, and the RTC alarm is armed again with the next occurrence.
  */
 bool t4h_refresh_time(time_h_t * T){
-    if(tb_check(&T->refreshTB)){
-        tb_next(&T->refreshTB);
-        if(rtc_hw->ints & RTC_INTS_RTC_BITS){
-            //rtc_hw->intr |= RTC_INTS_RTC_BITS; // Clear the RTC interrupt
-
-            T->state = T4H_ALARM_READY; // Set the alarm state to ready
+    if(!tb_check(&T->refreshTB))
+        return false; // Not time to refresh yet
+    datetime_t utc;
+    if(t4h_rtc_get(&utc)){
+        int64_t second = cal_to_epoch(&utc);
+        if(second == T->rtcSecond){
+            tb_after(&T->refreshTB, T4H_PHASE_US); // Ahead of the RTC second, read again a little later
+            return false;
         }
-        return true; // Time to refresh
+        T->rtcSecond = second;
+        cal_from_epoch(tz_local(&tzZone, second), &T->date); // Local time, a compare and an add between DST transitions
+    }
+    tb_after(&T->refreshTB, T->refreshTB.delta - T4H_PHASE_US); // Just before the next second, the RTC sets the phase
+    if(t4h_rtc_alarm_fired()){
+        if(T->state == T4H_ALARM_ON)
+            t4h_set_alarm_state(T, T4H_ALARM_READY); // A disabled or snoozed alarm does not ring
+        t4h_update_rtc_alarm(T); // Next occurrence, the RTC alarm is a single date (none for a date alarm)
     }
-    return false; // Not time to refresh yet
+    return true; // Time to refresh
 }
 
 
@@ -377,7 +666,113 @@ bool t4h_refresh_time(time_h_t * T){
  * \returns The current alarm state (T4H_ALARM_READY, T4H_ALARM_ON, T4H_ALARM_OFF, T4H_ALARM_SUSPENDED)
  */
 alarm_state_t t4h_get_alarm_state(time_h_t * T){
-    return T->state; // Return the current alarm state  
+    return T->state; // Return the current alarm state
+}
+
+/**
+ * \fn static bool t4h_soak_alarm(time_h_t * T, const char * name, int64_t start, int64_t end, uint32_t expected)
+ * \brief Walk one alarm through [start, end) on the simulated RTC and check it against a day by day scan of the match
+ * \returns true if every recurrence fired exactly once at the right time
+ */
+static bool t4h_soak_alarm(time_h_t * T, const char * name, int64_t start, int64_t end, uint32_t expected){
+    int64_t period = T->type == T4H_DAILY_ALARM ? CAL_SECS_PER_DAY : 7 * CAL_SECS_PER_DAY;
+    int64_t tod = T->alarm.hour * 3600 + T->alarm.min * 60;
+    int64_t last = -1;
+    uint32_t fires = 0, errors = 0;
+    datetime_t dt, utc;
+    cal_from_epoch(tz_to_utc(&tzZone, start - 1), &utc);
+    t4h_rtc_set(&utc);                                      ///< The RTC starts just before the range
+    t4h_update_rtc_alarm(T);                                ///< First occurrence, as ALARM or SET_ALARM arm it
+    for(int64_t day = start; day < end; day += CAL_SECS_PER_DAY){
+        int64_t t = day + tod;
+        cal_from_epoch(t, &dt);
+        if(!t4h_alarm_match(T, &dt))
+            continue;
+        fires++;
+        int64_t armed = t4hSimRtc.alarmOn ? tz_local(&tzZone, t4hSimRtc.alarm) : -1;
+        cal_from_epoch(tz_to_utc(&tzZone, t), &utc);
+        t4h_rtc_set(&utc);                                  ///< The RTC reaches the recurrence
+        T->state = T4H_ALARM_ON;
+        T->refreshTB.next = 0;                              ///< Refresh due, it reads the RTC and re-arms the alarm
+        bool rang = t4h_refresh_time(T) && T->state == T4H_ALARM_READY;
+        uint8_t digits[4];
+        t4h_get_display_digits(T, digits);
+        if(t != armed || !rang || !cal_is_valid(&dt) || digits[3] * 10 + digits[2] != tod / 3600 || digits[1] * 10 + digits[0] != tod / 60 % 60
+           || (T->type != T4H_DATE_ALARM && !T->skipHolidays && last >= 0 && t - last != period)){
+            if(errors++ < 3)
+                printf("SOAK %s error at %04d/%02d/%02d %02d:%02d\n", name, dt.year, dt.month, dt.day, dt.hour, dt.min);
+        }
+        last = t;
+    }
+    if(t4hSimRtc.alarmOn && tz_local(&tzZone, t4hSimRtc.alarm) < end)
+        errors++;                                           ///< The RTC was armed for a recurrence the scan did not find
+    bool ok = !errors && fires == expected;
+    printf("SOAK %s fires %lu expected %lu errors %lu %s\n", name, (unsigned long)fires, (unsigned long)expected,
+        (unsigned long)errors, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+/**
+ * \fn bool t4h_soak_test(uint16_t fromYear, uint16_t years)
+ * \brief Drive the alarm logic through a range of years, jumping between alarm deadlines
+ * \details A daily, a weekly and a date alarm (29 February) are checked against a day by day scan
+ * of the match pattern through the path of the clock: the simulated RTC (t4h_sim_rtc) is loaded
+ * with each recurrence, t4h_refresh_time reads it, takes the match of the alarm armed before and
+ * arms the next one. Every recurrence must be the one armed, set the alarm ready, come at the
+ * expected interval and show the right hh:mm digits. A daily alarm that skips the holidays of
+ * holCalendar must fire on every other day. The zone is UTC-5 without DST during the test, the
+ * zone in use and the hardware RTC are untouched. The range is clipped to year 4095.
+ * \param fromYear First simulated year
+ * \param years Number of simulated years
+ * \returns true if all the checks passed
+ */
+bool t4h_soak_test(uint16_t fromYear, uint16_t years){
+    uint16_t toYear = fromYear + years > CAL_YEAR_MAX + 1 ? CAL_YEAR_MAX + 1 : fromYear + years;
+    int64_t start = cal_days_from_civil(fromYear, 1, 1) * CAL_SECS_PER_DAY;
+    int64_t end = cal_days_from_civil(toYear, 1, 1) * CAL_SECS_PER_DAY;
+    uint32_t days = (uint32_t)((end - start) / CAL_SECS_PER_DAY);
+    uint64_t t0 = time_us_64();
+    bool ok = true;
+    time_h_t T;
+    t4h_init(&T);
+    tz_rule_t zone = tzZone.rule;
+    const tz_rule_t fixed = {0, TZ_DEFAULT_MIN, 0, {0}, {0}};
+    tz_set(&tzZone, &fixed);                                ///< Every local time once a day
+    t4h_sim_rtc(true);
+    printf("SOAK %d-%d\n", fromYear, toYear - 1);
+
+    t4h_set_alarm_type(&T, T4H_DAILY_ALARM);
+    t4h_set_alarm_hour(&T, 23, 59);
+    ok &= t4h_soak_alarm(&T, "DAILY", start, end, days);
+
+    t4h_set_alarm_type(&T, T4H_WEEKLY_ALARM);
+    t4h_set_alarm_hour(&T, 6, 30);
+    t4h_set_alarm_dotw(&T, T4H_WEDNESDAY);
+    uint32_t first = (T4H_WEDNESDAY - cal_dotw(fromYear, 1, 1) + 7) % 7;
+    ok &= t4h_soak_alarm(&T, "WEEKLY", start, end, first < days ? (days - 1 - first) / 7 + 1 : 0);
+
+    uint16_t leap = fromYear + (toYear - fromYear) / 2;
+    while(leap < toYear && !cal_is_leap(leap))
+        leap++;
+    t4h_set_alarm_type(&T, T4H_DATE_ALARM);
+    t4h_set_alarm_hour(&T, 0, 0);
+    t4h_set_alarm_date(&T, 29, 2, leap);
+    ok &= t4h_soak_alarm(&T, "DATE", start, end, leap < toYear ? 1 : 0);
+
+    uint32_t holidays = 0;
+    for(uint16_t y = fromYear; y < toYear; y++)
+        holidays += hol_count(&holCalendar, y);
+    t4h_set_alarm_type(&T, T4H_DAILY_ALARM);
+    t4h_set_alarm_hour(&T, 7, 0);
+    T.skipHolidays = true;
+    ok &= t4h_soak_alarm(&T, "HOLIDAY", start, end, days - holidays);
+    t4h_sim_rtc(false);
+    tz_set(&tzZone, &zone);
+
+    uint64_t us = time_us_64() - t0;
+    printf("SOAK %lu days x 4 alarms in %lu ms, %lu simulated days/s %s\n", (unsigned long)days, (unsigned long)(us / 1000),
+        (unsigned long)(us ? 4ull * days * 1000000 / us : 0), ok ? "OK" : "FAIL");
+    return ok;
 }
 
  #endif
\ No newline at end of file
@@ -14,6 +14,14 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "hardware/timer.h"
+#include "Trace.h"
+#ifdef WUCLOCK_REPLAY
+#include "Replay.h"
+#define TB_HINT(t, en) replay_hint((t)->next, (en))  ///< Report the deadline to the replay engine
+#else
+#define TB_HINT(t, en) ((void)0)
+#endif
+
 /** 
  * \typedef time_base_t
  * \brief this datatype enable the management of concurrent temporal events
@@ -32,6 +40,18 @@ typedef struct{
  */ 
 void tb_init(time_base_t *t, uint64_t us, bool en);
 
+/**
+ * \brief Time source of the time bases: the hardware timer, or the virtual clock in WUCLOCK_REPLAY builds
+ * \return Current time in us
+ */
+static inline uint64_t tb_now(void){
+#ifdef WUCLOCK_REPLAY
+    return replay_now();
+#else
+    return time_us_64();
+#endif
+}
+
 /**
  * \brief Return true when the last period had lapsed and false if it is still going
  * \param t    Pointer to temporal structure
@@ -39,19 +59,37 @@ void tb_init(time_base_t *t, uint64_t us, bool en);
  * \return     True if time base period had lapsed and False when it hasn't
  */ 
 static inline bool tb_check(time_base_t *t){
-    return (time_us_64() >= t->next) && t->en;
+    TB_HINT(t, t->en);
+    return (tb_now() >= t->next) && t->en;
 }
 
 /// @brief update the tb to next temporal event with respect to the current time
 /// @param t time base data structure
 static inline void tb_update(time_base_t *t){
-    t->next = time_us_64() + t->delta;
+    t->next = tb_now() + t->delta;
+    TB_HINT(t, true);                                       ///< Usually followed by tb_enable
+}
+
+/// @brief update the tb to a temporal event us from the current time, the period is kept
+/// @param t time base data structure
+/// @param us time to the next temporal event
+static inline void tb_after(time_base_t *t, uint64_t us){
+    t->next = tb_now() + us;
+    TB_HINT(t, t->en);
 }
 
 /// @brief update the tb to next temporal event with respect to the last temporal event
 /// @param t time base data structure
 static inline void tb_next(time_base_t *t){
     t->next = t->next + t->delta;
+    TB_HINT(t, t->en);
+#ifdef WUCLOCK_TRACE
+    uint64_t now = tb_now();
+    if(now >= t->next){                                     ///< One or more whole periods were missed
+        uint64_t missed = (now - t->next) / t->delta + 1;
+        TRACE(TR_TB_MISS, missed > 255 ? 255 : missed, (uintptr_t)t);
+    }
+#endif
 }
 
 /// @brief enable time base to generate temporal events
@@ -0,0 +1,132 @@
+/**
+ * \file        TimeSync.c
+ * \brief       Request/response time synchronization with a host over the USB console
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "TimeSync.h"
+#include "Calendar.h"
+#include "Console.h"
+
+static const char *TS_RESULT_NAME[] = {"NONE", "STEP", "SLEW", "FAIL"};
+
+void ts_init(time_sync_t *T, const datetime_t *now){
+    T->epochOffsetUs = cal_to_epoch(now) * 1000000 - (int64_t)time_us_64();
+    T->slewUs = 0;
+    T->slewLast = 0;
+    T->rtcLoadPending = false;
+    T->rtcLoadSecond = 0;
+    T->state = TS_IDLE;
+    T->exchanges = 0;
+    T->seq = 0;
+    T->replies = 0;
+    T->t1 = 0;
+    T->bestOffsetUs = 0;
+    T->bestDelayUs = 0;
+    T->result = TS_RESULT_NONE;
+    tb_init(&T->exchTB, TS_SPACING_US, false);
+}
+
+void ts_start(time_sync_t *T, uint8_t exchanges){
+    if(exchanges == 0 || exchanges > TS_MAX_EXCHANGES)
+        exchanges = TS_DEF_EXCHANGES;
+    T->slewUs = 0;                                          ///< t4 must use the same offset as t1
+    T->exchanges = exchanges;
+    T->seq = 0;
+    T->replies = 0;
+    T->bestDelayUs = INT64_MAX;
+    T->state = TS_WAIT_NEXT;
+    T->exchTB.next = time_us_64();                          ///< First request right away
+    tb_enable(&T->exchTB);
+}
+
+void ts_reply(time_sync_t *T, uint8_t seq, int64_t t1, int64_t t2, int64_t t3, uint64_t rxUs){
+    if(T->state != TS_WAIT_REPLY || seq != T->seq || t1 != T->t1)
+        return;                                             ///< Late or unexpected reply
+    int64_t t4 = ts_to_wall_us(T, rxUs);
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    if(delay >= 0 && delay < T->bestDelayUs){
+        T->bestDelayUs = delay;
+        T->bestOffsetUs = ((t2 - t1) + (t3 - t4)) / 2;
+    }
+    T->replies++;
+    T->seq++;
+    T->state = TS_WAIT_NEXT;
+    T->exchTB.delta = TS_SPACING_US;
+    tb_update(&T->exchTB);
+}
+
+/**
+ * \brief Close the session and apply the best sample
+ */
+static void ts_finish(time_sync_t *T){
+    T->state = TS_IDLE;
+    tb_disable(&T->exchTB);
+    if(T->bestDelayUs == INT64_MAX){
+        T->result = TS_RESULT_FAIL;
+    }
+    else if(T->bestOffsetUs >= TS_STEP_US || T->bestOffsetUs <= -TS_STEP_US){
+        T->epochOffsetUs += T->bestOffsetUs;
+        T->rtcLoadPending = true;
+        T->rtcLoadSecond = ts_now_us(T) / 1000000;
+        T->result = TS_RESULT_STEP;
+    }
+    else{
+        T->slewUs = T->bestOffsetUs;
+        T->slewLast = time_us_64();
+        T->result = TS_RESULT_SLEW;
+    }
+    ts_print_report(T);
+}
+
+bool ts_process(time_sync_t *T, datetime_t *dt){
+    if(tb_check(&T->exchTB)){
+        if(T->state == TS_WAIT_REPLY)                       ///< Reply timeout, the exchange is lost
+            T->seq++;
+        if(T->seq >= T->exchanges){
+            ts_finish(T);
+        }
+        else{
+            T->t1 = ts_now_us(T);
+            con_printf("SQ %u %lld\n", T->seq, (long long)T->t1);
+            T->state = TS_WAIT_REPLY;
+            T->exchTB.delta = TS_TIMEOUT_US;
+            tb_update(&T->exchTB);
+        }
+    }
+
+    if(T->slewUs){
+        uint64_t now = time_us_64();
+        int64_t step = (int64_t)(now - T->slewLast) * TS_SLEW_US_PER_S / 1000000;
+        if(step){
+            int64_t left = T->slewUs > 0 ? T->slewUs : -T->slewUs;
+            if(step > left) step = left;
+            int64_t applied = T->slewUs > 0 ? step : -step;
+            T->epochOffsetUs += applied;
+            T->slewUs -= applied;
+            T->slewLast = now;
+            if(!T->slewUs){                                 ///< Slew done, align the RTC second
+                T->rtcLoadPending = true;
+                T->rtcLoadSecond = ts_now_us(T) / 1000000;
+            }
+        }
+    }
+
+    if(T->rtcLoadPending){
+        int64_t second = ts_now_us(T) / 1000000;
+        if(second > T->rtcLoadSecond){                      ///< First pass after the boundary
+            T->rtcLoadPending = false;
+            cal_from_epoch(second, dt);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ts_print_report(time_sync_t *T){
+    con_printf("SYNC %lld %lld %s %u\n", (long long)T->bestOffsetUs,
+        (long long)(T->bestDelayUs == INT64_MAX ? -1 : T->bestDelayUs), TS_RESULT_NAME[T->result], T->replies);
+}
@@ -0,0 +1,120 @@
+/**
+ * \file        TimeSync.h
+ * \brief       Request/response time synchronization with a host over the USB console (NTP like)
+ * \details     The clock keeps a microsecond wall clock, wall = time_us_64() + epochOffsetUs, expressed in
+ * microseconds since 01/01/1970 UTC, the base time the RTC counts (TimeZone.h derives the local
+ * time shown). A session performs several exchanges:
+ *
+ *      device -> host:   SQ <seq> <t1>                 t1 device transmit time
+ *      host -> device:   SR <seq> <t1> <t2> <t3>       t2 host receive time, t3 host transmit time
+ *                                                      t4 device receive time (line arrival)
+ *
+ * For every reply offset = ((t2 - t1) + (t3 - t4)) / 2 and delay = (t4 - t1) - (t3 - t2). The sample
+ * with the smallest delay has the smallest asymmetry error and is the one applied. Offsets of at
+ * least TS_STEP_US step the wall clock, smaller ones are slewed at TS_SLEW_US_PER_S. Afterwards the
+ * RTC is reloaded exactly at the next second boundary of the wall clock, see ts_process.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __TIME_SYNC_H_
+#define __TIME_SYNC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "TimeBase.h"
+
+#define TS_MAX_EXCHANGES 16     ///< Maximum exchanges in one session
+#define TS_DEF_EXCHANGES 8      ///< Default exchanges in one session
+#define TS_SPACING_US 50000     ///< Time between exchanges
+#define TS_TIMEOUT_US 500000    ///< Maximum time to wait for a reply
+#define TS_STEP_US 128000       ///< Offsets at or above this value are stepped, smaller ones are slewed
+#define TS_SLEW_US_PER_S 500    ///< Maximum slew rate (500 ppm)
+
+typedef enum {TS_IDLE, TS_WAIT_NEXT, TS_WAIT_REPLY} ts_state_t;
+typedef enum {TS_RESULT_NONE, TS_RESULT_STEP, TS_RESULT_SLEW, TS_RESULT_FAIL} ts_result_t;
+
+typedef struct{
+    int64_t epochOffsetUs;      ///< Wall clock offset with respect to time_us_64
+    int64_t slewUs;             ///< Offset still to be slewed
+    uint64_t slewLast;          ///< time_us_64 of the last slew step
+    bool rtcLoadPending;        ///< Reload the RTC at the next wall clock second boundary
+    int64_t rtcLoadSecond;      ///< Wall clock second when the reload was requested
+    ts_state_t state;           ///< Session state
+    uint8_t exchanges;          ///< Exchanges requested for the session
+    uint8_t seq;                ///< Current exchange
+    uint8_t replies;            ///< Valid replies received in the session
+    int64_t t1;                 ///< Transmit time of the pending request
+    int64_t bestOffsetUs;       ///< Offset of the sample with the smallest delay
+    int64_t bestDelayUs;        ///< Smallest delay of the session
+    ts_result_t result;         ///< Outcome of the last session
+    time_base_t exchTB;         ///< Time base for exchange spacing and reply timeout
+} time_sync_t;
+
+/**
+ * \fn void ts_init(time_sync_t *T, const datetime_t *now)
+ * \brief Initialize the synchronization data structure and align the wall clock with a datetime
+ * \param T     Pointer to time sync data structure
+ * \param now   Current RTC time in UTC (second resolution)
+ */
+void ts_init(time_sync_t *T, const datetime_t *now);
+
+/**
+ * \fn static inline int64_t ts_now_us(time_sync_t *T)
+ * \brief Wall clock in microseconds since 01/01/1970
+ * \param T Pointer to time sync data structure
+ */
+static inline int64_t ts_now_us(time_sync_t *T){
+    return (int64_t)time_us_64() + T->epochOffsetUs;
+}
+
+/**
+ * \fn static inline int64_t ts_to_wall_us(time_sync_t *T, uint64_t us)
+ * \brief Convert a time_us_64 timestamp to wall clock microseconds
+ * \param T     Pointer to time sync data structure
+ * \param us    time_us_64 timestamp
+ */
+static inline int64_t ts_to_wall_us(time_sync_t *T, uint64_t us){
+    return (int64_t)us + T->epochOffsetUs;
+}
+
+/**
+ * \fn void ts_start(time_sync_t *T, uint8_t exchanges)
+ * \brief Start a synchronization session, any slew in progress is cancelled
+ * \param T         Pointer to time sync data structure
+ * \param exchanges Number of request/response exchanges (1 to TS_MAX_EXCHANGES)
+ */
+void ts_start(time_sync_t *T, uint8_t exchanges);
+
+/**
+ * \fn void ts_reply(time_sync_t *T, uint8_t seq, int64_t t1, int64_t t2, int64_t t3, uint64_t rxUs)
+ * \brief Deliver a host reply (SR line) to the session
+ * \param T     Pointer to time sync data structure
+ * \param seq   Sequence number of the request
+ * \param t1    Device transmit time echoed by the host
+ * \param t2    Host receive time
+ * \param t3    Host transmit time
+ * \param rxUs  time_us_64 when the reply line was received
+ */
+void ts_reply(time_sync_t *T, uint8_t seq, int64_t t1, int64_t t2, int64_t t3, uint64_t rxUs);
+
+/**
+ * \fn bool ts_process(time_sync_t *T, datetime_t *dt)
+ * \brief Call this method in the main loop to run the session, the slew and the RTC reload
+ * \param T     Pointer to time sync data structure
+ * \param dt    Filled with the wall clock time, UTC, when the RTC must be loaded
+ * \returns true when the RTC must be loaded now with dt (see t4h_update_rtc_utc)
+ */
+bool ts_process(time_sync_t *T, datetime_t *dt);
+
+/**
+ * \fn void ts_print_report(time_sync_t *T)
+ * \brief Print the result of the last session: SYNC <offset_us> <delay_us> <STEP|SLEW|FAIL|NONE> <replies>
+ * \param T Pointer to time sync data structure
+ */
+void ts_print_report(time_sync_t *T);
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * \file        TimeZone.c
+ * \brief       Local time from the UTC base time of the RTC, with a compact time zone and DST rule
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include "TimeZone.h"
+#include "Calendar.h"
+#include "FlashStore.h"
+
+#define TZ_MAGIC 0x545A4F4Eu        ///< "TZON"
+
+tz_zone_t tzZone;
+
+static const tz_rule_t tzDefault = {TZ_MAGIC, TZ_DEFAULT_MIN, 0, {0}, {0}};     ///< No DST
+
+void tz_init(tz_zone_t *Z){
+    tz_rule_t rule;
+    Z->updates = 0;
+    if(!fstore_read(FSTORE_SLOT_ZONE, &rule, sizeof(rule)) || rule.magic != TZ_MAGIC || !tz_set(Z, &rule))
+        tz_set(Z, &tzDefault);
+}
+
+/**
+ * \fn static bool tz_change_valid(const tz_change_t *C)
+ * \brief Check the fields of a change
+ */
+static bool tz_change_valid(const tz_change_t *C){
+    return C->month >= 1 && C->month <= 12 && ((C->week >= 1 && C->week <= 5) || C->week == -1)
+        && C->dotw <= 6 && C->minute <= 24 * 60;
+}
+
+bool tz_set(tz_zone_t *Z, const tz_rule_t *rule){
+    if(rule->stdMin < -TZ_MAX_MIN || rule->stdMin > TZ_MAX_MIN || rule->dstMin < 0 || rule->dstMin > 120)
+        return false;
+    if(rule->dstMin && (!tz_change_valid(&rule->start) || !tz_change_valid(&rule->end)))
+        return false;
+    Z->rule = *rule;
+    Z->rule.magic = TZ_MAGIC;
+    Z->sinceUtc = INT64_MAX;                ///< Empty interval, the next conversion evaluates the rule
+    Z->nextUtc = INT64_MIN;
+    return true;
+}
+
+bool tz_save(const tz_zone_t *Z){
+    return fstore_write(FSTORE_SLOT_ZONE, &Z->rule, sizeof(Z->rule));
+}
+
+/**
+ * \fn static int64_t tz_change_utc(const tz_change_t *C, int16_t year, int32_t offsetMin)
+ * \brief UTC time of a change in a year, offsetMin is the offset in force before it
+ */
+static int64_t tz_change_utc(const tz_change_t *C, int16_t year, int32_t offsetMin){
+    int8_t day = cal_nth_dotw(year, C->month, C->week, C->dotw);
+    if(day < 0)
+        day = cal_nth_dotw(year, C->month, -1, C->dotw);    ///< No 5th occurrence, the last one
+    return cal_days_from_civil(year, C->month, day) * CAL_SECS_PER_DAY + (int64_t)(C->minute - offsetMin) * 60;
+}
+
+int32_t tz_offset_at(const tz_rule_t *R, int64_t utc, int64_t *since, int64_t *next){
+    int32_t stdS = R->stdMin * 60, dstS = (R->stdMin + R->dstMin) * 60;
+    *since = INT64_MIN;
+    *next = INT64_MAX;
+    if(!R->dstMin)
+        return stdS;
+    datetime_t dt;
+    cal_from_epoch(utc + stdS, &dt);
+    int32_t offset = stdS;
+    for(int16_t y = dt.year - 1; y <= dt.year + 1; y++){     ///< The changes of the year before and after bound utc
+        int64_t t[2] = {tz_change_utc(&R->start, y, R->stdMin), tz_change_utc(&R->end, y, R->stdMin + R->dstMin)};
+        for(uint8_t i = 0; i < 2; i++){
+            if(t[i] <= utc && t[i] > *since){
+                *since = t[i];
+                offset = i ? stdS : dstS;
+            }
+            else if(t[i] > utc && t[i] < *next)
+                *next = t[i];
+        }
+    }
+    return offset;
+}
+
+void tz_update(tz_zone_t *Z, int64_t utc){
+    Z->offsetS = tz_offset_at(&Z->rule, utc, &Z->sinceUtc, &Z->nextUtc);
+    Z->updates++;
+}
+
+int64_t tz_to_utc(tz_zone_t *Z, int64_t local){
+    const tz_rule_t *R = &Z->rule;
+    int64_t dst = local - (int64_t)(R->stdMin + R->dstMin) * 60;
+    int64_t since, next;
+    if(R->dstMin && dst + tz_offset_at(R, dst, &since, &next) == local)
+        return dst;                         ///< Daylight saving time, or the first of a repeated hour
+    return local - (int64_t)R->stdMin * 60; ///< Standard time, or an hour skipped
+}
@@ -0,0 +1,113 @@
+/**
+ * \file        TimeZone.h
+ * \brief       Local time from the UTC base time of the RTC, with a compact time zone and DST rule
+ * \details     The RTC counts UTC and never jumps, the local time is derived from it with a rule: the
+ * standard offset, the daylight saving added to it, and the two changes of the year, each one the
+ * nth (or last) day of the week of a month at a local time in the offset in force before the
+ * change (US: second Sunday of March at 02:00 and first Sunday of November at 02:00, EU: last
+ * Sunday of March at 02:00 and last Sunday of October at 03:00). A rule with dstMin 0 has no DST.
+ * The southern hemisphere, with the start after the end in the year, works the same.
+ *
+ * The zone keeps the offset in force and the transitions around it, precomputed: tz_local is a
+ * compare and an add while the time stays between them, and only crossing a transition (or
+ * setting the clock out of the interval) evaluates the calendar of the rule again.
+ *
+ * tz_to_utc converts a local time set by the user or an alarm occurrence. A local time in the
+ * hour skipped in spring takes the offset before the change, so it shows up to dstMin later; a
+ * local time of the hour repeated in autumn takes its first occurrence.
+ *
+ * The default rule is Colombia, UTC-5 without DST. TZ replaces it over USB (tools/wuhost.py zone
+ * takes the rule of the host) and saves it in its FlashStore slot.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __TIME_ZONE_H_
+#define __TIME_ZONE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TZ_DEFAULT_MIN (-300)       ///< Standard offset of the default rule in minutes, Colombia
+#define TZ_MAX_MIN (14 * 60)        ///< Largest offset from UTC
+
+typedef struct{
+    uint8_t month;              ///< Month 1-12
+    int8_t week;                ///< Occurrence 1-5 of the day of the week, -1 for the last
+    uint8_t dotw;               ///< Day of the week, 0 is Sunday
+    uint16_t minute;            ///< Local time of the change in minutes from midnight
+} tz_change_t;
+
+typedef struct{
+    uint32_t magic;             ///< TZ_MAGIC in flash
+    int16_t stdMin;             ///< Standard offset in minutes, east of Greenwich is positive
+    int16_t dstMin;             ///< Daylight saving added to stdMin, 0 without DST
+    tz_change_t start;          ///< Change to daylight saving time
+    tz_change_t end;            ///< Change back to standard time
+} tz_rule_t;
+
+typedef struct{
+    tz_rule_t rule;             ///< Rule in use
+    int32_t offsetS;            ///< Offset in force from sinceUtc to nextUtc
+    int64_t sinceUtc;           ///< Last transition, seconds since 01/01/1970 UTC
+    int64_t nextUtc;            ///< Next transition
+    uint32_t updates;           ///< Evaluations of the rule since the boot
+} tz_zone_t;
+
+extern tz_zone_t tzZone;        ///< Offset and DST rule of the local time
+
+/**
+ * \fn void tz_init(tz_zone_t *Z)
+ * \brief Load the rule saved in flash, or the default rule
+ */
+void tz_init(tz_zone_t *Z);
+
+/**
+ * \fn bool tz_set(tz_zone_t *Z, const tz_rule_t *rule)
+ * \brief Use a new rule, the transitions are computed again at the next conversion
+ * \returns false if the rule is not valid
+ */
+bool tz_set(tz_zone_t *Z, const tz_rule_t *rule);
+
+/**
+ * \fn bool tz_save(const tz_zone_t *Z)
+ * \brief Save the rule in use in flash, see fstore_write for the cost
+ */
+bool tz_save(const tz_zone_t *Z);
+
+/**
+ * \fn int32_t tz_offset_at(const tz_rule_t *R, int64_t utc, int64_t *since, int64_t *next)
+ * \brief Evaluate the rule: offset in force at a UTC time and the transitions around it
+ * \param R     Pointer to the rule
+ * \param utc   Seconds since 01/01/1970 UTC
+ * \param since Filled with the last transition at or before utc, INT64_MIN without DST
+ * \param next  Filled with the next transition after utc, INT64_MAX without DST
+ * \returns Offset in seconds, local = utc + offset
+ */
+int32_t tz_offset_at(const tz_rule_t *R, int64_t utc, int64_t *since, int64_t *next);
+
+/**
+ * \fn void tz_update(tz_zone_t *Z, int64_t utc)
+ * \brief Move the zone to the interval of utc, called by tz_local out of the interval
+ */
+void tz_update(tz_zone_t *Z, int64_t utc);
+
+/**
+ * \fn static inline int64_t tz_local(tz_zone_t *Z, int64_t utc)
+ * \brief Local time of a UTC time, both in seconds since 01/01/1970
+ */
+static inline int64_t tz_local(tz_zone_t *Z, int64_t utc){
+    if(utc >= Z->nextUtc || utc < Z->sinceUtc)
+        tz_update(Z, utc);
+    return utc + Z->offsetS;
+}
+
+/**
+ * \fn int64_t tz_to_utc(tz_zone_t *Z, int64_t local)
+ * \brief UTC time of a local time, see the details for the skipped and the repeated hours
+ */
+int64_t tz_to_utc(tz_zone_t *Z, int64_t local);
+
+#endif
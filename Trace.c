@@ -0,0 +1,100 @@
+/**
+ * \file        Trace.c
+ * \brief       Deferred binary trace of application events in a RAM ring buffer
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <string.h>
+#include "Trace.h"
+#include "Console.h"
+#include "FlashStore.h"
+
+#define TRACE_MAGIC 0xA5
+#define TRACE_PKT_MAX (5 + TRACE_PKT_RECORDS * sizeof(trace_rec_t) + 2)
+
+trace_t traceBuf;
+#ifdef WUCLOCK_DUAL_CORE
+spin_lock_t *traceLock;
+#endif
+
+/**
+ * \brief Consistent overhead byte stuffing, the output has no zeros and is at most len + len/254 + 1 bytes
+ * \returns Encoded length
+ */
+static uint16_t trace_cobs(const uint8_t *in, uint16_t len, uint8_t *out){
+    uint16_t code = 0, o = 1;
+    uint8_t run = 1;
+    for(uint16_t i = 0; i < len; i++){
+        if(in[i]){
+            out[o++] = in[i];
+            run++;
+        }
+        if(!in[i] || run == 0xFF){
+            out[code] = run;
+            code = o++;
+            run = 1;
+        }
+    }
+    out[code] = run;
+    return o;
+}
+
+void trace_init(void){
+    memset(&traceBuf, 0, sizeof(traceBuf));
+    trace_event(TR_BOOT, 0, 0);
+}
+
+void trace_enable_drain(bool on){
+    traceBuf.drainOn = on;
+}
+
+void trace_drain(console_t *C){
+    if(!traceBuf.drainOn || traceBuf.head == traceBuf.tail || con_tx_pending(C) > CON_TX_SIZE / 2)
+        return;
+
+    uint32_t pending = traceBuf.head - traceBuf.tail;
+    if(pending > TRACE_SIZE){                                   ///< The writer lapped the reader
+        traceBuf.lost += pending - TRACE_SIZE;
+        traceBuf.tail = traceBuf.head - TRACE_SIZE;
+        pending = TRACE_SIZE;
+    }
+    uint8_t count = pending > TRACE_PKT_RECORDS ? TRACE_PKT_RECORDS : pending;
+
+    static uint8_t pkt[TRACE_PKT_MAX];
+    static uint8_t frame[TRACE_PKT_MAX + TRACE_PKT_MAX / 254 + 3];
+    uint16_t n = 0;
+    pkt[n++] = TRACE_MAGIC;
+    pkt[n++] = traceBuf.seq++;
+    pkt[n++] = count;
+    pkt[n++] = traceBuf.lost & 0xFF;
+    pkt[n++] = (traceBuf.lost >> 8) & 0xFF;
+    for(uint8_t i = 0; i < count; i++){
+        const trace_rec_t *r = &traceBuf.ring[(traceBuf.tail + i) & (TRACE_SIZE - 1)];
+        pkt[n++] = r->ts & 0xFF;
+        pkt[n++] = (r->ts >> 8) & 0xFF;
+        pkt[n++] = (r->ts >> 16) & 0xFF;
+        pkt[n++] = (r->ts >> 24) & 0xFF;
+        pkt[n++] = r->id;
+        pkt[n++] = r->a;
+        pkt[n++] = r->b & 0xFF;
+        pkt[n++] = (r->b >> 8) & 0xFF;
+    }
+    uint16_t crc = fstore_crc16(pkt, n);
+    pkt[n++] = crc & 0xFF;
+    pkt[n++] = crc >> 8;
+
+    frame[0] = 0x00;
+    uint16_t len = trace_cobs(pkt, n, frame + 1) + 1;
+    frame[len++] = 0x00;
+    if(con_write(C, (const char *)frame, len))
+        traceBuf.tail += count;
+}
+
+void trace_print_status(void){
+    uint32_t pending = traceBuf.head - traceBuf.tail;
+    con_printf("TRACE %lu %lu %lu %s\n", (unsigned long)traceBuf.head, (unsigned long)(pending > TRACE_SIZE ? TRACE_SIZE : pending),
+        (unsigned long)traceBuf.lost, traceBuf.drainOn ? "ON" : "OFF");
+}
@@ -0,0 +1,124 @@
+/**
+ * \file        Trace.h
+ * \brief       Deferred binary trace of application events in a RAM ring buffer
+ * \details     TRACE(id, a, b) stores an 8 byte record (32 bit us timestamp, event id and two
+ * arguments) in a power of two ring: one timer read, three stores and a masked increment. When the
+ * ring is full the oldest records are overwritten and counted as lost. Records are only formatted
+ * when trace_drain moves them to the USB console as COBS framed packets:
+ *
+ *      0x00 COBS( 0xA5 | seq | count | lost(2) | count * record(8) | crc16(2) ) 0x00
+ *
+ * Multi-byte fields are little endian, crc16 is fstore_crc16 over the preceding bytes. Frames are
+ * delimited by zeros, which never appear in the console text. tools/wutrace.py decodes them.
+ *
+ * Tracing is compiled only when WUCLOCK_TRACE is defined (CMake option WUCLOCK_TRACE). Otherwise
+ * TRACE expands to nothing. Records must be produced outside interrupt handlers. With
+ * WUCLOCK_DUAL_CORE both cores produce records (core1: TR_TB_MISS of the display, TR_TONE), so
+ * trace_event takes the traceLock spin lock, claimed by dc_init, around the slot and the head.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/timer.h"
+#include "Console.h"
+#ifdef WUCLOCK_DUAL_CORE
+#include "hardware/sync.h"
+#endif
+
+#define TRACE_SIZE 256          ///< Number of records in the ring, power of two
+#define TRACE_PKT_RECORDS 16    ///< Maximum records in one packet
+
+/**
+ * \brief Trace event identifiers, keep in sync with tools/wutrace.py
+ */
+typedef enum {
+    TR_BOOT = 0,                ///< a: 0, b: 0
+    TR_STATE,                   ///< Application state change, a: new state, b: previous state | event << 8
+    TR_PB_EVENT,                ///< Push button event change, a: GPIO, b: pb_event_t
+    TR_ALARM_STATE,             ///< Alarm state change, a: new alarm_state_t, b: previous alarm_state_t
+    TR_TB_MISS,                 ///< Time base fired late by whole periods, a: periods (max 255), b: time base address
+    TR_TONE,                    ///< Buzzer tone change, a: volume, b: frequency in Hz, 0 when silent
+    TR_USER                     ///< First identifier free for temporary instrumentation
+} trace_id_t;
+
+typedef struct{
+    uint32_t ts;                ///< time_us_32 of the event
+    uint8_t id;                 ///< trace_id_t
+    uint8_t a;                  ///< First argument
+    uint16_t b;                 ///< Second argument
+} trace_rec_t;
+
+typedef struct{
+    trace_rec_t ring[TRACE_SIZE];   ///< Record ring
+    uint32_t head;              ///< Records written since boot
+    uint32_t tail;              ///< Records drained since boot
+    uint32_t lost;              ///< Records overwritten before they were drained
+    uint8_t seq;                ///< Packet sequence number
+    bool drainOn;               ///< true to drain the ring over the console
+} trace_t;
+
+extern trace_t traceBuf;        ///< Ring of timestamped events
+#ifdef WUCLOCK_DUAL_CORE
+extern spin_lock_t *traceLock;  ///< Lock of the ring head, NULL before dc_init (boot record)
+#endif
+
+/**
+ * \fn static inline void trace_event(uint8_t id, uint8_t a, uint16_t b)
+ * \brief Append a record to the trace ring, use the TRACE macro in instrumented code
+ */
+static inline void trace_event(uint8_t id, uint8_t a, uint16_t b){
+#ifdef WUCLOCK_DUAL_CORE
+    uint32_t save = traceLock ? spin_lock_blocking(traceLock) : 0;
+#endif
+    trace_rec_t *r = &traceBuf.ring[traceBuf.head & (TRACE_SIZE - 1)];
+    r->ts = time_us_32();
+    r->id = id;
+    r->a = a;
+    r->b = b;
+    traceBuf.head++;
+#ifdef WUCLOCK_DUAL_CORE
+    if(traceLock)
+        spin_unlock(traceLock, save);
+#endif
+}
+
+#ifdef WUCLOCK_TRACE
+#define TRACE(id, a, b) trace_event((id), (uint8_t)(a), (uint16_t)(b))
+#else
+#define TRACE(id, a, b) ((void)0)
+#endif
+
+/**
+ * \fn void trace_init(void)
+ * \brief Clear the trace ring and record the boot event
+ */
+void trace_init(void);
+
+/**
+ * \fn void trace_enable_drain(bool on)
+ * \brief Start or stop sending the trace over the USB console
+ */
+void trace_enable_drain(bool on);
+
+/**
+ * \fn void trace_drain(console_t *C)
+ * \brief Call this method in the main loop. When draining is enabled and the console TX queue is
+ * less than half full, one packet with the oldest records is queued.
+ * \param C Pointer to the console used to send the packets
+ */
+void trace_drain(console_t *C);
+
+/**
+ * \fn void trace_print_status(void)
+ * \brief Print the trace counters: TRACE <recorded> <pending> <lost> <ON|OFF>
+ */
+void trace_print_status(void);
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * \file        WarmBoot.c
+ * \brief       Checkpoint of the essential state that survives a reset, and the warm boot that restores it
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "WarmBoot.h"
+#include "FlashStore.h"
+#include "hardware/watchdog.h"
+#include "hardware/timer.h"
+
+wb_boot_t wbBoot;
+static wb_checkpoint_t __uninitialized_ram(wbSaved);   ///< Not zeroed by the runtime, kept across a reset
+
+/**
+ * \fn static uint16_t wb_crc(const wb_checkpoint_t *C)
+ * \brief CRC of a checkpoint without its crc field
+ */
+static uint16_t wb_crc(const wb_checkpoint_t *C){
+    return fstore_crc16(C, offsetof(wb_checkpoint_t, crc));
+}
+
+bool wb_restore(wb_boot_t *B){
+    bool valid = watchdog_hw->scratch[0] == WB_MAGIC && watchdog_hw->scratch[1] == wbSaved.seq &&
+        watchdog_hw->scratch[2] == wbSaved.crc && wb_crc(&wbSaved) == wbSaved.crc;
+    watchdog_hw->scratch[0] = 0;            ///< Used once, wb_save validates it again
+    B->saves = 0;
+    B->frameUs = 0;
+    B->rtcKept = false;
+    B->warm = valid;
+    if(!valid){
+        memset(&B->cp, 0, sizeof(B->cp));
+        B->reason = WB_POWER;
+        return false;
+    }
+    B->cp = wbSaved;
+    B->reason = watchdog_caused_reboot() ? WB_WATCHDOG : WB_RESET;
+    return true;
+}
+
+void wb_save(wb_boot_t *B){
+    B->cp.seq++;
+    B->cp.crc = wb_crc(&B->cp);
+    watchdog_hw->scratch[0] = 0;            ///< A reset while the RAM copy is written boots cold
+    wbSaved = B->cp;
+    watchdog_hw->scratch[1] = B->cp.seq;
+    watchdog_hw->scratch[2] = B->cp.crc;
+    watchdog_hw->scratch[0] = WB_MAGIC;
+    B->saves++;
+}
+
+void wb_first_frame(wb_boot_t *B){
+    B->frameUs = time_us_32();
+    if(B->warm){
+        B->cp.warmFrameUs = B->frameUs;
+        B->cp.warmBoots++;
+    }
+    else
+        B->cp.coldFrameUs = B->frameUs;
+}
+
+void wb_reboot(wb_boot_t *B, uint32_t delayMs){
+    wb_save(B);
+    watchdog_reboot(0, 0, delayMs);
+}
@@ -0,0 +1,99 @@
+/**
+ * \file        WarmBoot.h
+ * \brief       Checkpoint of the essential state that survives a reset, and the warm boot that restores it
+ * \details     A reset that does not remove the power (watchdog, REBOOT command, RUN button, debugger)
+ * keeps the SRAM and the watchdog scratch registers. The application checkpoints its essential
+ * state every second and at every state change: time and date, alarm and its holiday skip,
+ * snooze period and time left, state of the application and display content. The checkpoint
+ * lives in the uninitialized RAM section (not zeroed by the runtime) with a CRC, and its number
+ * and CRC are repeated in scratch registers 0 to 2 (4 to 7 belong to the SDK). Both must agree
+ * for a warm boot, so stale RAM after a power loss, or RAM from another image, boots cold.
+ *
+ * On a warm boot main shows the restored display first and starts the USB after the first frame,
+ * so the enumeration does not delay it. The time comes from the RTC when it is still running at
+ * boot, otherwise from the checkpoint, up to one second late. The time to the first frame is
+ * measured from the start of the timer by the runtime and kept in the checkpoint for the cold
+ * and the warm boots, the BOOT command shows both.
+ *
+ * wb_restore clears the scratch magic, so a checkpoint that makes the boot crash is used once.
+ * \author      Ricardo Andres Velasquez Velez
+ * \version     0.0.1
+ * \date        10/18/2026
+ * \copyright   Unlicensed
+ */
+
+#ifndef __WARM_BOOT_H_
+#define __WARM_BOOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+#define WB_MAGIC 0x57554342u        ///< "WUCB" in scratch register 0 while the checkpoint is valid
+#define WB_DIGITS 4                 ///< Display digits in the checkpoint
+#define WB_PERIOD_US 1000000        ///< Checkpoint period
+
+/// Cause of the last boot
+typedef enum{
+    WB_POWER = 0,               ///< Power on, or no valid checkpoint
+    WB_WATCHDOG,                ///< Watchdog timeout or watchdog_reboot
+    WB_RESET                    ///< Other reset with the power kept: RUN button, debugger
+} wb_reason_t;
+
+typedef struct{
+    uint32_t seq;               ///< Checkpoint number, repeated in scratch register 1
+    datetime_t date;            ///< RTC time and date, UTC
+    datetime_t alarm;           ///< Alarm time and date
+    uint8_t alarmType;          ///< alarm_type_t
+    uint8_t alarmState;         ///< alarm_state_t
+    bool rtcAlarm;              ///< The RTC alarm was programmed
+    bool skipHolidays;          ///< The alarm does not ring on holidays
+    uint8_t postPeriod;         ///< Snooze period in minutes
+    uint32_t snoozeLeftMs;      ///< Time left of a running snooze
+    uint8_t state;              ///< State of the application
+    uint8_t sound;              ///< Alarm sound source
+    uint32_t digits[WB_DIGITS]; ///< Segment codes of the display
+    uint32_t enMask;            ///< Digits enabled
+    uint32_t coldFrameUs;       ///< Time to first frame of the last cold boot
+    uint32_t warmFrameUs;       ///< Time to first frame of the last warm boot
+    uint32_t warmBoots;         ///< Warm boots since the last cold boot
+    uint16_t crc;               ///< CRC-16 of the fields above, repeated in scratch register 2
+} wb_checkpoint_t;
+
+typedef struct{
+    wb_checkpoint_t cp;         ///< Working copy, restored by wb_restore and filled by the application
+    bool warm;                  ///< This boot restored a checkpoint
+    bool rtcKept;               ///< The RTC was running at boot and kept its time
+    uint8_t reason;             ///< wb_reason_t
+    uint32_t frameUs;           ///< Time to first frame of this boot, 0 before it
+    uint32_t saves;             ///< Checkpoints written since the boot
+} wb_boot_t;
+
+extern wb_boot_t wbBoot;        ///< Reason of this boot and the checkpoint
+
+/**
+ * \fn bool wb_restore(wb_boot_t *B)
+ * \brief Check the checkpoint left by the last reset, first thing at boot
+ * \returns true for a warm boot, B->cp holds the checkpoint; false for a cold boot, B->cp is cleared
+ */
+bool wb_restore(wb_boot_t *B);
+
+/**
+ * \fn void wb_save(wb_boot_t *B)
+ * \brief Write B->cp as the new checkpoint, the application fills it first
+ */
+void wb_save(wb_boot_t *B);
+
+/**
+ * \fn void wb_first_frame(wb_boot_t *B)
+ * \brief Record the time to first frame, call once when the first frame is handed to the display
+ */
+void wb_first_frame(wb_boot_t *B);
+
+/**
+ * \fn void wb_reboot(wb_boot_t *B, uint32_t delayMs)
+ * \brief Save the checkpoint and reset with the watchdog after delayMs, to measure a warm boot
+ */
+void wb_reboot(wb_boot_t *B, uint32_t delayMs);
+
+#endif
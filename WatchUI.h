@@ -17,6 +17,9 @@
 #include "SevenSegments.h"
 #include "SmartLED.h"
 #include "SmartBuzzer.h"
+#include "Pattern.h"
+#include "Audio.h"
+#include "Profile.h"
 
 typedef enum {
     WATCH_UI_STATE_NORMAL,
@@ -41,6 +44,30 @@ typedef union{
     } BITS;
 } ui_event_t;
 
+/// Services of watch_ui_process, the push button bits are in the order of the ui_event_t fields
+#define WATCH_UI_PB_SET_TIME  (1u << 0)
+#define WATCH_UI_PB_SET_ALARM (1u << 1)
+#define WATCH_UI_PB_PLUS      (1u << 2)
+#define WATCH_UI_PB_MINUS     (1u << 3)
+#define WATCH_UI_PB_SNOOZE    (1u << 4)
+#define WATCH_UI_PB_SHOW_DATE (1u << 5)
+#define WATCH_UI_DISPLAY      (1u << 6)     ///< Seven segment multiplexing, or publication to its refresh ISR
+#define WATCH_UI_PATTERN      (1u << 7)     ///< Pattern player of the LEDs and the buzzer
+#define WATCH_UI_SERVICES     0x00FFu       ///< Bits of the services mask used by the watch UI
+#define WATCH_UI_PB_ALL       0x003Fu       ///< Push button bits, the bank sampled by the governor
+#define WATCH_UI_SS_ALARM     1             ///< Timer alarm of the display refresh ISR
+#define WATCH_UI_SEG_UA       4000          ///< Default current of a lit segment, (3.3 V - 2.0 V) / 330 Ohm
+#define WATCH_UI_LED_UA       4000          ///< Default current of a LED at full brightness
+
+
+/// Alarm melody: a slow call for 20 s, a faster one for 15 s, then a fast call until the alarm is
+/// attended or the buzzer reaches its time limit. A GPIO buzzer beeps the same rhythm.
+static const uint8_t watchAlarmRing[] = {
+    PAT_MARK, PAT_STEP(BZ_NOTE(BZ_E, 6), 10), PAT_STEP(BZ_NOTE(BZ_A, 6), 10), PAT_OFF(80), PAT_LOOP(20),
+    PAT_MARK, PAT_STEP(BZ_NOTE(BZ_E, 6), 10), PAT_STEP(BZ_NOTE(BZ_A, 6), 10), PAT_STEP(BZ_NOTE(BZ_CS, 7), 10),
+        PAT_OFF(20), PAT_LOOP(30),
+    PAT_MARK, PAT_STEP(BZ_NOTE(BZ_A, 6), 10), PAT_OFF(10), PAT_REPEAT
+};
 
 typedef struct  {
     push_button_t pbSetTime;      ///< Push button for setting time
@@ -58,6 +85,9 @@ typedef struct  {
     
     ss_config_t ssDisplay;  ///< Seven segment display configuration for showing time and date
 
+    pb_gov_t pbGov;         ///< Sampling rate of the push buttons
+    uint16_t pbServices;    ///< Push buttons polled in the last pass, WATCH_UI_PB_* bits
+
 } watch_ui_t;
 
 /**
@@ -73,64 +103,130 @@ void watch_ui_init(watch_ui_t *ui) {
     pb_init(&ui->pbMinus, 5, 0, 0);        ///< Initialize push button for decrementing values
     pb_init(&ui->pbSnooze, 6, 0, 0);       ///< Initialize push button for snoozing alarms      
     pb_init(&ui->pbShowDate, 7, 0, 0);     ///< Initialize push button for showing date
+    pb_gov_init(&ui->pbGov);               ///< The buttons are sampled slowly until one is pressed
+    ui->pbServices = 0;                    ///< The first state flushes the buttons it polls
 
     ss_init(&ui->ssDisplay, 4, COMMON_ANODE, 0x000F0F00, 0x0000F000); ///< Initialize seven segment display with 4 digits
+    ss_set_blink_freq(&ui->ssDisplay, 4);  ///< 2 Hz blink of the field being set
+#ifndef WUCLOCK_DUAL_CORE
+    ss_set_alarm(&ui->ssDisplay, WATCH_UI_SS_ALARM);  ///< Multiplex from the timer alarm, core1 polls it in dual core builds
+#endif
+    ss_turn_on(&ui->ssDisplay);  ///< Start the multiplexing with all the digits shown
 
-    buzzer_init(&ui->buzzer, 20); ///< Initialize smart buzzer on GPIO 8
-    sLED_init(&ui->ledAlarm, 21);      ///< Initialize smart LED for alarm indication on GPIO 9
+    aud_init(&aud, 20);  ///< Sample clips play on the buzzer GPIO, a clip playing is stopped before the slice is set up again
+    sLED_init_pwm(&ui->ledAlarm, 21);  ///< Initialize dimmable smart LED for alarm indication and sunrise on GPIO 21
+    buzzer_init_pwm(&ui->buzzer, 20); ///< Initialize the tone buzzer on GPIO 20, it shares the PWM slice of the alarm LED
     sLED_init(&ui->ledHourUP, 22);   ///< Initialize smart LED for hour increment indication on GPIO 10
     sLED_init(&ui->ledHourDOWN, 26); ///< Initialize smart LED for hour decrement indication on GPIO 11
 }
 
-void watch_ui_process(watch_ui_t *ui, watch_ui_state_t state, ui_event_t *events) {
+/**
+ * \fn static uint32_t watch_ui_led_ua(smart_led_t *SL)
+ * \brief Mean current of a LED at its brightness, a GPIO LED is fully on for any level
+ */
+static uint32_t watch_ui_led_ua(smart_led_t *SL){
+    if(!SL->level)
+        return 0;
+    uint32_t ua = enMeter.model[EN_LED];      ///< Current model of the energy meter
+    return SL->pwm ? (uint32_t)((uint64_t)ua * sLEDGamma[SL->level] >> 16) : ua;
+}
 
-    ss_refresh(&ui->ssDisplay); ///< Refresh the seven segment display
-    events->all = 0; ///< set time event
-    switch (state)
-    {
-    case WATCH_UI_STATE_NORMAL:
-        events->BITS.set_time = pb_get_event(&ui->pbSetTime);      ///< Process push button for setting time
-        events->BITS.set_alarm = pb_get_event(&ui->pbSetAlarm);     ///< Process push button for setting alarm
-        events->BITS.snooze = pb_get_event(&ui->pbSnooze);       ///< Process push button for snoozing alarms
-        events->BITS.show_date = pb_get_event(&ui->pbShowDate);     ///< Process push button for showing date
-        sLED_process_blink(&ui->ledHourUP);  ///< Process smart LED for hour increment indication
-        sLED_process_blink(&ui->ledHourDOWN);///< Process smart LED for hour decrement indication
-        break;
-    case WATCH_UI_STATE_SET_TIME:
-        // Handle setting time state
-        events->BITS.set_time = pb_get_event(&ui->pbSetTime);
-        events->BITS.plus = pb_get_event(&ui->pbPlus);
-        events->BITS.minus = pb_get_event(&ui->pbMinus);
-        break;
-    case WATCH_UI_STATE_SET_ALARM:
-        // Handle setting time state
-        events->BITS.set_alarm = pb_get_event(&ui->pbSetAlarm);
-        events->BITS.plus = pb_get_event(&ui->pbPlus);
-        events->BITS.minus = pb_get_event(&ui->pbMinus);
-        break;
-    case WATCH_UI_STATE_SET_SNOOZE:
-        // Handle setting snooze state
-        events->BITS.snooze = pb_get_event(&ui->pbSnooze);
-        events->BITS.plus = pb_get_event(&ui->pbPlus);
-        events->BITS.minus = pb_get_event(&ui->pbMinus);
-        break;
-    case WATCH_UI_STATE_ALARM:
-        // Handle alarm state
-        events->BITS.set_alarm = pb_get_event(&ui->pbSetAlarm);     ///< Process push button for setting alarm
-        events->BITS.snooze = pb_get_event(&ui->pbSnooze);       ///< Process push button for snoozing alarms
-        sLED_process_blink(&ui->ledHourUP);  ///< Process smart LED for alarm indication
-        sLED_process_blink(&ui->ledHourDOWN);///< Process smart LED for hour decrement indication
-        buzzer_process_ring(&ui->buzzer);       ///< Process smart buzzer for audio feedback
-        break;
-    case WATCH_UI_STATE_SNOOZE:
-        events->BITS.set_alarm = pb_get_event(&ui->pbSetAlarm);     ///< Process push button for setting alarm
-        sLED_process_blink(&ui->ledAlarm);  ///< Process smart LED for snooze indication
-        sLED_process_blink(&ui->ledHourUP);  ///< Process smart LED for hour increment indication
-        sLED_process_blink(&ui->ledHourDOWN);///< Process smart LED for hour decrement indication
-        break; // Handle snooze state, if needed
-    default:
-        break;
+/**
+ * \fn uint32_t watch_ui_display_ua(watch_ui_t *ui, uint16_t duty)
+ * \brief Estimated mean current of the display in uA at a duty of the multiplexing
+ * \details One digit is on at a time, the display draws the mean of the lit segments of the
+ * enabled digits, for the lit part of the slots.
+ */
+uint32_t watch_ui_display_ua(watch_ui_t *ui, uint16_t duty){
+    ss_config_t *ss = &ui->ssDisplay;
+    uint32_t segments = 0, digits = 0;
+    for(uint8_t d = 0; d < ss->numD; d++){
+        if(!(ss->enMask & (1u << d)))
+            continue;
+        uint32_t on = ss->type == COMMON_ANODE ? ~ss->array[d] : ss->array[d];    ///< A common anode segment lights low
+        segments += __builtin_popcount(on & ss->segMask);
+        digits++;
     }
-}   
+    if(!ss->ssRefreshTB.en || !digits)
+        return 0;
+    return (uint64_t)segments * enMeter.model[EN_SEGMENT] * duty / SS_DUTY_MAX / digits;
+}
+
+/**
+ * \fn uint32_t watch_ui_load_ua(watch_ui_t *ui)
+ * \brief Estimated mean current of the display and the LEDs in uA, for the RNF04 margin
+ * \details The buzzer is excluded like in RNF04.
+ */
+uint32_t watch_ui_load_ua(watch_ui_t *ui){
+    uint32_t ua = watch_ui_display_ua(ui, ui->ssDisplay.duty);
+    return ua + watch_ui_led_ua(&ui->ledAlarm) + watch_ui_led_ua(&ui->ledHourUP) + watch_ui_led_ua(&ui->ledHourDOWN);
+}
+
+/**
+ * \fn static inline pb_event_t watch_ui_poll(push_button_t *PB, bool *busy)
+ * \brief Poll a push button of the bank and accumulate its activity for the governor
+ */
+static inline pb_event_t watch_ui_poll(push_button_t *PB, bool *busy){
+    pb_event_t event;
+    PROF(PROF_PB_POLL, event = pb_poll_event(PB));
+    *busy |= pb_is_busy(PB);
+    return event;
+}
+
+/**
+ * \fn static void watch_ui_flush(watch_ui_t *ui, uint16_t buttons)
+ * \brief Drop the presses latched by push buttons while they were out of the services mask
+ */
+static void watch_ui_flush(watch_ui_t *ui, uint16_t buttons){
+    if(buttons & WATCH_UI_PB_SET_TIME)
+        pb_flush(&ui->pbSetTime);
+    if(buttons & WATCH_UI_PB_SET_ALARM)
+        pb_flush(&ui->pbSetAlarm);
+    if(buttons & WATCH_UI_PB_PLUS)
+        pb_flush(&ui->pbPlus);
+    if(buttons & WATCH_UI_PB_MINUS)
+        pb_flush(&ui->pbMinus);
+    if(buttons & WATCH_UI_PB_SNOOZE)
+        pb_flush(&ui->pbSnooze);
+    if(buttons & WATCH_UI_PB_SHOW_DATE)
+        pb_flush(&ui->pbShowDate);
+}
+
+/**
+ * \fn void watch_ui_process(watch_ui_t *ui, uint16_t services, ui_event_t *events)
+ * \brief Service the drivers selected by the state and collect the push button events, the push
+ * buttons are polled when the governor samples the bank. A push button that enters the services
+ * mask is flushed first, the presses it latched while it was out are dropped.
+ * \param ui Pointer to the watch UI
+ * \param services WATCH_UI_* bits of the current state, other bits are ignored
+ * \param events Events of the polled push buttons, 0 for the others
+ */
+void watch_ui_process(watch_ui_t *ui, uint16_t services, ui_event_t *events) {
+    if(services & WATCH_UI_DISPLAY)
+        PROF(PROF_SS_REFRESH, ss_refresh(&ui->ssDisplay)); ///< Refresh the seven segment display
+    if(services & WATCH_UI_PATTERN)
+        PROF(PROF_PATTERN, pat_process(&patPlayer)); ///< Play the patterns of the LEDs and the buzzer
+    events->all = 0;
+    uint16_t entering = services & ~ui->pbServices & WATCH_UI_PB_ALL;
+    ui->pbServices = services & WATCH_UI_PB_ALL;
+    if(entering)
+        watch_ui_flush(ui, entering);  ///< A press made in a state that did not poll the button is not an event
+    if(!(services & WATCH_UI_PB_ALL) || !pb_gov_due(&ui->pbGov))
+        return;
+    bool busy = false;
+    if(services & WATCH_UI_PB_SET_TIME)
+        events->BITS.set_time = watch_ui_poll(&ui->pbSetTime, &busy);
+    if(services & WATCH_UI_PB_SET_ALARM)
+        events->BITS.set_alarm = watch_ui_poll(&ui->pbSetAlarm, &busy);
+    if(services & WATCH_UI_PB_PLUS)
+        events->BITS.plus = watch_ui_poll(&ui->pbPlus, &busy);
+    if(services & WATCH_UI_PB_MINUS)
+        events->BITS.minus = watch_ui_poll(&ui->pbMinus, &busy);
+    if(services & WATCH_UI_PB_SNOOZE)
+        events->BITS.snooze = watch_ui_poll(&ui->pbSnooze, &busy);
+    if(services & WATCH_UI_PB_SHOW_DATE)
+        events->BITS.show_date = watch_ui_poll(&ui->pbShowDate, &busy);
+    pb_gov_report(&ui->pbGov, busy);
+}
 
 #endif
\ No newline at end of file
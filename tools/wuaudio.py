@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+"""Make and check the wuClock sound clips (see Audio.h).
+
+  wuaudio.py encode IN.wav -o CLIP.c --name NAME [--format adpcm|ulaw] [--rate HZ]
+  wuaudio.py encode --synth chime -o CLIP.c --name NAME ...
+  wuaudio.py decode CLIP.c -o OUT.wav [--name NAME]
+
+encode mixes the WAV to mono, resamples it linearly to --rate (8000 to 16000 Hz) and writes a C
+file with the encoded bytes and the aud_clip_t. decode runs the same decoder as Audio.c and writes
+16 bit PCM, to listen to a clip before it is flashed. The decode cost on the clock is shown by the
+SOUND command. Only the standard library is used.
+"""
+
+import argparse
+import math
+import re
+import struct
+import sys
+import wave
+
+STEPS = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+]
+INDEX = [-1, -1, -1, -1, 2, 4, 6, 8]
+FORMATS = {"ulaw": "AUD_ULAW", "adpcm": "AUD_ADPCM"}
+
+
+def clamp(v, lo, hi):
+    return lo if v < lo else hi if v > hi else v
+
+
+class Adpcm:
+    """IMA ADPCM state, the same as aud_decoder_t."""
+
+    def __init__(self):
+        self.pred = 0
+        self.index = 0
+
+    def decode(self, nibble):
+        step = STEPS[self.index]
+        diff = step >> 3
+        if nibble & 4:
+            diff += step
+        if nibble & 2:
+            diff += step >> 1
+        if nibble & 1:
+            diff += step >> 2
+        self.pred = clamp(self.pred - diff if nibble & 8 else self.pred + diff, -32768, 32767)
+        self.index = clamp(self.index + INDEX[nibble & 7], 0, 88)
+        return self.pred
+
+    def encode(self, sample):
+        step = STEPS[self.index]
+        diff = sample - self.pred
+        nibble = 8 if diff < 0 else 0
+        diff = abs(diff)
+        for bit, part in ((4, step), (2, step >> 1), (1, step >> 2)):
+            if diff >= part:
+                nibble |= bit
+                diff -= part
+        self.decode(nibble)         # track the decoder, not the input
+        return nibble
+
+
+def ulaw_encode(sample):
+    sign = 0x80 if sample < 0 else 0
+    mag = min(abs(sample), 32635) + 0x84
+    exp = 7
+    while exp and not mag & (0x4000 >> (7 - exp)):
+        exp -= 1
+    return ~(sign | exp << 4 | (mag >> (exp + 3)) & 0x0F) & 0xFF
+
+
+def ulaw_decode(u):
+    u = ~u & 0xFF
+    t = (((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4)
+    return 0x84 - t if u & 0x80 else t - 0x84
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        ch, width, rate, n = w.getnchannels(), w.getsampwidth(), w.getframerate(), w.getnframes()
+        raw = w.readframes(n)
+    if width == 1:
+        vals = [(b - 128) << 8 for b in raw]
+    elif width == 2:
+        vals = list(struct.unpack("<%dh" % (len(raw) // 2), raw))
+    else:
+        sys.exit("only 8 and 16 bit WAV files are supported")
+    mono = [sum(vals[i:i + ch]) // ch for i in range(0, len(vals), ch)]
+    return mono, rate
+
+
+def resample(pcm, src, dst):
+    if src == dst:
+        return pcm
+    out = []
+    for k in range(int(len(pcm) * dst / src)):
+        x = k * src / dst
+        i = int(x)
+        a = pcm[i]
+        b = pcm[i + 1] if i + 1 < len(pcm) else a
+        out.append(int(a + (b - a) * (x - i)))
+    return out
+
+
+def synth_chime(rate):
+    """Two bell strokes, E6 then C6, with partials below 4 kHz for the 8 kHz rate."""
+    pcm = []
+    for base, length in ((1318.5, 0.35), (1046.5, 0.45)):
+        for n in range(int(length * rate)):
+            t = n / rate
+            v = sum(a * math.sin(2 * math.pi * base * m * t) * math.exp(-t * d)
+                    for m, a, d in ((1, 0.7, 6), (2, 0.2, 9), (2.76, 0.1, 12)))
+            pcm.append(int(clamp(v, -1, 1) * 30000))
+    return pcm
+
+
+def encode(pcm, fmt):
+    if fmt == "ulaw":
+        return bytes(ulaw_encode(s) for s in pcm)
+    state = Adpcm()
+    nibbles = [state.encode(s) for s in pcm]
+    if len(nibbles) & 1:
+        nibbles.append(0)
+    return bytes(nibbles[i] | nibbles[i + 1] << 4 for i in range(0, len(nibbles), 2))
+
+
+def decode(data, samples, fmt):
+    if fmt == "ulaw":
+        return [ulaw_decode(b) for b in data[:samples]]
+    state = Adpcm()
+    return [state.decode(data[i >> 1] >> 4 if i & 1 else data[i >> 1] & 0x0F) for i in range(samples)]
+
+
+def write_c(path, name, data, samples, rate, fmt, source):
+    lines = ["    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + "," for i in range(0, len(data), 16)]
+    with open(path, "w") as f:
+        f.write("/// %s: %s, %d samples at %d Hz, generated by tools/wuaudio.py\n" % (name, source, samples, rate))
+        f.write("static const uint8_t %sData[] = {\n%s\n};\n\n" % (name, "\n".join(lines)))
+        f.write("const aud_clip_t %s = {%sData, %d, %d, %s};\n" % (name, name, samples, rate, FORMATS[fmt]))
+
+
+def read_c(path, name):
+    text = open(path).read()
+    m = re.search(r"const aud_clip_t (\w+) = \{(\w+), (\d+), (\d+), (AUD_\w+)\};", text) if name is None else \
+        re.search(r"const aud_clip_t (%s) = \{(\w+), (\d+), (\d+), (AUD_\w+)\};" % re.escape(name), text)
+    if not m:
+        sys.exit("no aud_clip_t %sin %s" % (name + " " if name else "", path))
+    body = re.search(r"%s\[\] = \{([^}]*)\}" % re.escape(m.group(2)), text)
+    data = bytes(int(v, 16) for v in re.findall(r"0x([0-9a-fA-F]{2})", body.group(1)))
+    fmt = {v: k for k, v in FORMATS.items()}[m.group(5)]
+    return m.group(1), data, int(m.group(3)), int(m.group(4)), fmt
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    enc = sub.add_parser("encode", help="WAV to a C clip")
+    enc.add_argument("wav", nargs="?")
+    enc.add_argument("--synth", choices=["chime"], help="built-in sound instead of a WAV file")
+    enc.add_argument("-o", "--output", required=True)
+    enc.add_argument("--name", required=True, help="C name of the aud_clip_t")
+    enc.add_argument("--format", choices=sorted(FORMATS), default="adpcm")
+    enc.add_argument("--rate", type=int, default=8000)
+    dec = sub.add_parser("decode", help="C clip to a 16 bit WAV")
+    dec.add_argument("clip")
+    dec.add_argument("-o", "--output", required=True)
+    dec.add_argument("--name", help="clip to decode when the file has several")
+    args = parser.parse_args()
+
+    if args.cmd == "encode":
+        if not 8000 <= args.rate <= 16000:
+            parser.error("--rate from 8000 to 16000")
+        if args.synth:
+            pcm, source = synth_chime(args.rate), "synthesized " + args.synth
+        elif args.wav:
+            pcm, rate = read_wav(args.wav)
+            pcm, source = resample(pcm, rate, args.rate), args.wav
+        else:
+            parser.error("a WAV file or --synth is required")
+        data = encode(pcm, args.format)
+        write_c(args.output, args.name, data, len(pcm), args.rate, args.format, source)
+        err = [a - b for a, b in zip(pcm, decode(data, len(pcm), args.format))]
+        snr = 10 * math.log10(sum(s * s for s in pcm) / max(sum(e * e for e in err), 1))
+        print("%s: %d samples, %d bytes, %s, SNR %.1f dB" % (args.name, len(pcm), len(data), args.format, snr))
+    else:
+        name, data, samples, rate, fmt = read_c(args.clip, args.name)
+        pcm = decode(data, samples, fmt)
+        with wave.open(args.output, "wb") as w:
+            w.setnchannels(1)
+            w.setsampwidth(2)
+            w.setframerate(rate)
+            w.writeframes(struct.pack("<%dh" % len(pcm), *pcm))
+        print("%s: %d samples at %d Hz, %.2f s written to %s" % (name, samples, rate, samples / rate, args.output))
+
+
+if __name__ == "__main__":
+    main()
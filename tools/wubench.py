@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Run the wuClock driver micro-benchmarks (BENCH command, see Bench.h) and gate regressions.
+
+  wubench.py PORT [--calls N]          run the suite on the clock and compare with the baseline
+  wubench.py --json FILE               compare a saved result line instead of running the suite
+  wubench.py ... --update              write the result as the new baseline
+
+The mean cycles of every case are compared with the baseline file (tools/bench_baseline.json by
+default); the exit status is 1 when a case is slower than the threshold or missing. Cycles are
+clk_sys cycles, a baseline is only meaningful for the same clock frequency and build options.
+Only the standard library is used.
+"""
+
+import argparse
+import json
+import os
+import select
+import sys
+import termios
+import tty
+
+BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "bench_baseline.json")
+
+
+def run_bench(path, calls, timeout):
+    """Send BENCH and return the decoded JSON result line."""
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        attrs[3] &= ~termios.ECHO
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+        termios.tcflush(fd, termios.TCIFLUSH)
+    os.write(fd, b"BENCH %d\n" % calls)
+    buf = b""
+    while True:
+        while b"\n" in buf:
+            line, buf = buf.split(b"\n", 1)
+            line = line.decode(errors="replace").strip()
+            if line.startswith('{"bench"'):
+                return json.loads(line)
+            if line.startswith("ERR"):
+                sys.exit("clock answered: " + line)
+        ready, _, _ = select.select([fd], [], [], timeout)
+        if not ready:
+            sys.exit("no benchmark result after %.0f s" % timeout)
+        buf += os.read(fd, 512)
+
+
+def report(result, baseline, threshold):
+    """Print the result table and return the number of regressions."""
+    base = {r["name"]: r for r in baseline["results"]} if baseline else {}
+    if baseline and baseline.get("clk_hz") != result["clk_hz"]:
+        print("warning: baseline at %s Hz, result at %s Hz" % (baseline.get("clk_hz"), result["clk_hz"]))
+    print("%-20s %8s %8s %8s %9s %6s %9s" % ("case", "min", "mean", "max", "ns", "pins", "vs base"))
+    bad = 0
+    for r in result["results"]:
+        delta = ""
+        b = base.get(r["name"])
+        if b:
+            ratio = (r["mean"] - b["mean"]) / max(b["mean"], 1)
+            delta = "%+.1f%%" % (100 * ratio)
+            if ratio > threshold:
+                delta += " SLOW"
+                bad += 1
+        print("%-20s %8d %8d %8d %9d %6d %9s" % (r["name"], r["min"], r["mean"], r["max"], r["ns"], r["pins"], delta))
+    names = {r["name"] for r in result["results"]}
+    for name in base:
+        if name not in names:
+            print("%-20s missing" % name)
+            bad += 1
+    return bad
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="serial device of the clock, e.g. /dev/ttyACM0")
+    parser.add_argument("--json", help="saved result line instead of running the suite")
+    parser.add_argument("--calls", type=int, default=1000, help="timed calls per case")
+    parser.add_argument("--baseline", default=BASELINE)
+    parser.add_argument("--threshold", type=float, default=10.0, help="allowed mean slow down in percent")
+    parser.add_argument("--update", action="store_true", help="write the result as the baseline")
+    parser.add_argument("--timeout", type=float, default=30.0)
+    args = parser.parse_args()
+
+    if args.json:
+        with open(args.json) as f:
+            result = json.load(f)
+    elif args.port:
+        result = run_bench(args.port, args.calls, args.timeout)
+    else:
+        parser.error("a PORT or --json is required")
+
+    if args.update:
+        with open(args.baseline, "w") as f:
+            json.dump(result, f, indent=1)
+            f.write("\n")
+        report(result, None, 0)
+        print("baseline written to %s" % args.baseline)
+        return
+    baseline = None
+    if os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    else:
+        print("no baseline at %s, run with --update to record one" % args.baseline)
+    bad = report(result, baseline, args.threshold / 100)
+    if bad:
+        print("%d case(s) regressed" % bad)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
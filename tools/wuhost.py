@@ -0,0 +1,346 @@
+#!/usr/bin/env python3
+"""Host companion for wuClock over the USB CDC console.
+
+  wuhost.py PORT sync [--rounds N] [--check]
+      Serve a time synchronization session (SYNC/SQ/SR protocol, see TimeSync.h).
+      With --check a second session measures the residual offset after the first one.
+
+  wuhost.py - loopback [--rounds N] [--offset MS] [--jitter MS] [--bound MS]
+      Check the sync tool without a clock: a scripted fake clock on the far end of a pty,
+      with its wall clock --offset away from the host and up to --jitter of latency on its
+      transmit side, runs two sessions against sync_session. The estimated offset of the first
+      one and the residual of the second one must stay within --bound (5 ms by default).
+
+  wuhost.py PORT pulse [--interval S] [--count N]
+      Send host-stamped drift pulses (DRIFT P <host_us>) and print the drift report.
+
+  wuhost.py PORT light CURVE [--period S]
+      Feed a light curve to the auto-brightness filter (LIGHT SIM, see AmbientLight.h) and
+      report the display duty and the estimated energy against a display at full duty.
+      CURVE has one sample per line, "adc" or "seconds adc", samples every --period seconds
+      when the time is missing; # starts a comment.
+
+  wuhost.py PORT holiday RULES [--no-save]
+      Replace the holiday rules of the alarms (HOLIDAY, see Holiday.h), save them in flash
+      and print the holidays of this year. RULES has one rule per line: dd/mm, mm:n:dotw
+      (nth day of the week, n -1 the last, 0 is Sunday) or E+days/E-days from Easter, and M
+      to move it to the next Monday; # starts a comment.
+
+  wuhost.py PORT zone [--year Y] [--no-save]
+      Set the time zone of the clock (TZ, see TimeZone.h) to the rule of the host zone:
+      the standard offset and the DST changes found in the year, and save it in flash.
+
+Times are sent as microseconds since 01/01/1970 UTC, the base time the RTC of the clock
+counts; the clock derives the local time with its zone rule. Only the standard library is used.
+"""
+
+import argparse
+import calendar
+import os
+import select
+import random
+import sys
+import termios
+import threading
+import time
+import tty
+
+
+def utc_us():
+    """Host UTC time in microseconds since 01/01/1970."""
+    return time.time_ns() // 1000
+
+
+class Link:
+    """Line oriented raw serial link."""
+
+    def __init__(self, path, fd=None):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY) if fd is None else fd
+        if os.isatty(self.fd):
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            attrs[3] &= ~termios.ECHO
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.buf = b""
+        self.stamp = 0
+
+    def send(self, line):
+        os.write(self.fd, (line + "\n").encode())
+
+    def lines(self, timeout):
+        """Yield (line, host_us_at_arrival) until timeout seconds without data."""
+        while True:
+            while b"\n" in self.buf:
+                line, self.buf = self.buf.split(b"\n", 1)
+                yield line.decode(errors="replace").strip(), self.stamp
+            ready, _, _ = select.select([self.fd], [], [], timeout)
+            if not ready:
+                return
+            data = os.read(self.fd, 256)
+            self.stamp = utc_us()
+            self.buf += data
+
+
+def sync_session(link, rounds):
+    """Serve one session, return (offset_us, delay_us, result) reported by the clock."""
+    link.send("SYNC %d" % rounds)
+    for line, t2 in link.lines(2.0):
+        fields = line.split()
+        if len(fields) == 3 and fields[0] == "SQ":
+            t3 = utc_us()
+            link.send("SR %s %s %d %d" % (fields[1], fields[2], t2, t3))
+        elif len(fields) >= 4 and fields[0] == "SYNC":
+            return int(fields[1]), int(fields[2]), fields[3]
+    raise SystemExit("no SYNC result from the clock")
+
+
+def cmd_sync(link, args):
+    offset, delay, result = sync_session(link, args.rounds)
+    print("offset %+.3f ms, delay %.3f ms, %s" % (offset / 1000.0, delay / 1000.0, result))
+    if args.check:
+        time.sleep(2.0)                     # let the RTC reload at the next second boundary
+        offset, delay, result = sync_session(link, args.rounds)
+        print("residual %+.3f ms (round trip %.3f ms)" % (offset / 1000.0, delay / 1000.0))
+
+
+class FakeClock:
+    """Scripted firmware side of the SYNC/SQ/SR protocol (TimeSync.c) on a pty end."""
+
+    def __init__(self, link, offset_us, jitter_us, seed=1):
+        self.link = link
+        self.offset_us = offset_us          # clock wall time minus host time
+        self.jitter_us = jitter_us
+        self.rng = random.Random(seed)
+
+    def now(self):
+        return utc_us() + self.offset_us
+
+    def session(self, rounds):
+        best_offset, best_delay, replies = 0, None, 0
+        for seq in range(rounds):
+            t1 = self.now()
+            time.sleep(self.rng.uniform(0, self.jitter_us) / 1e6)   # USB transmit latency, asymmetric
+            self.link.send("SQ %d %d" % (seq, t1))
+            for line, rx in self.link.lines(0.5):
+                f = line.split()
+                if len(f) == 5 and f[0] == "SR" and int(f[1]) == seq and int(f[2]) == t1:
+                    t2, t3, t4 = int(f[3]), int(f[4]), rx + self.offset_us     # t4 at line arrival
+                    delay = (t4 - t1) - (t3 - t2)
+                    if delay >= 0 and (best_delay is None or delay < best_delay):
+                        best_delay, best_offset = delay, ((t2 - t1) + (t3 - t4)) // 2
+                    replies += 1
+                    break
+            time.sleep(0.05)                # TS_SPACING_US
+        if best_delay is None:
+            self.link.send("SYNC 0 -1 FAIL %d" % replies)
+            return
+        self.offset_us += best_offset       # step at once, the residual is measured right after
+        self.link.send("SYNC %d %d STEP %d" % (best_offset, best_delay, replies))
+
+    def run(self):
+        for line, _ in self.link.lines(5.0):
+            f = line.split()
+            if len(f) == 2 and f[0] == "SYNC":
+                self.session(int(f[1]))
+
+
+def cmd_loopback(args):
+    master, slave = os.openpty()
+    link = Link(os.ttyname(slave))
+    os.close(slave)
+    clock = FakeClock(Link(None, master), int(args.offset * 1000), int(args.jitter * 1000))
+    threading.Thread(target=clock.run, daemon=True).start()
+    true_offset = -clock.offset_us          # host minus clock, the value the session estimates
+    offset, delay, result = sync_session(link, args.rounds)
+    error = offset - true_offset
+    print("offset %+.3f ms (error %+.3f ms), delay %.3f ms, %s" % (offset / 1000.0, error / 1000.0, delay / 1000.0, result))
+    residual, delay, result = sync_session(link, args.rounds)
+    print("residual %+.3f ms (round trip %.3f ms)" % (residual / 1000.0, delay / 1000.0))
+    bound = args.bound * 1000
+    if abs(error) > bound or abs(residual) > bound:
+        raise SystemExit("FAIL: beyond %.1f ms" % args.bound)
+    print("PASS: within %.1f ms" % args.bound)
+
+
+def cmd_pulse(link, args):
+    for k in range(args.count):
+        link.send("DRIFT P %d" % utc_us())
+        print("pulse %d/%d" % (k + 1, args.count), file=sys.stderr)
+        if k + 1 < args.count:
+            time.sleep(args.interval)
+    link.send("DRIFT R")
+    for line, _ in link.lines(1.0):
+        if line.startswith("DRIFT"):
+            print(line)
+            return
+
+
+def read_curve(path, period):
+    """Return [(seconds, adc)] of a light curve file."""
+    curve = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split("#", 1)[0].split()
+            if len(fields) == 1:
+                curve.append((len(curve) * period, int(fields[0])))
+            elif len(fields) >= 2:
+                curve.append((float(fields[0]), int(fields[1])))
+    return curve
+
+
+def cmd_light(link, args):
+    curve = read_curve(args.curve, args.period)
+    if not curve:
+        raise SystemExit("empty light curve")
+    link.send("LIGHT SIM")                  # a new curve restarts the filter
+    for line, _ in link.lines(1.0):
+        if line == "OK":
+            break
+    else:
+        raise SystemExit("no answer to LIGHT SIM")
+    duty_s = display_uas = full_uas = total_uas = 0.0
+    changes = 0
+    step = None
+    for k, (t, adc) in enumerate(curve):
+        dt = curve[k + 1][0] - t if k + 1 < len(curve) else args.period
+        link.send("LIGHT SIM %d" % adc)
+        for line, _ in link.lines(1.0):
+            f = line.split()
+            if len(f) >= 16 and f[:2] == ["LIGHT", "SIM"]:
+                break
+        else:
+            raise SystemExit("no answer to LIGHT SIM %d" % adc)
+        duty, display, full, total = int(f[8]), int(f[10]), int(f[13]), int(f[16])
+        if step is not None and f[6] != step:
+            changes += 1
+        step = f[6]
+        print("%10.1f s adc %4d filt %4s step %s duty %3d display %6d uA" % (t, adc, f[4], step, duty, display))
+        duty_s += duty * dt
+        display_uas += display * dt
+        full_uas += full * dt
+        total_uas += total * dt
+    span = curve[-1][0] - curve[0][0] + args.period
+    mwh = lambda uas: uas * 5.0 / 3600.0 / 1000.0   # uA s at 5 V
+    print("samples %d span %.0f s mean duty %.1f/256 step changes %d" % (len(curve), span, duty_s / span, changes))
+    print("display %.3f mWh, %.3f mWh at full duty (%.0f%% saved)" % (mwh(display_uas), mwh(full_uas),
+          100.0 * (1.0 - display_uas / full_uas) if full_uas else 0.0))
+    print("board %.3f mWh, mean %.2f mA" % (mwh(total_uas), total_uas / span / 1000.0))
+
+
+def ask(link, line):
+    """Send a command and return the first line of the answer."""
+    link.send(line)
+    for answer, _ in link.lines(1.0):
+        if answer:
+            return answer
+    raise SystemExit("no answer to %s" % line)
+
+
+def cmd_holiday(link, args):
+    rules = []
+    with open(args.rules) as f:
+        for line in f:
+            fields = line.split("#", 1)[0].split()
+            if fields:
+                rules.append(" ".join(fields[:2]))
+    if ask(link, "HOLIDAY CLR") != "OK":
+        raise SystemExit("HOLIDAY CLR failed")
+    for rule in rules:
+        if ask(link, "HOLIDAY ADD " + rule) != "OK":
+            raise SystemExit("rule rejected: %s" % rule)
+    if not args.no_save and ask(link, "HOLIDAY SAVE") != "OK":
+        raise SystemExit("HOLIDAY SAVE failed")
+    link.send("HOLIDAY %d" % time.localtime().tm_year)
+    for line, _ in link.lines(1.0):
+        if line.startswith("HOLIDAY"):
+            print(line)
+            if " days " in line:
+                return
+
+
+def host_changes(year):
+    """Return [(utc, offset_before_s, offset_after_s)] of the host zone changes in a year."""
+    t, end = calendar.timegm((year, 1, 1, 0, 0, 0)), calendar.timegm((year + 1, 1, 1, 0, 0, 0))
+    changes = []
+    prev = time.localtime(t).tm_gmtoff
+    while t < end:
+        if time.localtime(t + 3600).tm_gmtoff != prev:
+            lo, hi = t, t + 3600            # first second of the new offset in (lo, hi]
+            while hi - lo > 1:
+                mid = (lo + hi) // 2
+                if time.localtime(mid).tm_gmtoff == prev:
+                    lo = mid
+                else:
+                    hi = mid
+            off = time.localtime(hi).tm_gmtoff
+            changes.append((hi, prev, off))
+            prev = off
+        t += 3600
+    return changes
+
+
+def zone_change(utc, before):
+    """mm:n:dotw/hh:mm of a change, at the local time in the offset before it."""
+    tm = time.gmtime(utc + before)
+    last = tm.tm_mday + 7 > calendar.monthrange(tm.tm_year, tm.tm_mon)[1]
+    week = -1 if last and tm.tm_mday > 21 else (tm.tm_mday - 1) // 7 + 1
+    return "%02d:%d:%d/%02d:%02d" % (tm.tm_mon, week, (tm.tm_wday + 1) % 7, tm.tm_hour, tm.tm_min)
+
+
+def cmd_zone(link, args):
+    year = args.year or time.localtime().tm_year
+    changes = host_changes(year)
+    if len(changes) == 2:
+        std = min(changes[0][1], changes[0][2])
+        dst = max(changes[0][1], changes[0][2]) - std
+        start = [c for c in changes if c[2] > c[1]][0]
+        end = [c for c in changes if c[2] < c[1]][0]
+        line = "TZ %d %d %s %s" % (std // 60, dst // 60, zone_change(start[0], start[1]), zone_change(end[0], end[1]))
+    elif not changes:
+        line = "TZ %d" % (time.localtime(calendar.timegm((year, 1, 1, 0, 0, 0))).tm_gmtoff // 60)
+    else:
+        raise SystemExit("the host zone changed %d times in %d, not a yearly DST rule" % (len(changes), year))
+    print(line)
+    answer = ask(link, line)
+    print(answer)
+    if answer.startswith("ERR"):
+        raise SystemExit(1)
+    if not args.no_save and ask(link, "TZ SAVE") != "OK":
+        raise SystemExit("TZ SAVE failed")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", help="serial device of the clock, e.g. /dev/ttyACM0")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("sync")
+    p.add_argument("--rounds", type=int, default=8)
+    p.add_argument("--check", action="store_true")
+    p = sub.add_parser("loopback")
+    p.add_argument("--rounds", type=int, default=8)
+    p.add_argument("--offset", type=float, default=1500.0)
+    p.add_argument("--jitter", type=float, default=1.0)
+    p.add_argument("--bound", type=float, default=5.0)
+    p = sub.add_parser("pulse")
+    p.add_argument("--interval", type=float, default=60.0)
+    p.add_argument("--count", type=int, default=60)
+    p = sub.add_parser("light")
+    p.add_argument("curve")
+    p.add_argument("--period", type=float, default=1.0)
+    p = sub.add_parser("holiday")
+    p.add_argument("rules")
+    p.add_argument("--no-save", action="store_true")
+    p = sub.add_parser("zone")
+    p.add_argument("--year", type=int, default=0)
+    p.add_argument("--no-save", action="store_true")
+    args = parser.parse_args()
+
+    if args.cmd == "loopback":
+        return cmd_loopback(args)
+    link = Link(args.port)
+    {"sync": cmd_sync, "pulse": cmd_pulse, "light": cmd_light, "holiday": cmd_holiday,
+     "zone": cmd_zone}[args.cmd](link, args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""Decode the wuClock binary trace (see Trace.h) into a readable timeline.
+
+  wutrace.py PORT              enable draining (TRACE ON) and decode live until Ctrl-C
+  wutrace.py --file CAPTURE    decode a raw capture of the console stream
+  wutrace.py ... --wav FILE    also render the buzzer tones (TONE events) to a WAV file
+
+Frames are 0x00 COBS(packet) 0x00 mixed with the console text; chunks that are not valid
+trace packets are shown as text with --text.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import termios
+import tty
+import wave
+
+MAGIC = 0xA5
+
+EVENTS = ["BOOT", "STATE", "PB_EVENT", "ALARM_STATE", "TB_MISS", "TONE"]
+STATES = ["Normal", "SetTime", "SetAlarm", "SetSnooze", "Alarm", "ShowDate", "Snooze"]
+PB_EVENTS = ["NONE", "ONCE", "TWICE", "MORE"]
+ALARM_STATES = ["READY", "ON", "OFF", "SUSPENDED"]
+APP_EVENTS = ["%s_%s" % (b, e) for b in ("SET_TIME", "SET_ALARM", "PLUS", "MINUS", "SNOOZE", "SHOW_DATE")
+              for e in ("ONCE", "TWICE", "MORE")] + ["TICK", "ALARM", "SOUND_END", "SNOOZE_END", "EDIT_IDLE"]
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, same as fstore_crc16."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def name(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def describe(eid, a, b):
+    if eid == 1:
+        return "STATE %s -> %s on %s" % (name(STATES, b & 0xFF), name(STATES, a), name(APP_EVENTS, b >> 8))
+    if eid == 2:
+        return "PB_EVENT gpio %d %s" % (a, name(PB_EVENTS, b))
+    if eid == 3:
+        return "ALARM %s -> %s" % (name(ALARM_STATES, b), name(ALARM_STATES, a))
+    if eid == 4:
+        return "TB_MISS %d period(s) time base @..%04x" % (a, b)
+    if eid == 5:
+        return "TONE %d Hz volume %d" % (b, a) if b else "TONE off"
+    return "%s a=%d b=%d" % (name(EVENTS, eid) if eid < len(EVENTS) else "USER%d" % (eid - len(EVENTS)), a, b)
+
+
+class Decoder:
+    def __init__(self, show_text):
+        self.show_text = show_text
+        self.buf = b""
+        self.last = None            # last 32 bit timestamp
+        self.high = 0               # unwrapped high part
+        self.origin = None
+        self.seq = None
+        self.lost = 0
+        self.tones = []             # (time s, Hz, volume) of the TONE events
+
+    def feed(self, data):
+        self.buf += data
+        while b"\x00" in self.buf:
+            chunk, self.buf = self.buf.split(b"\x00", 1)
+            if chunk:
+                self.chunk(chunk)
+
+    def chunk(self, chunk):
+        pkt = cobs_decode(chunk)
+        if not pkt or len(pkt) < 7 or pkt[0] != MAGIC or crc16(pkt[:-2]) != struct.unpack_from("<H", pkt, len(pkt) - 2)[0]:
+            if self.show_text:
+                sys.stdout.write(chunk.decode(errors="replace"))
+            return
+        seq, count, lost = pkt[1], pkt[2], struct.unpack_from("<H", pkt, 3)[0]
+        if len(pkt) != 7 + 8 * count:
+            return
+        if self.seq is not None and seq != (self.seq + 1) & 0xFF:
+            print("-- %d packet(s) missing" % ((seq - self.seq - 1) & 0xFF))
+        if lost != self.lost:
+            print("-- %d record(s) overwritten on the clock" % ((lost - self.lost) & 0xFFFF))
+            self.lost = lost
+        self.seq = seq
+        for k in range(count):
+            ts, eid, a, b = struct.unpack_from("<IBBH", pkt, 5 + 8 * k)
+            if eid == 0:
+                self.last, self.high, self.origin = None, 0, None
+            if self.last is not None and ts < self.last:
+                self.high += 1 << 32
+            self.last = ts
+            t = self.high + ts
+            if self.origin is None:
+                self.origin = t
+            print("%12.6f  %s" % ((t - self.origin) / 1e6, describe(eid, a, b)))
+            if eid == 5:
+                self.tones.append(((t - self.origin) / 1e6, b, a))
+
+
+def render_wav(path, tones, rate=22050):
+    """Render the tones as the PWM output: a square wave with a duty cycle of volume / 510."""
+    if not tones:
+        print("no TONE events, %s not written" % path)
+        return
+    end = tones[-1][0] + (0.5 if tones[-1][1] else 0)
+    samples = bytearray(b"\x80" * int(end * rate))
+    phase = 0.0
+    for k, (t, hz, vol) in enumerate(tones):
+        stop = tones[k + 1][0] if k + 1 < len(tones) else end
+        duty = vol / 510
+        if not hz:
+            continue
+        for n in range(int(t * rate), min(int(stop * rate), len(samples))):
+            phase = (phase + hz / rate) % 1.0
+            samples[n] = 0xE0 if phase < duty else 0x20
+    with wave.open(path, "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(1)
+        w.setframerate(rate)
+        w.writeframes(bytes(samples))
+    print("%d tone change(s), %.1f s written to %s" % (len(tones), end, path))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("port", nargs="?", help="serial device of the clock, e.g. /dev/ttyACM0")
+    parser.add_argument("--file", help="raw capture of the console stream")
+    parser.add_argument("--text", action="store_true", help="also print the console text")
+    parser.add_argument("--wav", help="render the buzzer tones to this WAV file")
+    args = parser.parse_args()
+    dec = Decoder(args.text)
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            dec.feed(f.read())
+        dec.feed(b"\x00")
+        if args.wav:
+            render_wav(args.wav, dec.tones)
+        return
+    if not args.port:
+        parser.error("a PORT or --file is required")
+    fd = os.open(args.port, os.O_RDWR | os.O_NOCTTY)
+    if os.isatty(fd):
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCIFLUSH)
+    os.write(fd, b"TRACE ON\n")
+    try:
+        while True:
+            dec.feed(os.read(fd, 512))
+    except KeyboardInterrupt:
+        os.write(fd, b"TRACE OFF\n")
+        if args.wav:
+            render_wav(args.wav, dec.tones)
+
+
+if __name__ == "__main__":
+    main()
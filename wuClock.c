@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "pico/stdlib.h"
 #include "PushButton.h"
 #include "SevenSegments.h"
@@ -7,116 +8,1379 @@
 #include "SmartLED.h"
 #include "WatchUI.h"
 #include "Time4H.h"
+#include "Calendar.h"
+#include "Console.h"
+#include "RtcDrift.h"
+#include "TimeSync.h"
+#include "Trace.h"
+#include "Profile.h"
+#include "Replay.h"
+#include "Bench.h"
+#include "OutputStage.h"
+#include "Audio.h"
+#include "Fsm.h"
+#include "FieldEditor.h"
+#include "DualCore.h"
+#include "ClockGov.h"
+#include "WarmBoot.h"
+#include "AmbientLight.h"
+#include "Energy.h"
+#include "Holiday.h"
+#include "TimeZone.h"
 
 
 watch_ui_t watchUI;  ///< Global variable for the watch UI
 time_h_t timeHandler;  ///< Global variable for the time handler
 ui_event_t events;  ///< Array to hold events from push buttons
+console_t console;  ///< Command console over USB
+rtc_drift_t rtcDrift;  ///< RTC drift measurement and trim
+time_sync_t timeSync;  ///< Time synchronization with the host
 
+#define APP_SUNRISE_S 600  ///< The alarm LED rises to full brightness during the last 10 minutes before the alarm
+static time_base_t sunriseTB;  ///< Checks the time left to the alarm every second
+static bool appSunrise;  ///< The sunrise ramp of the alarm LED is running or done
+static time_base_t checkpointTB;  ///< Period of the warm boot checkpoint
+static const uint32_t appEnergyModel[EN_NUM_PARTS] = {WATCH_UI_SEG_UA, WATCH_UI_LED_UA, EN_BUZZER_UA, CG_UA_PER_MHZ, CG_BOARD_UA};  ///< Default current model
 
-void (* CurrentState)(void);
-void StateSetTime(void);
-void StateSetAlarm(void);
-void StateSetSnooze(void);
-void StateShowDate(void);
-void StateNormal(void);
-void StateAlarm(void);
-void StateSnooze(void);
+typedef enum{
+    APP_SOUND_MELODY = 0,  ///< Tone melody of the buzzer, watchAlarmRing
+    APP_SOUND_CHIME  ///< Sample clip audChime, looped
+} app_sound_t;
+static app_sound_t appAlarmSound = APP_SOUND_MELODY;  ///< Alarm sound source, see the SOUND command
+
+
+/// Application events: the push button events, button * 3 + pb event - 1 with the buttons in the
+/// order of the ui_event_t fields, then the events of the application sources
+typedef enum{
+    EV_SET_TIME_ONCE, EV_SET_TIME_TWICE, EV_SET_TIME_MORE,
+    EV_SET_ALARM_ONCE, EV_SET_ALARM_TWICE, EV_SET_ALARM_MORE,
+    EV_PLUS_ONCE, EV_PLUS_TWICE, EV_PLUS_MORE,
+    EV_MINUS_ONCE, EV_MINUS_TWICE, EV_MINUS_MORE,
+    EV_SNOOZE_ONCE, EV_SNOOZE_TWICE, EV_SNOOZE_MORE,
+    EV_SHOW_DATE_ONCE, EV_SHOW_DATE_TWICE, EV_SHOW_DATE_MORE,
+    EV_TICK,            ///< The time handler refreshed the time
+    EV_ALARM,           ///< The alarm is READY
+    EV_SOUND_END,       ///< The alarm sound ended by its time limit
+    EV_SNOOZE_END,      ///< The snooze period ended
+    EV_EDIT_IDLE,       ///< No key during FE_IDLE_US in a setting mode
+    EV_NUM
+} app_event_t;
+
+/// Application services of the states, above the WATCH_UI_* bits
+#define APP_SRC_TIME    (1u << 8)   ///< t4h_refresh_time, EV_TICK
+#define APP_SRC_ALARM   (1u << 9)   ///< Alarm READY, EV_ALARM
+#define APP_SRC_SUNRISE (1u << 10)  ///< Sunrise ramp of the alarm LED
+#define APP_SRC_SOUND   (1u << 11)  ///< End of the alarm sound, EV_SOUND_END
+#define APP_SRC_SNOOZE  (1u << 12)  ///< End of the snooze period, EV_SNOOZE_END
+#define APP_SRC_EDIT    (1u << 13)  ///< Inactivity of the setting modes, EV_EDIT_IDLE
+#ifdef WUCLOCK_DUAL_CORE
+#define APP_OUTPUTS     0           ///< Display multiplex and patterns run on core1
+#else
+#define APP_OUTPUTS     (WATCH_UI_DISPLAY | WATCH_UI_PATTERN)
+#endif
+
+fsm_t appFsm;  ///< Application state machine, states are watch_ui_state_t
+fe_editor_t appEditor;  ///< Field editor of the setting modes
+
+static void app_pass(void);
+static void app_boot(void);
+static void app_restore(const wb_checkpoint_t *C, const datetime_t *rtcNow);
+static void app_checkpoint(void);
+static void app_energy_report(const char *tag, bool pins);
+static void app_load_time(void);
+static void app_rearm_alarm(void);
+static void app_show_time(void);
+static void app_sunrise(void);
+static void app_alarm_sound(bool on);
+static uint8_t app_clock_sources(void);
+static const char *alarmStateName[] = {"READY", "ON", "OFF", "SUSPENDED"};   ///< Names of alarm_state_t
+
+void cmd_time(console_t *C, int argc, char *argv[]);
+void cmd_date(console_t *C, int argc, char *argv[]);
+void cmd_alarm(console_t *C, int argc, char *argv[]);
+void cmd_snooze(console_t *C, int argc, char *argv[]);
+void cmd_drift(console_t *C, int argc, char *argv[]);
+void cmd_sync(console_t *C, int argc, char *argv[]);
+void cmd_sync_reply(console_t *C, int argc, char *argv[]);
+void cmd_trace(console_t *C, int argc, char *argv[]);
+void cmd_prof(console_t *C, int argc, char *argv[]);
+void cmd_replay(console_t *C, int argc, char *argv[]);
+void cmd_soak(console_t *C, int argc, char *argv[]);
+void cmd_bench(console_t *C, int argc, char *argv[]);
+void cmd_out(console_t *C, int argc, char *argv[]);
+void cmd_sound(console_t *C, int argc, char *argv[]);
+void cmd_core(console_t *C, int argc, char *argv[]);
+void cmd_disp(console_t *C, int argc, char *argv[]);
+void cmd_input(console_t *C, int argc, char *argv[]);
+void cmd_clk(console_t *C, int argc, char *argv[]);
+void cmd_boot(console_t *C, int argc, char *argv[]);
+void cmd_light(console_t *C, int argc, char *argv[]);
+void cmd_energy(console_t *C, int argc, char *argv[]);
+void cmd_holiday(console_t *C, int argc, char *argv[]);
+void cmd_tz(console_t *C, int argc, char *argv[]);
+
+const con_cmd_t appCommands[] = {   ///< Console commands, see HELP
+    {"TIME", cmd_time, "TIME [hh:mm[:ss]]"},
+    {"DATE", cmd_date, "DATE [dd/mm/yyyy]"},
+    {"ALARM", cmd_alarm, "ALARM [ON|OFF|hh:mm [D|W <0-6>|T <dd/mm/yyyy>]]"},
+    {"SNOOZE", cmd_snooze, "SNOOZE [1-30]"},
+    {"DRIFT", cmd_drift, "DRIFT P <host_us>|R|C|A [D|L]|S <ppb> [D|L]"},
+    {"SYNC", cmd_sync, "SYNC [n]|R"},
+    {"SR", cmd_sync_reply, "SR <seq> <t1> <t2> <t3>"},
+    {"TRACE", cmd_trace, "TRACE [ON|OFF|CLR]"},
+    {"PROF", cmd_prof, "PROF [CLR]"},
+    {"REPLAY", cmd_replay, "REPLAY [n|ALL]"},
+    {"SOAK", cmd_soak, "SOAK [years [from]]"},
+    {"BENCH", cmd_bench, "BENCH [calls]"},
+    {"OUT", cmd_out, "OUT [CLR]"},
+    {"SOUND", cmd_sound, "SOUND [MELODY|CHIME|STOP]"},
+    {"CORE", cmd_core, "CORE [CLR]"},
+    {"DISP", cmd_disp, "DISP [CLR]"},
+    {"INPUT", cmd_input, "INPUT [CLR]"},
+    {"CLK", cmd_clk, "CLK [CLR|AUTO|IDLE|USB|ACTIVE]"},
+    {"BOOT", cmd_boot, "BOOT [REBOOT]"},
+    {"LIGHT", cmd_light, "LIGHT [AUTO|duty 1-256|SIM [adc]]"},
+    {"ENERGY", cmd_energy, "ENERGY [CLR|MODEL [SEG|LED|BUZZER|MHZ|BOARD uA]]"},
+    {"HOLIDAY", cmd_holiday, "HOLIDAY [yyyy|SKIP [ON|OFF]|LIST|CLR|DEF|SAVE|ADD dd/mm|mm:n:dotw|E+-days [M]]"},
+    {"TZ", cmd_tz, "TZ [SAVE|std_min [dst_min mm:n:dotw/hh:mm mm:n:dotw/hh:mm]]"},
+};
 
 void main(void)
 {
-    stdio_init_all();
-    watch_ui_init(&watchUI);  ///< Initialize the watch UI
-    t4h_init(&timeHandler);  ///< Initialize the time handler
+    trace_init();  ///< First record of the trace is the boot
+    bool warm = wb_restore(&wbBoot);  ///< Checkpoint left by a reset that kept the power
+    datetime_t rtcNow;
+    wbBoot.rtcKept = warm && rtc_get_datetime(&rtcNow);  ///< Read before rtc_init resets it, false when stopped
+    if(!warm)
+        stdio_init_all();  ///< A warm boot starts the USB after the first frame
+    cg_init(&cgGov);  ///< Boot clock until the first hold ends
+    en_init(&enMeter, appEnergyModel);  ///< Before the display starts, it reports its slots
+#ifdef WUCLOCK_DUAL_CORE
+    dc_init(&dcLink);  ///< Spin locks of the core mailbox, the pattern player and the trace
+#endif
+    hol_init(&holCalendar);  ///< Holiday rules saved over USB, or the default set
+    tz_init(&tzZone);  ///< Zone rule of the local time, the RTC counts UTC
+    app_boot();  ///< Initialize the watch UI, the time handler and the first state
+    en_add_output(&enMeter, watchUI.ledAlarm.numGPIO, EN_LED);
+    en_add_output(&enMeter, watchUI.ledHourUP.numGPIO, EN_LED);
+    en_add_output(&enMeter, watchUI.ledHourDOWN.numGPIO, EN_LED);
+    en_add_output(&enMeter, watchUI.buzzer.numGPIO, EN_BUZZER);
+    if(warm)
+        app_restore(&wbBoot.cp, wbBoot.rtcKept ? &rtcNow : NULL);  ///< Settings, state and display of the checkpoint
+    rtc_init();  ///< Start the RTC with the date of the time handler
+    t4h_update_rtc_time(&timeHandler);
+    if(warm && wbBoot.cp.rtcAlarm)
+        t4h_update_rtc_alarm(&timeHandler);
+
+    prof_init();  ///< Start the cycle counter used by the profiling probes
+#ifdef WUCLOCK_DUAL_CORE
+    dc_start(&dcLink, &watchUI.ssDisplay);  ///< Core1 takes over the display, the LEDs and the buzzer
+#endif
+    app_pass();  ///< First frame, published to the refresh ISR
+#ifdef WUCLOCK_DUAL_CORE
+    dc_publish(&dcLink, &watchUI.ssDisplay);
+#endif
+    out_commit();
+    wb_first_frame(&wbBoot);
+    if(warm)
+        stdio_init_all();
 
-    CurrentState = StateNormal;
+    datetime_t utc;
+    t4h_local_to_utc(&timeHandler.date, &utc);
+    ts_init(&timeSync, &utc);  ///< Align the wall clock, in UTC like the RTC
+    con_init(&console, appCommands, count_of(appCommands));  ///< Initialize the host command console
+    drift_init(&rtcDrift);  ///< Restore the persisted RTC trim
+    al_init(&alSensor);  ///< The display brightness follows the ambient light
+    tb_init(&checkpointTB, WB_PERIOD_US, true);
+    app_checkpoint();  ///< A reset from now on boots warm
 
-    printf("Hello, world!\n");
-        sleep_ms(1000);
+    con_printf("wuClock ready, type HELP\n");
     while (true) {
-        CurrentState();  // Call the current state function
+        PROF_PASS();
+        PROF(PROF_STATE_NORMAL + appFsm.state, app_pass());  ///< Services and transitions of the current state
+#ifdef WUCLOCK_DUAL_CORE
+        dc_publish(&dcLink, &watchUI.ssDisplay);  ///< Send the display drawn in this pass to core1
+#endif
+        PROF(PROF_OUT_COMMIT, out_commit());  ///< Write the outputs posted by the drivers in this pass
+#ifndef WUCLOCK_DUAL_CORE
+        en_outputs(&enMeter);  ///< Levels of the LEDs and the buzzer just committed
+#endif
+        en_process(&enMeter, appFsm.state, cgSettings[cgGov.level].khz);  ///< Book the pass to its state
+        PROF(PROF_CONSOLE, con_process(&console));  ///< Serve host commands with a bounded cost per pass
+        PROF(PROF_TRACE_DRAIN, trace_drain(&console));  ///< Send pending trace records when the console is idle
+        prof_dump(&console);  ///< Print the profiler statistics requested with PROF
+        PROF(PROF_DRIFT, drift_process(&rtcDrift));  ///< Insert or delete leap seconds for the RTC trim
+        bool reload;
+        PROF(PROF_SYNC, reload = ts_process(&timeSync, &utc));
+        if(reload){  ///< Reload the RTC after a host synchronization
+            t4h_update_rtc_utc(&timeHandler, &utc);
+            app_rearm_alarm();
+        }
+        PROF(PROF_CLOCK, cg_process(&cgGov, app_clock_sources()));  ///< Lower clk_sys when the work of the pass allows it
+        bool dim;
+        PROF(PROF_LIGHT, dim = al_process(&alSensor));
+        if(dim)  ///< New brightness step
+            ss_set_duty(&watchUI.ssDisplay, al_duty(&alSensor));
+        bool checkpoint = tb_check(&checkpointTB);  ///< Every second
+        if(checkpoint)
+            tb_next(&checkpointTB);
+        if(checkpoint || appFsm.state != wbBoot.cp.state)  ///< and at every state change, the period is kept
+            app_checkpoint();
+    }
+}
+
+
+
+/**
+ * \fn static void app_pass(void)
+ * \brief One pass of the current state: run its services and dispatch their events
+ * \details Only the sources in the services mask of the state run, so a state costs what it uses
+ * whatever the number of states. The events of one pass are dispatched in a fixed order: time
+ * tick, push buttons in the order of the ui_event_t fields, alarm, end of the sound, end of the
+ * snooze, inactivity of a setting.
+ */
+static void app_pass(void){
+    uint16_t services = fsm_services(&appFsm);
+    if(services & APP_SRC_SUNRISE)
+        app_sunrise();  ///< Start the pre-alarm ramp of the alarm LED
+    if((services & APP_SRC_TIME) && t4h_refresh_time(&timeHandler))
+        fsm_dispatch(&appFsm, EV_TICK);
+    PROF(PROF_UI_PROCESS, watch_ui_process(&watchUI, services, &events));
+    for(uint16_t all = events.all, button = 0; all; all >>= 2, button++)
+        if(all & 3)
+            fsm_dispatch(&appFsm, button * 3 + (all & 3) - 1);
+    if((services & APP_SRC_ALARM) && t4h_get_alarm_state(&timeHandler) == T4H_ALARM_READY)
+        fsm_dispatch(&appFsm, EV_ALARM);
+    if((services & APP_SRC_SOUND) && !pat_is_playing(&watchUI.buzzer.pat) && !aud_is_playing(&aud))
+        fsm_dispatch(&appFsm, EV_SOUND_END);  ///< Not attended within the ring time limit
+    if((services & APP_SRC_SNOOZE) && tb_check(&timeHandler.postTB))
+        fsm_dispatch(&appFsm, EV_SNOOZE_END);
+    if((services & APP_SRC_EDIT) && fe_idle(&appEditor))
+        fsm_dispatch(&appFsm, EV_EDIT_IDLE);  ///< Cancelled, the shadow copy is dropped
+}
+
+static void app_alarm_enable(void){ t4h_enable_alarm(&timeHandler); }
+static void app_alarm_disable(void){ t4h_disable_alarm(&timeHandler); }
+static void app_alarm_enter(void){ app_alarm_sound(true); }  ///< Escalating alarm sound, it ends by itself after 60 s
+static void app_alarm_exit(void){   ///< The alarm was attended or timed out, silence it and end the sunrise light
+    app_alarm_sound(false);
+    sLED_off(&watchUI.ledAlarm);
+    appSunrise = false;
+}
+static void app_snooze_enter(void){ t4h_start_post(&timeHandler); }
+static void app_snooze_end(void){ tb_disable(&timeHandler.postTB); }
+static void app_snooze_cancel(void){ t4h_stop_post(&timeHandler); }
+
+/**
+ * \fn static void app_show_date(void)
+ * \brief Show the day and month of the time handler on the display
+ */
+static void app_show_date(void){
+    uint8_t day = t4h_get_day(&timeHandler), month = t4h_get_month(&timeHandler);
+    ss_update_value(&watchUI.ssDisplay, 0, month % 10);
+    ss_update_value(&watchUI.ssDisplay, 1, month / 10);
+    ss_update_value(&watchUI.ssDisplay, 2, day % 10);
+    ss_update_value(&watchUI.ssDisplay, 3, day / 10);
+}
+
+enum{APP_F_HOUR, APP_F_MIN, APP_F_DAY, APP_F_MONTH, APP_F_YEAR};   ///< Fields of appTimeFields
+
+static int16_t app_days_limit(const int16_t *v){ return cal_days_in_month(v[APP_F_YEAR], v[APP_F_MONTH]); }
+
+/// Setting of the time and the date: hh mm, dd mm, yyyy. The alarm uses the first two fields.
+static const fe_field_t appTimeFields[] = {
+    {0, 2, 2, 0, 23, true, NULL},
+    {0, 0, 2, 0, 59, true, NULL},
+    {1, 2, 2, 1, 31, true, app_days_limit},
+    {1, 0, 2, 1, 12, true, NULL},
+    {2, 0, 4, 2000, CAL_YEAR_MAX, false, NULL},
+};
+
+static const fe_field_t appSnoozeFields[] = {   ///< Snooze period in minutes, README: 1 to 30
+    {0, 0, 2, 1, 30, false, NULL},
+};
+
+static void app_set_time_enter(void){
+    t4h_read_local(&timeHandler.date);
+    datetime_t *d = &timeHandler.date;
+    int16_t v[] = {d->hour, d->min, d->day, d->month, d->year};
+    fe_start(&appEditor, &watchUI.ssDisplay, appTimeFields, count_of(appTimeFields), v);
+}
+static void app_set_time_commit(void){   ///< The whole shadow copy in one RTC write
+    int16_t *v = appEditor.value;
+    t4h_set_time_hour(&timeHandler, v[APP_F_HOUR], v[APP_F_MIN]);
+    t4h_set_time_date(&timeHandler, v[APP_F_DAY], v[APP_F_MONTH], v[APP_F_YEAR]);
+    t4h_set_time_dotw(&timeHandler, cal_dotw(v[APP_F_YEAR], v[APP_F_MONTH], v[APP_F_DAY]));
+    app_load_time();
+}
+static void app_set_alarm_enter(void){
+    int16_t v[] = {timeHandler.alarm.hour, timeHandler.alarm.min};
+    fe_start(&appEditor, &watchUI.ssDisplay, appTimeFields, 2, v);
+}
+static void app_set_alarm_commit(void){
+    t4h_set_alarm_hour(&timeHandler, appEditor.value[APP_F_HOUR], appEditor.value[APP_F_MIN]);
+    t4h_update_rtc_alarm(&timeHandler);
+    t4h_enable_alarm(&timeHandler);
+}
+static void app_set_snooze_enter(void){
+    int16_t v[] = {timeHandler.postPeriod};
+    fe_start(&appEditor, &watchUI.ssDisplay, appSnoozeFields, count_of(appSnoozeFields), v);
+}
+static void app_set_snooze_commit(void){ t4h_set_post_period(&timeHandler, appEditor.value[0]); }
+static bool app_edit_last(void){ return fe_is_last(&appEditor); }
+static void app_edit_next(void){ fe_next(&appEditor); }
+static void app_edit_exit(void){ fe_stop(&appEditor); }
+/// +/- pressed once, twice or more within the push button window step 1, 2 or 10 units
+static void app_edit_up1(void){ fe_step(&appEditor, 1); }
+static void app_edit_up2(void){ fe_step(&appEditor, 2); }
+static void app_edit_up10(void){ fe_step(&appEditor, 10); }
+static void app_edit_down1(void){ fe_step(&appEditor, -1); }
+static void app_edit_down2(void){ fe_step(&appEditor, -2); }
+static void app_edit_down10(void){ fe_step(&appEditor, -10); }
+
+#define APP_EDIT_SERVICES (WATCH_UI_PB_PLUS | WATCH_UI_PB_MINUS | APP_SRC_EDIT | APP_OUTPUTS)
+
+/// Rows of a setting mode: its button accepts a field (the last one commits), twice cancels
+#define APP_EDIT_ROWS(state, ONCE, TWICE, commit) \
+    {state, ONCE, app_edit_last, commit, WATCH_UI_STATE_NORMAL}, \
+    {state, ONCE, NULL, app_edit_next, FSM_SAME}, \
+    {state, TWICE, NULL, NULL, WATCH_UI_STATE_NORMAL}, \
+    {state, EV_PLUS_ONCE, NULL, app_edit_up1, FSM_SAME}, \
+    {state, EV_PLUS_TWICE, NULL, app_edit_up2, FSM_SAME}, \
+    {state, EV_PLUS_MORE, NULL, app_edit_up10, FSM_SAME}, \
+    {state, EV_MINUS_ONCE, NULL, app_edit_down1, FSM_SAME}, \
+    {state, EV_MINUS_TWICE, NULL, app_edit_down2, FSM_SAME}, \
+    {state, EV_MINUS_MORE, NULL, app_edit_down10, FSM_SAME}, \
+    {state, EV_EDIT_IDLE, NULL, NULL, WATCH_UI_STATE_NORMAL}
+
+/// States indexed by watch_ui_state_t, the order of the PROF_STATE_* probes
+static const fsm_state_t appStates[] = {
+    {"NORMAL", app_show_time, NULL, APP_SRC_TIME | APP_SRC_ALARM | APP_SRC_SUNRISE | WATCH_UI_PB_SET_TIME | WATCH_UI_PB_SET_ALARM |
+        WATCH_UI_PB_SNOOZE | WATCH_UI_PB_SHOW_DATE | APP_OUTPUTS},
+    {"SET_TIME", app_set_time_enter, app_edit_exit, WATCH_UI_PB_SET_TIME | APP_EDIT_SERVICES},
+    {"SET_ALARM", app_set_alarm_enter, app_edit_exit, WATCH_UI_PB_SET_ALARM | APP_EDIT_SERVICES},
+    {"SET_SNOOZE", app_set_snooze_enter, app_edit_exit, WATCH_UI_PB_SNOOZE | APP_EDIT_SERVICES},
+    {"ALARM", app_alarm_enter, app_alarm_exit, APP_SRC_TIME | APP_SRC_SOUND | WATCH_UI_PB_SET_ALARM | WATCH_UI_PB_SNOOZE | APP_OUTPUTS},
+    {"SHOW_DATE", app_show_date, NULL, WATCH_UI_PB_SHOW_DATE | APP_OUTPUTS},
+    {"SNOOZE", app_snooze_enter, NULL, APP_SRC_TIME | APP_SRC_SNOOZE | WATCH_UI_PB_SET_ALARM | APP_OUTPUTS},
+};
+
+/// Transitions: state, event, guard, action, next. Rows of a state and event are consecutive.
+static const fsm_transition_t appTransitions[] = {
+    {WATCH_UI_STATE_NORMAL, EV_TICK, NULL, app_show_time, FSM_SAME},
+    {WATCH_UI_STATE_NORMAL, EV_ALARM, NULL, NULL, WATCH_UI_STATE_ALARM},
+    {WATCH_UI_STATE_NORMAL, EV_SET_TIME_TWICE, NULL, NULL, WATCH_UI_STATE_SET_TIME},
+    {WATCH_UI_STATE_NORMAL, EV_SET_ALARM_ONCE, NULL, app_alarm_enable, FSM_SAME},
+    {WATCH_UI_STATE_NORMAL, EV_SET_ALARM_TWICE, NULL, NULL, WATCH_UI_STATE_SET_ALARM},
+    {WATCH_UI_STATE_NORMAL, EV_SNOOZE_TWICE, NULL, NULL, WATCH_UI_STATE_SET_SNOOZE},
+    {WATCH_UI_STATE_NORMAL, EV_SHOW_DATE_TWICE, NULL, NULL, WATCH_UI_STATE_SHOW_DATE},
+
+    APP_EDIT_ROWS(WATCH_UI_STATE_SET_TIME, EV_SET_TIME_ONCE, EV_SET_TIME_TWICE, app_set_time_commit),
+    APP_EDIT_ROWS(WATCH_UI_STATE_SET_ALARM, EV_SET_ALARM_ONCE, EV_SET_ALARM_TWICE, app_set_alarm_commit),
+    APP_EDIT_ROWS(WATCH_UI_STATE_SET_SNOOZE, EV_SNOOZE_ONCE, EV_SNOOZE_TWICE, app_set_snooze_commit),
+    {WATCH_UI_STATE_SHOW_DATE, EV_SHOW_DATE_ONCE, NULL, NULL, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_SHOW_DATE, EV_SHOW_DATE_TWICE, NULL, NULL, WATCH_UI_STATE_NORMAL},
+
+    {WATCH_UI_STATE_ALARM, EV_TICK, NULL, app_show_time, FSM_SAME},
+    {WATCH_UI_STATE_ALARM, EV_SET_ALARM_ONCE, NULL, app_alarm_disable, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_ALARM, EV_SET_ALARM_TWICE, NULL, app_alarm_disable, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_ALARM, EV_SET_ALARM_MORE, NULL, app_alarm_disable, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_ALARM, EV_SNOOZE_ONCE, NULL, NULL, WATCH_UI_STATE_SNOOZE},
+    {WATCH_UI_STATE_ALARM, EV_SNOOZE_TWICE, NULL, NULL, WATCH_UI_STATE_SNOOZE},
+    {WATCH_UI_STATE_ALARM, EV_SNOOZE_MORE, NULL, NULL, WATCH_UI_STATE_SNOOZE},
+    {WATCH_UI_STATE_ALARM, EV_SOUND_END, NULL, app_alarm_enable, WATCH_UI_STATE_NORMAL},  ///< Ring again at the next occurrence
+
+    {WATCH_UI_STATE_SNOOZE, EV_TICK, NULL, app_show_time, FSM_SAME},
+    {WATCH_UI_STATE_SNOOZE, EV_SNOOZE_END, NULL, app_snooze_end, WATCH_UI_STATE_ALARM},
+    {WATCH_UI_STATE_SNOOZE, EV_SET_ALARM_ONCE, NULL, app_snooze_cancel, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_SNOOZE, EV_SET_ALARM_TWICE, NULL, app_snooze_cancel, WATCH_UI_STATE_NORMAL},
+    {WATCH_UI_STATE_SNOOZE, EV_SET_ALARM_MORE, NULL, app_snooze_cancel, WATCH_UI_STATE_NORMAL},
+};
+
+/**
+ * \fn static void app_alarm_sound(bool on)
+ * \brief Start or stop the alarm sound of the selected source, both sources stop by themselves after 60 s
+ */
+static void app_alarm_sound(bool on){
+    buzzer_stop_ring(&watchUI.buzzer);
+    aud_stop(&aud);  ///< Gives the PWM slice back before the buzzer and the LED use it
+    if(!on)
+        return;
+    if(appAlarmSound == APP_SOUND_CHIME)
+        aud_play(&aud, &audChime, true, true);
+    else
+        buzzer_ring(&watchUI.buzzer, watchAlarmRing);
+}
+
+/**
+ * \fn static uint8_t app_clock_sources(void)
+ * \brief Sources of the clock governor active in this pass: a clip, a console line or output to the host
+ */
+static uint8_t app_clock_sources(void){
+    static uint64_t lineTime;  ///< Last console line seen
+    uint8_t sources = aud_is_playing(&aud) ? CG_AUDIO : 0;
+    if(console.lineTime != lineTime || console.len || (con_tx_pending(&console) && stdio_usb_connected()))
+        sources |= CG_CONSOLE;
+    lineTime = console.lineTime;
+    return sources;
+}
+
+/**
+ * \fn static void app_boot(void)
+ * \brief Initialize the watch UI and the time handler and start in the normal state
+ */
+static void app_boot(void){
+    watch_ui_init(&watchUI);
+    t4h_init(&timeHandler);
+    tb_init(&sunriseTB, 1000000, true);
+    appSunrise = false;
+    fsm_init(&appFsm, appStates, count_of(appStates), appTransitions, count_of(appTransitions));
+    fsm_start(&appFsm, WATCH_UI_STATE_NORMAL);
+}
+
+/**
+ * \fn static void app_restore(const wb_checkpoint_t *C, const datetime_t *rtcNow)
+ * \brief Restore the checkpoint of a warm boot after app_boot: time, alarm, snooze, display and state
+ * \param C         Checkpoint
+ * \param rtcNow    UTC time of the RTC if it kept running, NULL to take the time of the checkpoint
+ * \details A setting or the date shown are dropped like after an inactivity timeout, in the normal
+ * state. A ringing alarm rings again, a snooze keeps the time it had left.
+ */
+static void app_restore(const wb_checkpoint_t *C, const datetime_t *rtcNow){
+    datetime_t utc = rtcNow ? *rtcNow : C->date;
+    cal_from_epoch(tz_local(&tzZone, cal_to_epoch(&utc)), &timeHandler.date);
+    timeHandler.alarm = C->alarm;
+    timeHandler.type = C->alarmType;
+    timeHandler.skipHolidays = C->skipHolidays;
+    t4h_set_alarm_state(&timeHandler, C->alarmState);
+    t4h_set_post_period(&timeHandler, C->postPeriod);
+    appAlarmSound = C->sound;
+    ss_config_t *ss = &watchUI.ssDisplay;
+    for(uint8_t i = 0; i < WB_DIGITS && i < ss->numD; i++)
+        ss->array[i] = C->digits[i];
+    ss->enMask = C->enMask;
+    uint8_t state = C->state == WATCH_UI_STATE_ALARM || C->state == WATCH_UI_STATE_SNOOZE ? C->state : WATCH_UI_STATE_NORMAL;
+    fsm_start(&appFsm, state);
+    if(state == WATCH_UI_STATE_SNOOZE){
+        timeHandler.postTB.next = tb_now() + (uint64_t)C->snoozeLeftMs * 1000;
+        timeHandler.state = C->alarmState;
+    }
+}
+
+/**
+ * \fn static void app_checkpoint(void)
+ * \brief Save the essential state for a warm boot
+ */
+static void app_checkpoint(void){
+    wb_checkpoint_t *C = &wbBoot.cp;
+    if(!t4h_rtc_get(&C->date))
+        t4h_local_to_utc(&timeHandler.date, &C->date);
+    C->alarm = timeHandler.alarm;
+    C->alarmType = timeHandler.type;
+    C->skipHolidays = timeHandler.skipHolidays;
+    C->alarmState = timeHandler.state;
+    C->rtcAlarm = t4h_rtc_alarm_armed();
+    C->postPeriod = timeHandler.postPeriod;
+    uint64_t now = tb_now();
+    C->snoozeLeftMs = timeHandler.postTB.en && timeHandler.postTB.next > now ? (timeHandler.postTB.next - now) / 1000 : 0;
+    C->state = appFsm.state;
+    C->sound = appAlarmSound;
+    for(uint8_t i = 0; i < WB_DIGITS; i++)
+        C->digits[i] = watchUI.ssDisplay.array[i];
+    C->enMask = watchUI.ssDisplay.enMask;
+    wb_save(&wbBoot);
+}
+
+/**
+ * \fn static void app_show_time(void)
+ * \brief Show the hour and minute of the time handler on the display
+ */
+static void app_show_time(void){
+    uint8_t digits[4];
+    t4h_get_display_digits(&timeHandler, digits);
+    for(uint8_t i = 0; i < 4; i++)
+        ss_update_value(&watchUI.ssDisplay, i, digits[i]);
+}
+
+/**
+ * \fn static void app_sunrise(void)
+ * \brief Fade in the alarm LED during the APP_SUNRISE_S seconds before an enabled alarm
+ * \details The fade runs in the LED effect timer, the superloop only starts it. The LED is turned
+ * off when the alarm is disabled during the ramp or when the alarm is dismissed.
+ */
+static void app_sunrise(void){
+    if(!tb_check(&sunriseTB))
+        return;
+    tb_next(&sunriseTB);
+    alarm_state_t state = t4h_get_alarm_state(&timeHandler);
+    if(appSunrise && state == T4H_ALARM_OFF){  ///< Alarm disabled during the ramp
+        appSunrise = false;
+        sLED_off(&watchUI.ledAlarm);
+    }
+    if(appSunrise || state != T4H_ALARM_ON)
+        return;
+    datetime_t now;
+    t4h_read_local(&now);
+    int64_t t = cal_to_epoch(&now);
+    int64_t next = t4h_next_alarm(&timeHandler, t);
+    if(next > t && next - t <= APP_SUNRISE_S){
+        appSunrise = true;
+        sLED_fade(&watchUI.ledAlarm, SLED_LEVEL_MAX, (next - t) * 1000);
+    }
+}
+
+/**
+ * \fn static int app_parse_fields(const char *s, char sep, int *fields, int max)
+ * \brief Parse up to max decimal fields separated by sep, e.g. "12:30" or "15/06/2025"
+ * \returns Number of fields parsed, -1 if the text is malformed
+ */
+static int app_parse_fields(const char *s, char sep, int *fields, int max){
+    int n = 0;
+    while(n < max){
+        char *end;
+        long v = strtol(s, &end, 10);
+        if(end == s)
+            return -1;
+        fields[n++] = (int)v;
+        if(*end == '\0')
+            return n;
+        if(*end != sep)
+            return -1;
+        s = end + 1;
+    }
+    return -1;
+}
+
+/**
+ * \fn static void app_load_time(void)
+ * \brief Load the time handler date into the RTC and align the synchronization wall clock
+ */
+static void app_load_time(void){
+    datetime_t utc;
+    t4h_update_rtc_time(&timeHandler);
+    t4h_local_to_utc(&timeHandler.date, &utc);
+    ts_init(&timeSync, &utc);
+    app_rearm_alarm();
+}
+
+/**
+ * \fn static void app_rearm_alarm(void)
+ * \brief Program the next occurrence of an armed RTC alarm again, after a change of the time, the
+ * holidays or the zone
+ */
+static void app_rearm_alarm(void){
+    if(t4h_rtc_alarm_armed())
+        t4h_update_rtc_alarm(&timeHandler);
+}
+
+void cmd_time(console_t *C, int argc, char *argv[]){
+    t4h_read_local(&timeHandler.date);  ///< Start from the running date
+    if(argc >= 2){
+        int f[3] = {0, 0, 0};
+        int n = app_parse_fields(argv[1], ':', f, 3);
+        if(n < 2 || f[0] < 0 || f[0] > 23 || f[1] < 0 || f[1] > 59 || f[2] < 0 || f[2] > 59){
+            con_printf("ERR time\n");
+            return;
+        }
+        t4h_set_time_hour(&timeHandler, f[0], f[1]);
+        timeHandler.date.sec = f[2];
+        app_load_time();
+    }
+    con_printf("TIME %02d:%02d:%02d\n", timeHandler.date.hour, timeHandler.date.min, timeHandler.date.sec);
+}
+
+void cmd_date(console_t *C, int argc, char *argv[]){
+    t4h_read_local(&timeHandler.date);  ///< Start from the running time
+    if(argc >= 2){
+        int f[3];
+        datetime_t dt = timeHandler.date;
+        if(app_parse_fields(argv[1], '/', f, 3) != 3){
+            con_printf("ERR date\n");
+            return;
+        }
+        dt.day = f[0];
+        dt.month = f[1];
+        dt.year = f[2];
+        if(f[2] < 0 || f[2] > CAL_YEAR_MAX || !cal_is_valid(&dt)){
+            con_printf("ERR date\n");
+            return;
+        }
+        t4h_set_time_date(&timeHandler, f[0], f[1], f[2]);
+        t4h_set_time_dotw(&timeHandler, cal_dotw(f[2], f[1], f[0]));
+        app_load_time();
+    }
+    con_printf("DATE %02d/%02d/%04d %d\n", timeHandler.date.day, timeHandler.date.month, timeHandler.date.year, timeHandler.date.dotw);
+}
+
+void cmd_alarm(console_t *C, int argc, char *argv[]){
+    if(argc >= 2){
+        int f[3];
+        if(!strcmp(argv[1], "ON") || !strcmp(argv[1], "on")){
+            t4h_enable_alarm(&timeHandler);
+        }
+        else if(!strcmp(argv[1], "OFF") || !strcmp(argv[1], "off")){
+            t4h_disable_alarm(&timeHandler);
+        }
+        else if(app_parse_fields(argv[1], ':', f, 2) == 2 && f[0] >= 0 && f[0] <= 23 && f[1] >= 0 && f[1] <= 59){
+            char type = argc >= 3 ? argv[2][0] : 'D';
+            if(type == 'W' || type == 'w'){
+                int d = argc >= 4 ? atoi(argv[3]) : -1;
+                if(d < T4H_SUNDAY || d > T4H_SATURDAY){
+                    con_printf("ERR day of the week\n");
+                    return;
+                }
+                t4h_set_alarm_type(&timeHandler, T4H_WEEKLY_ALARM);
+                t4h_set_alarm_dotw(&timeHandler, d);
+            }
+            else if(type == 'T' || type == 't'){
+                int g[3];
+                datetime_t dt = {0, 0, 0, 0, f[0], f[1], 0};
+                if(argc < 4 || app_parse_fields(argv[3], '/', g, 3) != 3){
+                    con_printf("ERR date\n");
+                    return;
+                }
+                dt.day = g[0];
+                dt.month = g[1];
+                dt.year = g[2];
+                if(g[2] < 0 || g[2] > CAL_YEAR_MAX || !cal_is_valid(&dt)){
+                    con_printf("ERR date\n");
+                    return;
+                }
+                t4h_set_alarm_type(&timeHandler, T4H_DATE_ALARM);
+                t4h_set_alarm_date(&timeHandler, g[0], g[1], g[2]);
+            }
+            else{
+                t4h_set_alarm_type(&timeHandler, T4H_DAILY_ALARM);
+            }
+            t4h_set_alarm_hour(&timeHandler, f[0], f[1]);
+            t4h_update_rtc_alarm(&timeHandler);
+            t4h_enable_alarm(&timeHandler);
+        }
+        else{
+            con_printf("ERR alarm\n");
+            return;
+        }
     }
+    datetime_t *a = &timeHandler.alarm;
+    if(timeHandler.type == T4H_WEEKLY_ALARM)
+        con_printf("ALARM %02d:%02d W %d %s\n", a->hour, a->min, a->dotw, alarmStateName[timeHandler.state]);
+    else if(timeHandler.type == T4H_DATE_ALARM)
+        con_printf("ALARM %02d:%02d T %02d/%02d/%04d %s\n", a->hour, a->min, a->day, a->month, a->year, alarmStateName[timeHandler.state]);
+    else
+        con_printf("ALARM %02d:%02d D %s\n", a->hour, a->min, alarmStateName[timeHandler.state]);
+}
+
+void cmd_snooze(console_t *C, int argc, char *argv[]){
+    if(argc >= 2){
+        int p = atoi(argv[1]);
+        if(p < 1 || p > 30){
+            con_printf("ERR snooze period must be 1-30 min\n");
+            return;
+        }
+        t4h_set_post_period(&timeHandler, p);
+    }
+    con_printf("SNOOZE %d\n", timeHandler.postPeriod);
+}
+
+void cmd_drift(console_t *C, int argc, char *argv[]){
+    drift_apply_t mode = (argv[argc-1][0] == 'L') ? DRIFT_APPLY_LEAP : DRIFT_APPLY_DIVIDER;
+    switch (argc >= 2 ? argv[1][0] : 'R')
+    {
+    case 'P':
+        if(argc >= 3){
+            drift_add_pulse(&rtcDrift, strtoull(argv[2], NULL, 10), C->lineTime);
+            return;
+        }
+        break;
+    case 'R':
+        drift_print_report(&rtcDrift);
+        return;
+    case 'A':
+        con_printf(drift_apply(&rtcDrift, mode) ? "OK\n" : "ERR measurement not valid\n");
+        return;
+    case 'S':
+        if(argc >= 3){
+            con_printf(drift_set_correction(&rtcDrift, strtol(argv[2], NULL, 10), mode, true) ? "OK\n" : "ERR\n");
+            return;
+        }
+        break;
+    case 'C':
+        drift_clear(&rtcDrift);
+        con_printf("OK\n");
+        return;
+    default:
+        break;
+    }
+    con_printf("ERR drift\n");
+}
+
+void cmd_sync(console_t *C, int argc, char *argv[]){
+    if(argc >= 2 && argv[1][0] == 'R')
+        ts_print_report(&timeSync);
+    else
+        ts_start(&timeSync, argc >= 2 ? (uint8_t)strtoul(argv[1], NULL, 10) : TS_DEF_EXCHANGES);
 }
 
+void cmd_sync_reply(console_t *C, int argc, char *argv[]){
+    if(argc == 5)
+        ts_reply(&timeSync, (uint8_t)strtoul(argv[1], NULL, 10), strtoll(argv[2], NULL, 10),
+            strtoll(argv[3], NULL, 10), strtoll(argv[4], NULL, 10), C->lineTime);
+}
 
+void cmd_trace(console_t *C, int argc, char *argv[]){
+    if(argc >= 2){
+        if(!strcmp(argv[1], "ON") || !strcmp(argv[1], "on"))
+            trace_enable_drain(true);
+        else if(!strcmp(argv[1], "OFF") || !strcmp(argv[1], "off"))
+            trace_enable_drain(false);
+        else if(!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))
+            trace_init();
+    }
+    trace_print_status();
+}
 
-void StateNormal(void){
-    //t4h_refresh_time(&timeHandler);  ///< Refresh the time handler
-    if(t4h_refresh_time(&timeHandler)){  ///< Check if it's time to refresh the display
-        char hour[3];
-        char min[3];
+void cmd_prof(console_t *C, int argc, char *argv[]){
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))){
+        prof_clear();
+        con_printf("OK\n");
+        return;
+    }
+    prof_start_dump();
+}
 
-        uint8_t h = t4h_get_hour(&timeHandler);  ///< Get the current hour
-        uint8_t m = t4h_get_minute(&timeHandler);  ///< Get the current minute
+void cmd_out(console_t *C, int argc, char *argv[]){
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))){
+        out_clear();
+        con_printf("OK\n");
+        return;
+    }
+    for(uint8_t i = 0; i < OUT_CORES; i++){  ///< One line per core in WUCLOCK_DUAL_CORE builds
+        out_stage_t *S = &outStage[i];
+        uint32_t commits = S->commits ? S->commits : 1;
+        con_printf("OUT commits %lu posts %lu writes %lu per pass %lu.%02lu -> %lu.%02lu\n", (unsigned long)S->commits,
+            (unsigned long)S->posts, (unsigned long)S->writes,
+            (unsigned long)(S->posts / commits), (unsigned long)(S->posts * 100 / commits % 100),
+            (unsigned long)(S->writes / commits), (unsigned long)(S->writes * 100 / commits % 100));
+    }
+}
 
-        itoa(h, hour, 10);  ///< Convert hour to string
-        itoa(m, min, 10);  ///< Convert minute to string
+void cmd_sound(console_t *C, int argc, char *argv[]){
+    if(argc >= 2){
+        if(!strcmp(argv[1], "MELODY") || !strcmp(argv[1], "melody"))
+            appAlarmSound = APP_SOUND_MELODY;
+        else if(!strcmp(argv[1], "CHIME") || !strcmp(argv[1], "chime"))
+            appAlarmSound = APP_SOUND_CHIME;
+        else if(strcmp(argv[1], "STOP") && strcmp(argv[1], "stop")){
+            con_printf("ERR sound\n");
+            return;
+        }
+        app_alarm_sound(false);
+        if(argv[1][0] == 'C' || argv[1][0] == 'c')
+            aud_play(&aud, &audChime, false, false);  ///< Preview, once at full volume
+        else if(argv[1][0] == 'M' || argv[1][0] == 'm')
+            buzzer_beep(&watchUI.buzzer);
+    }
+    uint32_t decoded = aud.decoded ? aud.decoded : 1;
+    con_printf("SOUND %s playing %s decode %lu.%02lu cycles/sample\n", appAlarmSound == APP_SOUND_CHIME ? "CHIME" : "MELODY",
+        aud_is_playing(&aud) ? "CLIP" : pat_is_playing(&watchUI.buzzer.pat) ? "MELODY" : "NONE",
+        (unsigned long)(aud.decodeCycles / decoded), (unsigned long)(aud.decodeCycles * 100 / decoded % 100));
+}
 
-        ss_update_value(&watchUI.ssDisplay, 0, hour[0] - '0');  ///< Set the first digit of the display to the first character of the hour
-        ss_update_value(&watchUI.ssDisplay, 1, hour[1] - '0');  ///< Set the second digit of the display to the second character of the hour
-        ss_update_value(&watchUI.ssDisplay, 2, min[0] - '0');  ///< Set the third digit of the display to the first character of the minute
-        ss_update_value(&watchUI.ssDisplay, 3, min[1] - '0');  ///< Set the fourth digit of the display to the second character of the minute
+void cmd_core(console_t *C, int argc, char *argv[]){
+#ifdef WUCLOCK_DUAL_CORE
+    dc_link_t *L = &dcLink;
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))){
+        dc_clear(L);
+        con_printf("OK\n");
+        return;
+    }
+    uint32_t swaps = L->swaps ? L->swaps : 1;
+    con_printf("CORE published %lu swaps %lu dropped %lu tears %lu latency avg %lu max %lu us\n",
+        (unsigned long)L->published, (unsigned long)L->swaps, (unsigned long)L->dropped, (unsigned long)L->tears,
+        (unsigned long)(L->latSum / swaps), (unsigned long)L->latMax);
+#else
+    con_printf("ERR dual core not built, enable WUCLOCK_DUAL_CORE\n");
+#endif
+}
+
+void cmd_disp(console_t *C, int argc, char *argv[]){
+    ss_config_t *ss = &watchUI.ssDisplay;
+    if(ss->alarmNum == SS_NO_ALARM){
+        con_printf("DISP polled by ss_refresh at %u Hz\n", ss->refFreq);
+        return;
+    }
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))){
+        ss_isr_clear(ss);
+        con_printf("OK\n");
+        return;
     }
-    watch_ui_process(&watchUI, WATCH_UI_STATE_NORMAL, &events);  ///< Process the watch UI in normal state
+    ss_isr_t *I = &ss->isr;
+    uint32_t count = I->count ? I->count : 1;
+    con_printf("DISP isr alarm %u at %u Hz slots %lu late %lu cycles avg %lu max %lu over %lu budget %u\n", ss->alarmNum,
+        ss->refFreq, (unsigned long)I->count, (unsigned long)I->late, (unsigned long)(I->cyclesSum / count),
+        (unsigned long)I->cyclesMax, (unsigned long)I->over, SS_ISR_BUDGET);
+}
 
-    if(t4h_get_alarm_state(&timeHandler) == T4H_ALARM_READY){  ///< Check if the alarm is on
-       CurrentState = StateAlarm;  ///< Change state to alarm state
+void cmd_input(console_t *C, int argc, char *argv[]){
+    pb_gov_t *G = &watchUI.pbGov;
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "clr"))){
+        pb_gov_clear(G);
+        con_printf("OK\n");
+        return;
     }
+    con_printf("INPUT %s %lu Hz passes %lu samples slow %lu fast %lu to fast %lu\n", G->fast ? "FAST" : "SLOW",
+        (unsigned long)(1000000 / G->sampleTB.delta), (unsigned long)G->passes, (unsigned long)G->samples[0],
+        (unsigned long)G->samples[1], (unsigned long)G->toFast);
+}
 
-    if(events.all){
-        if(events.BITS.set_time == TWICE){  ///< Check if the set time button was pressed
-            CurrentState = StateSetTime;  ///< Change state to set time state
+void cmd_clk(console_t *C, int argc, char *argv[]){
+    cg_gov_t *G = &cgGov;
+    if(argc >= 2){
+        for(char *q = argv[1]; *q; q++)  ///< Level names in upper case
+            if(*q >= 'a' && *q <= 'z') *q -= 'a' - 'A';
+        if(!strcmp(argv[1], "CLR")){
+            cg_clear(G);
+            con_printf("OK\n");
+            return;
+        }
+        if(aud_is_playing(&aud)){  ///< A clip is timed from clk_sys
+            con_printf("ERR clip playing\n");
+            return;
         }
-        if(events.BITS.set_alarm == ONCE){  ///< Check if the set alarm button was pressed
-            t4h_enable_alarm(&timeHandler);  ///< Enable the alarm in the time handler
+        uint8_t level = CG_AUTO;
+        for(uint8_t l = 0; l < CG_NUM_LEVELS; l++)
+            if(!strcmp(argv[1], cgSettings[l].name))
+                level = l;
+        if(level == CG_AUTO && strcmp(argv[1], "AUTO")){
+            con_printf("ERR level\n");
+            return;
         }
-        else if(events.BITS.set_alarm == TWICE){  ///< Check if the set alarm button was pressed
-            CurrentState = StateSetAlarm;  ///< Change state to set alarm state
+        cg_force(G, level);
+    }
+    uint64_t total = time_us_64() - G->since;
+    for(uint8_t l = 0; l < CG_NUM_LEVELS; l++)
+        total += G->residency[l];
+    total = total ? total : 1;
+    uint32_t load = watch_ui_load_ua(&watchUI);
+    con_printf("CLK %s %s %lu MHz up %lu down %lu switch max %lu us boosts %lu/%lu/%lu\n",
+        G->forced == CG_AUTO ? "AUTO" : "FORCED", cgSettings[G->level].name, (unsigned long)(cgSettings[G->level].khz / 1000),
+        (unsigned long)G->ups, (unsigned long)G->downs, (unsigned long)G->switchMaxUs,
+        (unsigned long)G->boosts[0], (unsigned long)G->boosts[1], (unsigned long)G->boosts[2]);
+    for(uint8_t l = 0; l < CG_NUM_LEVELS; l++){
+        uint64_t t = G->residency[l] + (l == G->level ? time_us_64() - G->since : 0);
+        uint32_t mw = cg_estimate_mw(l, load);
+        con_printf("CLK %s %lu.%lu%% %lu.%lu mA %lu mW margin %ld mW\n", cgSettings[l].name,
+            (unsigned long)(t * 100 / total), (unsigned long)(t * 1000 / total % 10),
+            (unsigned long)(cg_estimate_ua(l, load) / 1000), (unsigned long)(cg_estimate_ua(l, load) / 100 % 10),
+            (unsigned long)mw, (long)CG_RNF04_MW - (long)mw);
+    }
+    con_printf("CLK load display and LEDs %lu.%lu mA\n", (unsigned long)(load / 1000), (unsigned long)(load / 100 % 10));
+}
+
+void cmd_boot(console_t *C, int argc, char *argv[]){
+    wb_boot_t *B = &wbBoot;
+    if(argc >= 2 && (!strcmp(argv[1], "REBOOT") || !strcmp(argv[1], "reboot"))){
+        app_checkpoint();
+        wb_reboot(B, 100);  ///< Time to send the answer
+        con_printf("OK\n");
+        return;
+    }
+    static const char *reasonName[] = {"POWER", "WATCHDOG", "RESET"};   ///< Names of wb_reason_t
+    con_printf("BOOT %s %s time from %s first frame %lu us\n", B->warm ? "WARM" : "COLD", reasonName[B->reason],
+        B->rtcKept ? "RTC" : B->warm ? "CHECKPOINT" : "DEFAULT", (unsigned long)B->frameUs);
+    con_printf("BOOT first frame cold %lu us warm %lu us, warm boots %lu checkpoints %lu\n", (unsigned long)B->cp.coldFrameUs,
+        (unsigned long)B->cp.warmFrameUs, (unsigned long)B->cp.warmBoots, (unsigned long)B->saves);
+}
+
+void cmd_light(console_t *C, int argc, char *argv[]){
+    al_sensor_t *A = &alSensor;
+    static al_sensor_t sim;  ///< Filter fed by LIGHT SIM, the sensor keeps running
+    if(argc >= 2 && (!strcmp(argv[1], "SIM") || !strcmp(argv[1], "sim"))){
+        if(argc < 3){  ///< A new light curve
+            sim.samples = 0;
+            sim.changes = 0;
+            sim.step = AL_STEPS - 1;
+            con_printf("OK\n");
+            return;
         }
-        if(events.BITS.snooze == TWICE){  ///< Check if the snooze button was pressed
-            CurrentState = StateSetSnooze;  ///< Change state to snooze state
+        al_update(&sim, atoi(argv[2]));
+        uint32_t display = watch_ui_display_ua(&watchUI, al_duty(&sim));  ///< With the digits shown now
+        uint32_t full = watch_ui_display_ua(&watchUI, SS_DUTY_MAX);
+        uint32_t load = watch_ui_load_ua(&watchUI) - watch_ui_display_ua(&watchUI, watchUI.ssDisplay.duty) + display;
+        con_printf("LIGHT SIM %u filt %lu step %u duty %u display %lu uA full %lu uA total %lu uA\n", sim.sample,
+            (unsigned long)(sim.filt >> 8), sim.step, al_duty(&sim), (unsigned long)display, (unsigned long)full,
+            (unsigned long)cg_estimate_ua(cgGov.level, load));
+        return;
+    }
+    if(argc >= 2){
+        if(!strcmp(argv[1], "AUTO") || !strcmp(argv[1], "auto")){
+            A->autoDuty = true;
+            ss_set_duty(&watchUI.ssDisplay, al_duty(A));
         }
-        if(events.BITS.show_date == TWICE){  ///< Check if the show date button was pressed
-            CurrentState = StateShowDate;  ///< Change state to show date state
+        else{
+            int duty = atoi(argv[1]);
+            if(duty < 1 || duty > SS_DUTY_MAX){
+                con_printf("ERR duty\n");
+                return;
+            }
+            A->autoDuty = false;
+            ss_set_duty(&watchUI.ssDisplay, duty);
         }
     }
+    con_printf("LIGHT %s adc %u filt %lu step %u duty %u display %lu uA changes %lu/%lu\n", A->autoDuty ? "AUTO" : "FIXED",
+        A->sample, (unsigned long)(A->filt >> 8), A->step, watchUI.ssDisplay.duty,
+        (unsigned long)watch_ui_display_ua(&watchUI, watchUI.ssDisplay.duty), (unsigned long)A->changes, (unsigned long)A->samples);
 }
 
-void StateAlarm(void){
-    ///< Refresh the time handler
-    if(t4h_refresh_time(&timeHandler)){  ///< Check if it's time to refresh the display
-        char hour[3];
-        char min[3];
+/**
+ * \fn static void app_energy_report(const char *tag, bool pins)
+ * \brief Print the mean power of every state and of all of them against RNF04, and the on time of the pins
+ */
+static void app_energy_report(const char *tag, bool pins){
+    en_meter_t *E = &enMeter;
+    uint64_t total = 0;
+    for(uint8_t s = 0; s < EN_STATES; s++)
+        total += E->timeUs[s];
+    for(uint8_t s = 0; s < count_of(appStates); s++){
+        if(!E->timeUs[s])
+            continue;
+        uint32_t part[EN_NUM_PARTS];
+        for(uint8_t p = 0; p < EN_NUM_PARTS; p++)
+            part[p] = en_mean_uw(E, s, p) / 100;
+        uint32_t mw = en_mean_uw(E, s, -1) / 100;   ///< Tenths of mW
+        con_printf("%s %s %lu s %lu.%lu mW seg %lu.%lu led %lu.%lu buz %lu.%lu cpu %lu.%lu\n", tag, appStates[s].name,
+            (unsigned long)(E->timeUs[s] / 1000000), (unsigned long)(mw / 10), (unsigned long)(mw % 10),
+            (unsigned long)(part[EN_SEGMENT] / 10), (unsigned long)(part[EN_SEGMENT] % 10), (unsigned long)(part[EN_LED] / 10),
+            (unsigned long)(part[EN_LED] % 10), (unsigned long)(part[EN_BUZZER] / 10), (unsigned long)(part[EN_BUZZER] % 10),
+            (unsigned long)(part[EN_CPU] / 10), (unsigned long)(part[EN_CPU] % 10));
+    }
+    uint32_t uw = en_mean_uw(E, EN_STATES, -1);
+    uint32_t peak = 0;
+    for(uint8_t s = 0; s < EN_STATES; s++)
+        if(en_mean_uw(E, s, -1) > peak)
+            peak = en_mean_uw(E, s, -1);
+    con_printf("%s ALL %lu s %lu.%lu mW, highest state %lu.%lu mW, RNF04 %u mW %s\n", tag, (unsigned long)(total / 1000000),
+        (unsigned long)(uw / 1000), (unsigned long)(uw / 100 % 10), (unsigned long)(peak / 1000), (unsigned long)(peak / 100 % 10),
+        CG_RNF04_MW, peak < CG_RNF04_MW * 1000 ? "PASS" : "FAIL");
+    if(!pins || !total)
+        return;
+    ss_config_t *ss = &watchUI.ssDisplay;   ///< Same pins as the display of core1
+    char line[CON_MSG_MAX];
+    int n = snprintf(line, sizeof(line), "%s SEG %%", tag);
+    for(uint8_t i = 0; i < 8; i++)
+        n += snprintf(line + n, sizeof(line) - n, " %c %lu", 'a' + i, (unsigned long)(E->pinUs[ss->segPosArray[i]] * 100 / total));
+    con_printf("%s\n", line);
+    n = snprintf(line, sizeof(line), "%s DIGIT %%", tag);
+    for(uint8_t i = 0; i < ss->numD; i++)
+        n += snprintf(line + n, sizeof(line) - n, " %u %lu", i, (unsigned long)(E->pinUs[ss->disPosArray[i]] * 100 / total));
+    con_printf("%s\n", line);
+    n = snprintf(line, sizeof(line), "%s OUT %%", tag);
+    for(uint8_t i = 0; i < E->numOut; i++)
+        n += snprintf(line + n, sizeof(line) - n, " %s%u %lu", E->outPart[i] == EN_LED ? "LED" : "BUZ", E->outPin[i],
+            (unsigned long)(E->pinUs[E->outPin[i]] * 100 / total));
+    con_printf("%s\n", line);
+}
 
-        uint8_t h = t4h_get_hour(&timeHandler);  ///< Get the current hour
-        uint8_t m = t4h_get_minute(&timeHandler);  ///< Get the current minute
+void cmd_energy(console_t *C, int argc, char *argv[]){
+    en_meter_t *E = &enMeter;
+    if(argc >= 2){
+        for(int a = 1; a < argc && a < 3; a++)  ///< Part names in upper case
+            for(char *q = argv[a]; *q; q++)
+                if(*q >= 'a' && *q <= 'z') *q -= 'a' - 'A';
+        if(!strcmp(argv[1], "CLR")){
+            en_clear(E);
+            con_printf("OK\n");
+            return;
+        }
+        if(strcmp(argv[1], "MODEL")){
+            con_printf("ERR energy\n");
+            return;
+        }
+        if(argc >= 4){
+            int ua = atoi(argv[3]);
+            uint8_t p = 0;
+            while(p < EN_NUM_PARTS && strcmp(argv[2], enPartNames[p]))
+                p++;
+            if(p == EN_NUM_PARTS || ua < 0){
+                con_printf("ERR part\n");
+                return;
+            }
+            E->model[p] = ua;
+        }
+        con_printf("ENERGY MODEL uA SEG %lu LED %lu BUZZER %lu MHZ %lu BOARD %lu\n", (unsigned long)E->model[EN_SEGMENT],
+            (unsigned long)E->model[EN_LED], (unsigned long)E->model[EN_BUZZER], (unsigned long)E->model[EN_CPU],
+            (unsigned long)E->model[EN_BOARD]);
+        return;
+    }
+    app_energy_report("ENERGY", true);
+}
 
-        itoa(h, hour, 10);  ///< Convert hour to string
-        itoa(m, min, 10);  ///< Convert minute to string
+/**
+ * \fn static bool app_parse_rule(const char *s, bool monday, hol_rule_t *r)
+ * \brief Parse a holiday rule: dd/mm a fixed date, mm:n:dotw the nth day of the week (-1 the
+ * last one), E+days or E-days from Easter Sunday; monday moves it to the next Monday
+ * \returns false if the text is malformed, the ranges are checked by hol_add
+ */
+static bool app_parse_rule(const char *s, bool monday, hol_rule_t *r){
+    int f[3];
+    if(s[0] == 'E' || s[0] == 'e'){
+        char *end;
+        long d = strtol(s + 1, &end, 10);
+        if(end == s + 1 || *end || d < -128 || d > 127)
+            return false;
+        *r = (hol_rule_t){HOL_EASTER, 0, (int8_t)d, 0};
+    }
+    else if(app_parse_fields(s, '/', f, 2) == 2 && f[0] >= 1 && f[0] <= 31 && f[1] >= 1 && f[1] <= 12)
+        *r = (hol_rule_t){HOL_FIXED, f[1], f[0], 0};
+    else if(app_parse_fields(s, ':', f, 3) == 3 && f[0] >= 1 && f[0] <= 12 && f[1] >= -1 && f[1] <= 5 && f[2] >= 0 && f[2] <= 6)
+        *r = (hol_rule_t){HOL_NTH, f[0], f[1], f[2]};
+    else
+        return false;
+    if(monday)
+        r->kind |= HOL_MONDAY;
+    return true;
+}
 
-        ss_update_value(&watchUI.ssDisplay, 0, hour[0] - '0');  ///< Set the first digit of the display to the first character of the hour
-        ss_update_value(&watchUI.ssDisplay, 1, hour[1] - '0');  ///< Set the second digit of the display to the second character of the hour
-        ss_update_value(&watchUI.ssDisplay, 2, min[0] - '0');  ///< Set the third digit of the display to the first character of the minute
-        ss_update_value(&watchUI.ssDisplay, 3, min[1] - '0');  ///< Set the fourth digit of the display to the second character of the minute
-    
-        CurrentState = StateNormal;
+void cmd_holiday(console_t *C, int argc, char *argv[]){
+    hol_calendar_t *H = &holCalendar;
+    for(int a = 1; a < argc; a++)  ///< Keywords in upper case, the rules accept both
+        for(char *q = argv[a]; *q; q++)
+            if(*q >= 'a' && *q <= 'z') *q -= 'a' - 'A';
+    if(argc >= 2 && !strcmp(argv[1], "SKIP")){
+        if(argc >= 3){
+            timeHandler.skipHolidays = !strcmp(argv[2], "ON");
+            app_rearm_alarm();
+        }
+        con_printf("HOLIDAY SKIP %s\n", timeHandler.skipHolidays ? "ON" : "OFF");
+        return;
+    }
+    if(argc >= 2 && !strcmp(argv[1], "LIST")){
+        for(uint8_t i = 0; i < H->set.num; i++){
+            hol_rule_t r = H->set.rule[i];
+            const char *m = r.kind & HOL_MONDAY ? " M" : "";
+            if((r.kind & ~HOL_MONDAY) == HOL_FIXED)
+                con_printf("HOLIDAY %u %02d/%02u%s\n", i, r.day, r.month, m);
+            else if((r.kind & ~HOL_MONDAY) == HOL_NTH)
+                con_printf("HOLIDAY %u %02u:%d:%u%s\n", i, r.month, r.day, r.dotw, m);
+            else
+                con_printf("HOLIDAY %u E%+d%s\n", i, r.day, m);
+            con_flush(C);  ///< Up to HOL_MAX_RULES lines, more than the TX queue
+        }
+        con_printf("OK\n");
+        return;
+    }
+    if(argc >= 2 && (!strcmp(argv[1], "CLR") || !strcmp(argv[1], "DEF"))){
+        hol_set_t empty = {0};
+        hol_load(H, argv[1][0] == 'C' ? &empty : &holDefault);
+        app_rearm_alarm();
+        con_printf("OK\n");
+        return;
+    }
+    if(argc >= 2 && !strcmp(argv[1], "SAVE")){
+        con_printf(aud_is_playing(&aud) ? "ERR clip playing\n" : hol_save(H) ? "OK\n" : "ERR flash\n");  ///< See fstore_write
+        return;
+    }
+    if(argc >= 2 && !strcmp(argv[1], "ADD")){
+        hol_rule_t r;
+        if(argc < 3 || !app_parse_rule(argv[2], argc >= 4 && !strcmp(argv[3], "M"), &r) || !hol_add(H, r)){
+            con_printf("ERR rule\n");
+            return;
+        }
+        app_rearm_alarm();
+        con_printf("OK\n");
+        return;
+    }
+    datetime_t now;
+    t4h_read_local(&now);
+    int year = argc >= 2 ? atoi(argv[1]) : now.year;
+    if(year < 1583 || year > CAL_YEAR_MAX){  ///< Gregorian Easter
+        con_printf("ERR holiday\n");
+        return;
     }
-    watch_ui_process(&watchUI, WATCH_UI_STATE_ALARM, &events);  ///< Process the watch UI in normal state
-    if(events.all){
-        
-        if(events.BITS.set_alarm){  ///< Check if the set alarm button was pressed
-            t4h_disable_alarm(&timeHandler);  ///< Enable the alarm in the time handler
-            CurrentState = StateNormal;  ///< Change state to normal state
+    uint16_t days = hol_count(H, year);
+    int64_t first = cal_days_from_civil(year, 1, 1);
+    if(argc >= 2){  ///< The dates of the year, 8 per line
+        char line[CON_MSG_MAX];
+        int n = 0;
+        for(int64_t d = first, i = 0; d < first + 365 + cal_is_leap(year); d++){
+            if(!hol_is_holiday(H, d))
+                continue;
+            datetime_t dt;
+            cal_from_epoch(d * CAL_SECS_PER_DAY, &dt);
+            if(!n)
+                n = snprintf(line, sizeof(line), "HOLIDAY %d", year);
+            n += snprintf(line + n, sizeof(line) - n, " %02d/%02d", dt.day, dt.month);
+            if(++i % 8 == 0){
+                con_printf("%s\n", line);
+                n = 0;
+            }
         }
-        if(events.BITS.snooze){  ///< Check if the snooze button was pressed
-            CurrentState = StateSnooze;  ///< Change state to snooze state
+        if(n)
+            con_printf("%s\n", line);
+    }
+    con_printf("HOLIDAY %d days %u rules %u compiled %lu last %lu us today %s skip %s\n", year, days, H->set.num,
+        (unsigned long)H->compiles, (unsigned long)H->compileUs,
+        hol_is_holiday(H, cal_days_from_civil(now.year, now.month, now.day)) ? "YES" : "NO",
+        timeHandler.skipHolidays ? "ON" : "OFF");
+}
+
+/**
+ * \fn static bool app_parse_change(char *s, tz_change_t *c)
+ * \brief Parse a DST change mm:n:dotw/hh:mm, the nth (-1 the last) day of the week of a month at a local time
+ * \returns false if the text is malformed, the ranges are checked by tz_set
+ */
+static bool app_parse_change(char *s, tz_change_t *c){
+    int d[3], t[2];
+    char *at = strchr(s, '/');
+    if(!at)
+        return false;
+    *at = '\0';
+    if(app_parse_fields(s, ':', d, 3) != 3 || app_parse_fields(at + 1, ':', t, 2) != 2 || d[0] < 1 || d[0] > 12
+       || d[1] < -1 || d[1] > 5 || d[2] < 0 || d[2] > 6 || t[0] < 0 || t[0] > 24 || t[1] < 0 || t[1] > 59)
+        return false;
+    *c = (tz_change_t){d[0], d[1], d[2], t[0] * 60 + t[1]};
+    return true;
+}
+
+void cmd_tz(console_t *C, int argc, char *argv[]){
+    tz_zone_t *Z = &tzZone;
+    if(argc >= 2 && (!strcmp(argv[1], "SAVE") || !strcmp(argv[1], "save"))){
+        con_printf(aud_is_playing(&aud) ? "ERR clip playing\n" : tz_save(Z) ? "OK\n" : "ERR flash\n");  ///< See fstore_write
+        return;
+    }
+    if(argc >= 2){
+        tz_rule_t rule = Z->rule;
+        rule.stdMin = atoi(argv[1]);
+        rule.dstMin = argc >= 3 ? atoi(argv[2]) : 0;
+        if((argc != 2 && argc != 5) || (argc == 5 && (!app_parse_change(argv[3], &rule.start) || !app_parse_change(argv[4], &rule.end)))
+           || !tz_set(Z, &rule)){
+            con_printf("ERR zone\n");
+            return;
         }
+        t4h_read_local(&timeHandler.date);  ///< The RTC keeps its UTC time, only the local time moves
+        app_rearm_alarm();
+    }
+    datetime_t utc, next;
+    t4h_rtc_get(&utc);
+    tz_local(Z, cal_to_epoch(&utc));  ///< Transitions around the current time
+    const tz_rule_t *R = &Z->rule;
+    char line[CON_MSG_MAX];
+    int n = snprintf(line, sizeof(line), "TZ %d DST %d", R->stdMin, R->dstMin);
+    if(R->dstMin)
+        n += snprintf(line + n, sizeof(line) - n, " %02u:%d:%u/%02u:%02u %02u:%d:%u/%02u:%02u", R->start.month, R->start.week,
+            R->start.dotw, R->start.minute / 60, R->start.minute % 60, R->end.month, R->end.week, R->end.dotw,
+            R->end.minute / 60, R->end.minute % 60);
+    n += snprintf(line + n, sizeof(line) - n, " now %ld", (long)(Z->offsetS / 60));
+    if(Z->nextUtc != INT64_MAX){
+        cal_from_epoch(Z->nextUtc, &next);
+        n += snprintf(line + n, sizeof(line) - n, " next %02d/%02d/%04d %02d:%02d UTC", next.day, next.month, next.year,
+            next.hour, next.min);
+    }
+    con_printf("%s\n", line);
+}
+
+#ifdef WUCLOCK_REPLAY
+static const char *appEventName[EV_NUM] = {   ///< Names of app_event_t
+    "SET_TIME_ONCE", "SET_TIME_TWICE", "SET_TIME_MORE", "SET_ALARM_ONCE", "SET_ALARM_TWICE", "SET_ALARM_MORE",
+    "PLUS_ONCE", "PLUS_TWICE", "PLUS_MORE", "MINUS_ONCE", "MINUS_TWICE", "MINUS_MORE",
+    "SNOOZE_ONCE", "SNOOZE_TWICE", "SNOOZE_MORE", "SHOW_DATE_ONCE", "SHOW_DATE_TWICE", "SHOW_DATE_MORE",
+    "TICK", "ALARM", "SOUND_END", "SNOOZE_END", "EDIT_IDLE"
+};
+
+static struct{
+    uint32_t frame[SS_MAXD];    ///< Segment codes of the last logged display frame
+    bool displayOn;             ///< Multiplexing enabled in the last logged frame
+    uint8_t outputs;            ///< LED and buzzer levels last logged
+    uint32_t tone;              ///< Buzzer frequency and volume last logged
+    alarm_state_t alarm;        ///< Alarm state last logged
+} appReplayLog;
+
+/**
+ * \fn static void app_replay_boot(void)
+ * \brief Boot hook of the replay, everything is logged again after a boot
+ */
+static void app_replay_boot(void){
+    app_boot();
+    t4h_sim_rtc(true);          ///< The RTC counts the virtual clock and starts with the time handler
+    t4h_update_rtc_time(&timeHandler);
+    memset(&appReplayLog, 0xFF, sizeof(appReplayLog));
+    appReplayLog.tone = 0;      ///< The buzzer boots silent
+    if(!replay.passes)
+        en_clear(&enMeter);     ///< The energy of a script starts at its first boot
+    else
+        en_skip(&enMeter);      ///< The board was off
+}
+
+/**
+ * \fn static void app_replay_pass(void)
+ * \brief One superloop pass of the replay, logs transitions, display frames and outputs that changed
+ */
+static void app_replay_pass(void){
+    uint8_t prevState = appFsm.state;
+    app_pass();
+#ifdef WUCLOCK_DUAL_CORE
+    dc_publish(&dcLink, &watchUI.ssDisplay);
+    dc_core1_pass(&dcLink);  ///< Core1 is not launched, its pass follows the pass of core0
+#endif
+    out_commit();
+#ifndef WUCLOCK_DUAL_CORE
+    en_outputs(&enMeter);
+#endif
+    en_frame(&enMeter, watch_ui_display_ua(&watchUI, watchUI.ssDisplay.duty));  ///< The replay does not multiplex
+    en_process(&enMeter, appFsm.state, cgSettings[cgGov.level].khz);
+    if(appFsm.state != prevState)
+        replay_log("STATE %s -> %s ON %s", appStates[prevState].name, appStates[appFsm.state].name, appEventName[appFsm.lastEvent]);
+
+    ss_config_t *ss = &watchUI.ssDisplay;
+    if(memcmp(appReplayLog.frame, ss->array, ss->numD * sizeof(uint32_t)) || appReplayLog.displayOn != ss->ssRefreshTB.en){
+        memcpy(appReplayLog.frame, ss->array, ss->numD * sizeof(uint32_t));
+        appReplayLog.displayOn = ss->ssRefreshTB.en;
+        replay_log("FRAME %05lx %05lx %05lx %05lx %s", (unsigned long)ss->array[3], (unsigned long)ss->array[2],
+            (unsigned long)ss->array[1], (unsigned long)ss->array[0], ss->ssRefreshTB.en ? "ON" : "OFF");
+    }
+
+    uint8_t outputs = gpio_get_out_level(watchUI.ledAlarm.numGPIO) | gpio_get_out_level(watchUI.ledHourUP.numGPIO) << 1 |
+        gpio_get_out_level(watchUI.ledHourDOWN.numGPIO) << 2 | gpio_get_out_level(watchUI.buzzer.numGPIO) << 3;
+    if(outputs != appReplayLog.outputs){
+        appReplayLog.outputs = outputs;
+        replay_log("OUT LED %u%u%u BUZZER %u", outputs & 1, (outputs >> 1) & 1, (outputs >> 2) & 1, (outputs >> 3) & 1);
+    }
+
+    uint32_t tone = (uint32_t)watchUI.buzzer.hz << 8 | watchUI.buzzer.volume;
+    if(tone != appReplayLog.tone){
+        appReplayLog.tone = tone;
+        replay_log("TONE %u Hz VOL %u", watchUI.buzzer.hz, watchUI.buzzer.volume);
     }
 
+    if(timeHandler.state != appReplayLog.alarm){
+        appReplayLog.alarm = timeHandler.state;
+        replay_log("ALARM %s", alarmStateName[timeHandler.state]);
+    }
+}
+#endif
+
+void cmd_replay(console_t *C, int argc, char *argv[]){
+#ifdef WUCLOCK_REPLAY
+    if(argc < 2){
+        for(uint8_t i = 0; i < replayNumScripts; i++)
+            con_printf("REPLAY %u %s\n", i, replayScripts[i].name);
+        return;
+    }
+    bool all = !strcmp(argv[1], "ALL") || !strcmp(argv[1], "all");
+    int n = atoi(argv[1]);
+    if(!all && (n < 0 || n >= replayNumScripts)){
+        con_printf("ERR script\n");
+        return;
+    }
+    con_flush(C);  ///< The replay log is printed directly, send what is queued first
+    int failed = 0;
+    for(int i = all ? 0 : n; i < (all ? replayNumScripts : n + 1); i++){
+        failed += !replay_run(&replayScripts[i], app_replay_boot, app_replay_pass);
+        app_energy_report(replayScripts[i].name, false);  ///< Energy per state of the script
+        con_flush(C);
+    }
+    t4h_sim_rtc(false);
+    app_boot();  ///< Back to real time, the application starts again
+    en_clear(&enMeter);
+    con_printf("REPLAY %s\n", failed ? "FAIL" : "OK");
+#else
+    con_printf("ERR replay not built, enable WUCLOCK_REPLAY\n");
+#endif
 }
 
-void StateSetTime(void){}
-void StateSetAlarm(void){}
-void StateSetSnooze(void){}
-void StateShowDate(void){}
-void StateSnooze(void){}
\ No newline at end of file
+void cmd_soak(console_t *C, int argc, char *argv[]){
+    int years = argc >= 2 ? atoi(argv[1]) : 100;
+    int from = argc >= 3 ? atoi(argv[2]) : 2000;
+    if(years < 1 || from < 0 || from > CAL_YEAR_MAX){
+        con_printf("ERR soak\n");
+        return;
+    }
+    con_flush(C);  ///< The soak report is printed directly, send what is queued first
+    t4h_soak_test(from, years);
+}
+
+static void bench_ss_idle(void){ tb_enable(&watchUI.ssDisplay.ssRefreshTB); watchUI.ssDisplay.ssRefreshTB.next = UINT64_MAX; }
+static void bench_ss_due(void){   ///< A digit to multiplex, or a frame to build for the refresh ISR
+    tb_enable(&watchUI.ssDisplay.ssRefreshTB);
+    watchUI.ssDisplay.ssRefreshTB.next = 0;
+    watchUI.ssDisplay.frame[watchUI.ssDisplay.live].show = ~0u;
+}
+static void bench_ss_refresh(void){ ss_refresh(&watchUI.ssDisplay); }
+static void bench_pb_wait(uint8_t waits){   ///< Thread parked, then waits ended by making them due
+    push_button_t *PB = &watchUI.pbSetTime;
+    co_init(&PB->co);
+    PB->BITS.eventCnt = 0;
+    PB->BITS.eventON = false;
+    PB->BITS.debON = false;
+    pb_poll_event(PB);
+    for(uint8_t i = 0; i < waits; i++){
+        PB->co.wake = 0;
+        pb_poll_event(PB);
+    }
+}
+static void bench_pb_idle(void){ bench_pb_wait(0); }
+static void bench_pb_debounce(void){ bench_pb_wait(1); watchUI.pbSetTime.co.wake = 0; }     ///< End of the press debounce
+static void bench_pb_window_end(void){ bench_pb_wait(3); watchUI.pbSetTime.co.wake = 0; }  ///< No second press
+static void bench_pb_poll(void){ pb_poll_event(&watchUI.pbSetTime); }
+static void bench_pattern_idle(void){   ///< Two LEDs blinking and the alarm sound, no change due
+    if(!pat_is_playing(&watchUI.buzzer.pat)){
+        sLED_start_blink(&watchUI.ledHourUP);
+        sLED_start_blink(&watchUI.ledHourDOWN);
+        buzzer_play(&watchUI.buzzer, watchAlarmRing);
+    }
+    patPlayer.next = UINT64_MAX;
+}
+static void bench_pattern_due(void){   ///< Every channel changes
+    bench_pattern_idle();
+    for(uint8_t i = 0; i < patPlayer.num; i++)
+        patPlayer.ch[i]->next = 0;
+    patPlayer.next = 0;
+}
+static void bench_pattern(void){ pat_process(&patPlayer); }
+static void bench_t4h_idle(void){ tb_enable(&timeHandler.refreshTB); timeHandler.refreshTB.next = UINT64_MAX; }
+static void bench_t4h_due(void){ tb_enable(&timeHandler.refreshTB); timeHandler.refreshTB.next = 0; }
+static void bench_t4h_refresh(void){ t4h_refresh_time(&timeHandler); }
+static void bench_state_normal(void){ appFsm.state = WATCH_UI_STATE_NORMAL; }
+static void bench_state_run(void){ app_pass(); }
+static void bench_out_pass(void){   ///< Posts of a pass with a display refresh and a blinking LED
+    out_put_masked(watchUI.ssDisplay.disMask, watchUI.ssDisplay.muxSeq[0]);
+    out_put_masked(watchUI.ssDisplay.segMask, watchUI.ssDisplay.array[0]);
+    out_xor_mask(1u << watchUI.ledHourUP.numGPIO);
+}
+static void bench_out_commit(void){ out_commit(); }
+static aud_decoder_t benchDec;
+static int16_t benchPcm[AUD_BLOCK];
+static aud_clip_t benchUlaw;
+static void bench_adpcm_start(void){ aud_decode_start(&benchDec, &audChime); }
+static void bench_ulaw_start(void){   ///< The chime bytes decoded as µ-law, any byte is a valid sample
+    benchUlaw = (aud_clip_t){audChime.data, audChime.samples / 2, audChime.rate, AUD_ULAW};
+    aud_decode_start(&benchDec, &benchUlaw);
+}
+static void bench_aud_block(void){ aud_decode(&benchDec, benchPcm, AUD_BLOCK); }   ///< Divide by AUD_BLOCK for cycles per sample
+
+const bench_case_t benchCases[] = {   ///< Driver hot paths, idle is the common not due path
+    {"ss_refresh_idle", bench_ss_idle, bench_ss_refresh},
+    {"ss_refresh_due", bench_ss_due, bench_ss_refresh},
+    {"pb_poll_idle", bench_pb_idle, bench_pb_poll},
+    {"pb_poll_debounce", bench_pb_debounce, bench_pb_poll},
+    {"pb_poll_window_end", bench_pb_window_end, bench_pb_poll},
+    {"pattern_idle", bench_pattern_idle, bench_pattern},
+    {"pattern_due", bench_pattern_due, bench_pattern},
+    {"t4h_refresh_idle", bench_t4h_idle, bench_t4h_refresh},
+    {"t4h_refresh_due", bench_t4h_due, bench_t4h_refresh},
+    {"state_normal", bench_state_normal, bench_state_run},
+    {"out_commit_pass", bench_out_pass, bench_out_commit},
+    {"aud_adpcm_block", bench_adpcm_start, bench_aud_block},
+    {"aud_ulaw_block", bench_ulaw_start, bench_aud_block},
+};
+
+void cmd_bench(console_t *C, int argc, char *argv[]){
+    int calls = argc >= 2 ? atoi(argv[1]) : 1000;
+    if(calls < 1){
+        con_printf("ERR calls\n");
+        return;
+    }
+    con_flush(C);  ///< The results are printed directly, send what is queued first
+    bench_suite(benchCases, count_of(benchCases), calls);
+    app_boot();  ///< The cases leave the drivers in arbitrary states, the application starts again
+}